@@ -0,0 +1,438 @@
+//  ▄▄▄▄▄▄▄▄    ▄▄▄▄      ▄▄▄▄
+//  ▀▀▀▀▀███  ▄██▀▀██▄   ██▀▀██
+//      ██▀   ██▄  ▄██  ██    ██
+//    ▄██▀     ██████   ██ ██ ██
+//   ▄██      ██▀  ▀██  ██    ██
+//  ███▄▄▄▄▄  ▀██▄▄██▀   ██▄▄██
+//  ▀▀▀▀▀▀▀▀    ▀▀▀▀      ▀▀▀▀   Batch.h
+// Version: 1.0.0
+//
+// This file contains the BatchCPU class, which steps many independent
+// Z80 instances together from a structure-of-arrays register file.
+//
+// Copyright (c) 2025-2026 Adam Szulc
+// MIT License
+
+#ifndef __Z80_BATCH_H__
+#define __Z80_BATCH_H__
+
+#include <Z80/CPU.h>
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#if defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+    #define Z80_RESTRICT __restrict
+#else
+    #define Z80_RESTRICT
+#endif
+
+namespace Z80 {
+
+// N lanes, each a full Z80 (registers, tick counter, bus mirrors) with its own paged bus, e.g. many test
+// cases or many copies of one program over CopyOnWriteBus images. The registers are held as one array per
+// register across all lanes. On every step the lanes whose next instruction is the same register-to-register
+// LD r,r' or 8-bit ALU opcode (ADD/ADC/SUB/SBC/AND/XOR/OR/CP A,r) run it as one branch-free loop over the
+// arrays, which the compiler turns into SSE/AVX2 code for the target; every other lane (other opcodes,
+// pending interrupts, HALT, small groups) is stepped by a scalar CPU loaded with that lane's state. Lanes
+// have no events and no debugger.
+template <typename TLaneBus = CopyOnWriteBus> class BatchCPU {
+    static_assert(is_paged_bus_v<TLaneBus>, "BatchCPU reads opcodes through the lane bus pages");
+
+    // Presents the bus of the lane being stepped to the scalar CPU
+    class LaneBus {
+    public:
+        static constexpr int PAGE_BITS = TLaneBus::PAGE_BITS;
+        template <typename TBus, typename TEvents, typename TDebugger, bool EnableNext, typename TConfig>
+        void connect(CPU<TBus, TEvents, TDebugger, EnableNext, TConfig>* cpu) {
+        }
+        void reset() {
+        }
+        void set_lane(TLaneBus* lane) {
+            m_lane = lane;
+        }
+        auto get_read_pages() const {
+            return m_lane->get_read_pages();
+        }
+        auto get_write_pages() const {
+            return m_lane->get_write_pages();
+        }
+        uint8_t read(uint16_t address) {
+            return m_lane->read(address);
+        }
+        void write(uint16_t address, uint8_t value) {
+            m_lane->write(address, value);
+        }
+        uint8_t in(uint16_t port) {
+            return m_lane->in(port);
+        }
+        void out(uint16_t port, uint8_t value) {
+            m_lane->out(port, value);
+        }
+
+    private:
+        TLaneBus* m_lane = nullptr;
+    };
+
+public:
+    using ScalarCPU = CPU<LaneBus>;
+    using State = ICPU::State;
+
+    // Every lane starts in the reset state with a default-constructed bus
+    explicit BatchCPU(size_t lanes) : m_buses(lanes), m_scalar(&m_lane_bus) {
+        for (auto& pair : m_pairs)
+            pair.resize(lanes);
+        for (auto* bytes : {&m_I, &m_R, &m_Q, &m_IRQ_data, &m_IRQ_mode, &m_index_mode, &m_control, &m_data_bus})
+            bytes->resize(lanes);
+        m_address_bus.resize(lanes);
+        m_ticks.resize(lanes);
+        m_opcode.resize(lanes);
+        m_code_page.resize(lanes);
+        m_code_page_index.resize(lanes, NO_PAGE);
+        m_lane_bus.set_lane(&m_buses[0]);
+        State state = m_scalar.save_state();
+        for (size_t lane = 0; lane < lanes; ++lane)
+            set_state(lane, state);
+    }
+    BatchCPU(const BatchCPU&) = delete;
+    BatchCPU& operator=(const BatchCPU&) = delete;
+
+    size_t get_lanes() const {
+        return m_buses.size();
+    }
+    TLaneBus& get_bus(size_t lane) {
+        forget_code_pages();
+        return m_buses[lane];
+    }
+    State get_state(size_t lane) const {
+        State state{};
+        state.m_AF.w = m_pairs[AF][lane];
+        state.m_BC.w = m_pairs[BC][lane];
+        state.m_DE.w = m_pairs[DE][lane];
+        state.m_HL.w = m_pairs[HL][lane];
+        state.m_IX.w = m_pairs[IX][lane];
+        state.m_IY.w = m_pairs[IY][lane];
+        state.m_SP.w = m_pairs[SP][lane];
+        state.m_PC.w = m_pairs[PC][lane];
+        state.m_AFp.w = m_pairs[AFp][lane];
+        state.m_BCp.w = m_pairs[BCp][lane];
+        state.m_DEp.w = m_pairs[DEp][lane];
+        state.m_HLp.w = m_pairs[HLp][lane];
+        state.m_WZ.w = m_pairs[WZ][lane];
+        state.m_I = m_I[lane];
+        state.m_R = m_R[lane];
+        state.m_Q = m_Q[lane];
+        uint8_t control = m_control[lane];
+        state.m_IFF1 = (control & IFF1) != 0;
+        state.m_IFF2 = (control & IFF2) != 0;
+        state.m_halted = (control & HALTED) != 0;
+        state.m_NMI_pending = (control & NMI_PENDING) != 0;
+        state.m_IRQ_request = (control & IRQ_REQUEST) != 0;
+        state.m_EI_executed = (control & EI_EXECUTED) != 0;
+        state.m_RETI_signaled = (control & RETI_SIGNALED) != 0;
+        state.m_flags_modified = (control & FLAGS_MODIFIED) != 0;
+        state.m_IRQ_data = m_IRQ_data[lane];
+        state.m_IRQ_mode = m_IRQ_mode[lane];
+        state.m_index_mode = (ICPU::IndexMode)m_index_mode[lane];
+        state.m_ticks = m_ticks[lane];
+        return state;
+    }
+    void set_state(size_t lane, const State& state) {
+        m_pairs[AF][lane] = state.m_AF.w;
+        m_pairs[BC][lane] = state.m_BC.w;
+        m_pairs[DE][lane] = state.m_DE.w;
+        m_pairs[HL][lane] = state.m_HL.w;
+        m_pairs[IX][lane] = state.m_IX.w;
+        m_pairs[IY][lane] = state.m_IY.w;
+        m_pairs[SP][lane] = state.m_SP.w;
+        m_pairs[PC][lane] = state.m_PC.w;
+        m_pairs[AFp][lane] = state.m_AFp.w;
+        m_pairs[BCp][lane] = state.m_BCp.w;
+        m_pairs[DEp][lane] = state.m_DEp.w;
+        m_pairs[HLp][lane] = state.m_HLp.w;
+        m_pairs[WZ][lane] = state.m_WZ.w;
+        m_I[lane] = state.m_I;
+        m_R[lane] = state.m_R;
+        m_Q[lane] = state.m_Q;
+        m_control[lane] = (state.m_IFF1 ? IFF1 : 0) | (state.m_IFF2 ? IFF2 : 0) | (state.m_halted ? HALTED : 0) |
+                          (state.m_NMI_pending ? NMI_PENDING : 0) | (state.m_IRQ_request ? IRQ_REQUEST : 0) |
+                          (state.m_EI_executed ? EI_EXECUTED : 0) | (state.m_RETI_signaled ? RETI_SIGNALED : 0) |
+                          (state.m_flags_modified ? FLAGS_MODIFIED : 0);
+        m_IRQ_data[lane] = state.m_IRQ_data;
+        m_IRQ_mode[lane] = state.m_IRQ_mode;
+        m_index_mode[lane] = (uint8_t)state.m_index_mode;
+        m_ticks[lane] = state.m_ticks;
+    }
+    uint16_t get_address_bus(size_t lane) const {
+        return m_address_bus[lane];
+    }
+    void set_address_bus(size_t lane, uint16_t value) {
+        m_address_bus[lane] = value;
+    }
+    uint8_t get_data_bus(size_t lane) const {
+        return m_data_bus[lane];
+    }
+    void set_data_bus(size_t lane, uint8_t value) {
+        m_data_bus[lane] = value;
+    }
+    long long get_ticks(size_t lane) const {
+        return m_ticks[lane];
+    }
+
+    // One instruction (or one HALT cycle, or one interrupt acceptance with its first instruction, as
+    // CPU::step() does) on every lane
+    void step() {
+        step_lanes(LLONG_MAX);
+    }
+    // Steps the lanes until each has reached `ticks_limit`
+    void run(long long ticks_limit) {
+        while (step_lanes(ticks_limit))
+            ;
+    }
+    // Instructions run by the vector loops and by the scalar CPU so far
+    long long get_vector_steps() const {
+        return m_vector_steps;
+    }
+    long long get_scalar_steps() const {
+        return m_scalar_steps;
+    }
+
+private:
+    enum Pair { AF, BC, DE, HL, IX, IY, SP, PC, AFp, BCp, DEp, HLp, WZ, PAIR_COUNT };
+    enum Control : uint8_t {
+        IFF1 = 0x01,
+        IFF2 = 0x02,
+        HALTED = 0x04,
+        NMI_PENDING = 0x08,
+        IRQ_REQUEST = 0x10,
+        EI_EXECUTED = 0x20,
+        RETI_SIGNALED = 0x40,
+        FLAGS_MODIFIED = 0x80
+    };
+    // m_opcode values besides the opcode itself
+    static constexpr uint16_t SCALAR = 0x100;
+    static constexpr uint16_t IDLE = 0x200;
+    static constexpr uint32_t NO_PAGE = UINT32_MAX;
+    // A vector loop pays for every lane, so an opcode gets one only when at least 1/MIN_GROUP_DIVISOR of
+    // the lanes (and two or more) share it
+    static constexpr size_t MIN_GROUP_DIVISOR = 32;
+
+    // Register codes of the LD r,r' and ALU A,r opcodes: B, C, D, E, H, L, (HL), A
+    static constexpr bool is_vector_opcode(int opcode) {
+        int source = opcode & 7, target = (opcode >> 3) & 7;
+        if (opcode >= 0x40 && opcode < 0x80)
+            return source != 6 && target != 6;
+        return opcode >= 0x80 && opcode < 0xC0 && source != 6;
+    }
+    static constexpr Pair pair_of(int reg) {
+        return reg == 7 ? AF : (Pair)(BC + reg / 2);
+    }
+    static constexpr bool is_high(int reg) {
+        return reg == 7 || (reg & 1) == 0;
+    }
+    // Z80 flags computed without the shared lookup tables, so the lane loops stay free of gathers
+    static uint8_t flags_SZXY(uint8_t result) {
+        return (result & 0xA8) | (result == 0 ? 0x40 : 0);
+    }
+    static uint8_t flags_SZP(uint8_t result) {
+        uint8_t parity = result ^ (result >> 4);
+        parity ^= parity >> 2;
+        parity ^= parity >> 1;
+        return flags_SZXY(result) | ((~parity & 1) << 2);
+    }
+
+    using LaneLoop = void (BatchCPU::*)();
+    template <size_t... Opcodes> static constexpr auto make_lane_loops(std::index_sequence<Opcodes...>) {
+        return std::array<LaneLoop, 256>{
+            {(is_vector_opcode(Opcodes) ? &BatchCPU::template execute_lanes<Opcodes> : nullptr)...}};
+    }
+    // Runs `TOpcode` on every lane whose m_opcode selects it; the others keep their values
+    template <size_t TOpcode> void execute_lanes() {
+        if constexpr (is_vector_opcode(TOpcode)) {
+            constexpr int source = TOpcode & 7, target = (TOpcode >> 3) & 7;
+            constexpr int source_shift = is_high(source) ? 8 : 0;
+            const size_t lanes = get_lanes();
+            const uint16_t* Z80_RESTRICT opcodes = m_opcode.data();
+            uint8_t* Z80_RESTRICT control = m_control.data();
+            uint8_t* Z80_RESTRICT q = m_Q.data();
+            if constexpr (TOpcode < 0x80) {
+                constexpr int target_shift = is_high(target) ? 8 : 0;
+                constexpr uint16_t keep = is_high(target) ? 0x00FF : 0xFF00;
+                const uint16_t* Z80_RESTRICT from = m_pairs[pair_of(source)].data();
+                uint16_t* Z80_RESTRICT to = m_pairs[pair_of(target)].data();
+                for (size_t i = 0; i < lanes; ++i) {
+                    bool selected = opcodes[i] == TOpcode;
+                    uint16_t value = (uint8_t)(from[i] >> source_shift);
+                    uint16_t written = (uint16_t)((to[i] & keep) | (value << target_shift));
+                    to[i] = selected ? written : to[i];
+                    control[i] = selected ? (uint8_t)(control[i] & ~FLAGS_MODIFIED) : control[i];
+                    q[i] = selected ? 0 : q[i];
+                }
+            } else {
+                const uint16_t* Z80_RESTRICT from = m_pairs[pair_of(source)].data();
+                uint16_t* Z80_RESTRICT af = m_pairs[AF].data();
+                for (size_t i = 0; i < lanes; ++i) {
+                    bool selected = opcodes[i] == TOpcode;
+                    uint8_t a = af[i] >> 8, carry = af[i] & 1;
+                    uint8_t value = (uint8_t)(from[i] >> source_shift);
+                    uint8_t result, flags;
+                    if constexpr (target == 0 || target == 1) { // ADD, ADC
+                        unsigned sum = a + value + (target == 1 ? carry : 0);
+                        result = (uint8_t)sum;
+                        flags = flags_SZXY(result) | ((a ^ value ^ result) & 0x10) |
+                                ((((a ^ value ^ 0x80) & (a ^ result)) & 0x80) >> 5) | (sum >> 8);
+                    } else if constexpr (target == 2 || target == 3 || target == 7) { // SUB, SBC, CP
+                        unsigned difference = a - value - (target == 3 ? carry : 0);
+                        result = (uint8_t)difference;
+                        uint8_t xy = target == 7 ? (uint8_t)((result & 0x80) | (result == 0 ? 0x40 : 0) | (value & 0x28))
+                                                 : flags_SZXY(result);
+                        flags = xy | 0x02 | ((a ^ value ^ result) & 0x10) | ((((a ^ value) & (a ^ result)) & 0x80) >> 5) |
+                                ((difference >> 8) & 1);
+                        if constexpr (target == 7)
+                            result = a;
+                    } else if constexpr (target == 4) { // AND
+                        result = a & value;
+                        flags = flags_SZP(result) | 0x10;
+                    } else { // XOR, OR
+                        result = target == 5 ? a ^ value : a | value;
+                        flags = flags_SZP(result);
+                    }
+                    af[i] = selected ? (uint16_t)(result << 8 | flags) : af[i];
+                    control[i] = selected ? (uint8_t)(control[i] | FLAGS_MODIFIED) : control[i];
+                    q[i] = selected ? flags : q[i];
+                }
+            }
+        }
+    }
+    // The opcode fetch (M1) of every lane that ran an instruction in a vector loop. Split in two so each loop
+    // stays within the aliasing checks the compiler is willing to emit.
+    void fetch_lanes() {
+        const size_t lanes = get_lanes();
+        const uint16_t* Z80_RESTRICT opcodes = m_opcode.data();
+        uint16_t* Z80_RESTRICT pc = m_pairs[PC].data();
+        uint16_t* Z80_RESTRICT address_bus = m_address_bus.data();
+        uint8_t* Z80_RESTRICT data_bus = m_data_bus.data();
+        for (size_t i = 0; i < lanes; ++i) {
+            bool selected = opcodes[i] < SCALAR;
+            address_bus[i] = selected ? pc[i] : address_bus[i];
+            data_bus[i] = selected ? (uint8_t)opcodes[i] : data_bus[i];
+            pc[i] = selected ? (uint16_t)(pc[i] + 1) : pc[i];
+        }
+        uint8_t* Z80_RESTRICT r = m_R.data();
+        uint8_t* Z80_RESTRICT index_mode = m_index_mode.data();
+        long long* Z80_RESTRICT ticks = m_ticks.data();
+        for (size_t i = 0; i < lanes; ++i) {
+            bool selected = opcodes[i] < SCALAR;
+            r[i] = selected ? (uint8_t)((r[i] & 0x80) | ((r[i] + 1) & 0x7F)) : r[i];
+            index_mode[i] = selected ? (uint8_t)ICPU::IndexMode::HL : index_mode[i];
+            ticks[i] += selected ? 4 : 0;
+        }
+    }
+    void step_scalar(size_t lane) {
+        m_lane_bus.set_lane(&m_buses[lane]);
+        m_scalar.restore_state(get_state(lane));
+        m_scalar.set_address_bus(m_address_bus[lane]);
+        m_scalar.set_data_bus(m_data_bus[lane]);
+        m_scalar.step();
+        set_state(lane, m_scalar.save_state());
+        m_address_bus[lane] = m_scalar.get_address_bus();
+        m_data_bus[lane] = m_scalar.get_data_bus();
+        m_code_page_index[lane] = NO_PAGE;
+    }
+    // Steps every lane below `ticks_limit` once; false when there was none
+    bool step_lanes(long long ticks_limit) {
+        static constexpr auto s_lane_loops = make_lane_loops(std::make_index_sequence<256>{});
+        const size_t lanes = get_lanes();
+        size_t active = 0, groups = 0;
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            uint16_t opcode = IDLE;
+            if (m_ticks[lane] < ticks_limit) {
+                ++active;
+                opcode = SCALAR;
+                uint8_t control = m_control[lane];
+                bool pending = (control & (HALTED | NMI_PENDING | EI_EXECUTED)) != 0 ||
+                               (control & (IRQ_REQUEST | IFF1)) == (IRQ_REQUEST | IFF1);
+                const uint8_t* page = get_code_page(lane);
+                if (!pending && page != nullptr) {
+                    uint8_t byte = page[m_pairs[PC][lane] & ((1 << TLaneBus::PAGE_BITS) - 1)];
+                    if (s_lane_loops[byte]) {
+                        opcode = byte;
+                        if (m_counts[byte]++ == 0)
+                            m_groups[groups++] = byte;
+                    }
+                }
+            }
+            m_opcode[lane] = opcode;
+        }
+        if (active == 0)
+            return false;
+        size_t vector_lanes = 0, demoted = 0;
+        for (size_t group = 0; group < groups; ++group) {
+            uint32_t& count = m_counts[m_groups[group]];
+            if (count < 2 || count * MIN_GROUP_DIVISOR < lanes) {
+                count = 0;
+                ++demoted;
+            } else
+                vector_lanes += count;
+        }
+        if (demoted != 0)
+            for (size_t lane = 0; lane < lanes; ++lane)
+                if (m_opcode[lane] < SCALAR && m_counts[m_opcode[lane]] == 0)
+                    m_opcode[lane] = SCALAR;
+        if (vector_lanes != 0) {
+            fetch_lanes();
+            for (size_t group = 0; group < groups; ++group) {
+                uint8_t opcode = m_groups[group];
+                if (m_counts[opcode] != 0)
+                    (this->*s_lane_loops[opcode])();
+                m_counts[opcode] = 0;
+            }
+        }
+        if (vector_lanes != active)
+            for (size_t lane = 0; lane < lanes; ++lane)
+                if (m_opcode[lane] == SCALAR)
+                    step_scalar(lane);
+        m_vector_steps += vector_lanes;
+        m_scalar_steps += active - vector_lanes;
+        return true;
+    }
+    // The page holding the lane's PC. Vector loops never write memory, so the pointer is kept until the lane
+    // leaves the page, takes a scalar step, or the host gets the bus between step()/run() calls.
+    const uint8_t* get_code_page(size_t lane) {
+        uint32_t page = m_pairs[PC][lane] >> TLaneBus::PAGE_BITS;
+        if (m_code_page_index[lane] != page) {
+            m_code_page_index[lane] = page;
+            m_code_page[lane] = m_buses[lane].get_read_pages()[page];
+        }
+        return m_code_page[lane];
+    }
+    void forget_code_pages() {
+        std::fill(m_code_page_index.begin(), m_code_page_index.end(), NO_PAGE);
+    }
+
+    std::vector<TLaneBus> m_buses;
+    std::vector<uint16_t> m_pairs[PAIR_COUNT];
+    std::vector<uint8_t> m_I, m_R, m_Q, m_IRQ_data, m_IRQ_mode, m_index_mode;
+    std::vector<uint8_t> m_control; // Control bits
+    std::vector<uint16_t> m_address_bus;
+    std::vector<uint8_t> m_data_bus;
+    std::vector<long long> m_ticks;
+    std::vector<uint16_t> m_opcode; // Opcode of the lane's vector step, SCALAR or IDLE
+    std::vector<const uint8_t*> m_code_page;
+    std::vector<uint32_t> m_code_page_index;
+    std::array<uint32_t, 256> m_counts{}; // Lanes per vector opcode, zero between steps
+    std::array<uint8_t, 256> m_groups{};  // Vector opcodes seen in this step
+    LaneBus m_lane_bus;
+    ScalarCPU m_scalar;
+    long long m_vector_steps = 0;
+    long long m_scalar_steps = 0;
+};
+
+} // namespace Z80
+
+#endif //__Z80_BATCH_H__
@@ -17,9 +17,14 @@
 #define __Z80_CPU_H__
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <climits>
 #include <cstdint>
+#include <cstring>
+#include <memory>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #if defined(__GNUC__) || defined(__clang__) // GCC i Clang
@@ -30,12 +35,98 @@
     #define Z80_LIKELY(expr) (expr)
 #endif
 
+#if defined(Z80_TABLE_DISPATCH) && (defined(__GNUC__) || defined(__clang__))
+    #define Z80_THREADED_DISPATCH
+    #define Z80_THREADED_ROW(M, h) M(h##0) M(h##1) M(h##2) M(h##3) M(h##4) M(h##5) M(h##6) M(h##7) \
+                                   M(h##8) M(h##9) M(h##A) M(h##B) M(h##C) M(h##D) M(h##E) M(h##F)
+    #define Z80_THREADED_OPCODES(M) Z80_THREADED_ROW(M, 0) Z80_THREADED_ROW(M, 1) Z80_THREADED_ROW(M, 2) \
+                                    Z80_THREADED_ROW(M, 3) Z80_THREADED_ROW(M, 4) Z80_THREADED_ROW(M, 5) \
+                                    Z80_THREADED_ROW(M, 6) Z80_THREADED_ROW(M, 7) Z80_THREADED_ROW(M, 8) \
+                                    Z80_THREADED_ROW(M, 9) Z80_THREADED_ROW(M, A) Z80_THREADED_ROW(M, B) \
+                                    Z80_THREADED_ROW(M, C) Z80_THREADED_ROW(M, D) Z80_THREADED_ROW(M, E) \
+                                    Z80_THREADED_ROW(M, F)
+#endif
+
 namespace Z80 {
 
 class StandardBus;
+class PagedBus;
 class StandardEvents;
 class StandardDebugger;
 
+// A TBus that publishes per-page host pointers (PAGE_BITS, get_read_pages(), get_write_pages()) lets
+// the CPU access mapped pages directly; a null page pointer falls back to the bus read()/write().
+template <typename T, typename = void> struct is_paged_bus : std::false_type {};
+template <typename T>
+struct is_paged_bus<T, std::void_t<decltype(T::PAGE_BITS), decltype(std::declval<T&>().get_read_pages()),
+                                   decltype(std::declval<T&>().get_write_pages())>> : std::true_type {};
+template <typename T> inline constexpr bool is_paged_bus_v = is_paged_bus<T>::value;
+
+// A TBus with in_block(port, dst, n) / out_block(port, src, n) takes runs of INIR/INDR/OTIR/OTDR transfers
+// in one call. Transfer i goes to port - (i << 8) (B counts down); the call returns how many it made.
+template <typename T, typename = void> struct has_in_block : std::false_type {};
+template <typename T>
+struct has_in_block<T, std::void_t<decltype(std::declval<T&>().in_block(uint16_t{}, std::declval<uint8_t*>(), size_t{}))>>
+    : std::true_type {};
+template <typename T> inline constexpr bool has_in_block_v = has_in_block<T>::value;
+template <typename T, typename = void> struct has_out_block : std::false_type {};
+template <typename T>
+struct has_out_block<T, std::void_t<decltype(std::declval<T&>().out_block(uint16_t{}, std::declval<const uint8_t*>(), size_t{}))>>
+    : std::true_type {};
+template <typename T> inline constexpr bool has_out_block_v = has_out_block<T>::value;
+
+// Flags register builder. With TrackXY off, set/clear/update leave the undocumented X/Y bits alone, so
+// their computation compiles away.
+template <bool TrackXY = true> class BasicFlags {
+public:
+    static constexpr uint8_t C = 1 << 0;
+    static constexpr uint8_t N = 1 << 1;
+    static constexpr uint8_t PV = 1 << 2;
+    static constexpr uint8_t X = 1 << 3;
+    static constexpr uint8_t H = 1 << 4;
+    static constexpr uint8_t Y = 1 << 5;
+    static constexpr uint8_t Z = 1 << 6;
+    static constexpr uint8_t S = 1 << 7;
+    BasicFlags(uint8_t value) : m_value(value) {
+    }
+    template <bool OtherTrackXY> BasicFlags(BasicFlags<OtherTrackXY> other) : m_value(other) {
+    }
+    operator uint8_t() const {
+        return m_value;
+    }
+    BasicFlags& operator=(uint8_t new_value) {
+        return assign(new_value);
+    }
+    BasicFlags& zero() {
+        m_value = 0;
+        return *this;
+    }
+    BasicFlags& assign(uint8_t value) {
+        m_value = value;
+        return *this;
+    }
+    BasicFlags& set(uint8_t mask) {
+        m_value |= mask & TRACKED;
+        return *this;
+    }
+    BasicFlags& clear(uint8_t mask) {
+        m_value &= ~(mask & TRACKED);
+        return *this;
+    }
+    BasicFlags& update(uint8_t mask, bool state) {
+        mask &= TRACKED;
+        m_value = (m_value & ~mask) | (-(int8_t)state & mask);
+        return *this;
+    }
+    bool is_set(uint8_t mask) const {
+        return (m_value & mask) != 0;
+    }
+
+private:
+    static constexpr uint8_t TRACKED = TrackXY ? 0xFF : (uint8_t)~(X | Y);
+    uint8_t m_value;
+};
+
 class ICPU {
 public:
     virtual ~ICPU() = default;
@@ -52,7 +143,9 @@ public:
         };
     };
     enum class IndexMode { HL, IX, IY };
-    struct State {
+    // Register and control state. CPU keeps its own registers in this exact block, so a snapshot or a
+    // restore is one plain copy of a single cache line.
+    struct alignas(64) State {
         Register m_AF, m_BC, m_DE, m_HL;
         Register m_IX, m_IY, m_SP, m_PC;
         Register m_AFp, m_BCp, m_DEp, m_HLp;
@@ -71,51 +164,7 @@ public:
         long long m_ticks;
     };
     // Flags
-    class Flags {
-    public:
-        static constexpr uint8_t C = 1 << 0;
-        static constexpr uint8_t N = 1 << 1;
-        static constexpr uint8_t PV = 1 << 2;
-        static constexpr uint8_t X = 1 << 3;
-        static constexpr uint8_t H = 1 << 4;
-        static constexpr uint8_t Y = 1 << 5;
-        static constexpr uint8_t Z = 1 << 6;
-        static constexpr uint8_t S = 1 << 7;
-        Flags(uint8_t value) : m_value(value) {
-        }
-        operator uint8_t() const {
-            return m_value;
-        }
-        Flags& operator=(uint8_t new_value) {
-            return assign(new_value);
-        }
-        Flags& zero() {
-            m_value = 0;
-            return *this;
-        }
-        Flags& assign(uint8_t value) {
-            m_value = value;
-            return *this;
-        }
-        Flags& set(uint8_t mask) {
-            m_value |= mask;
-            return *this;
-        }
-        Flags& clear(uint8_t mask) {
-            m_value &= ~mask;
-            return *this;
-        }
-        Flags& update(uint8_t mask, bool state) {
-            m_value = (m_value & ~mask) | (-(int8_t)state & mask);
-            return *this;
-        }
-        bool is_set(uint8_t mask) const {
-            return (m_value & mask) != 0;
-        }
-
-    private:
-        uint8_t m_value;
-    };
+    using Flags = BasicFlags<>;
     virtual long long run(long long ticks_limit) = 0;
     virtual int step() = 0;
     virtual void reset() = 0;
@@ -226,12 +275,90 @@ public:
     virtual void set_data_bus(uint8_t value) = 0;
 };
 
-template <typename TBus = StandardBus, typename TEvents = StandardEvents, typename TDebugger = StandardDebugger, bool EnableNext = false>
-class CPU : public ICPU {
+// Flag lookup tables shared by every CPU instance. Entries hold the flags that follow from an 8-bit
+// result alone; the ALU helpers OR in the operand-dependent H, PV (overflow) and C bits.
+struct FlagTables {
+    uint8_t SZ[256];    // S, Z
+    uint8_t SZXY[256];  // S, Z and the undocumented Y, X copied from the value
+    uint8_t SZP[256];   // S, Z, Y, X and PV as even parity
+    uint8_t INC[256];   // all flags but C after INC r, indexed by the result
+    uint8_t DEC[256];   // all flags but C after DEC r, indexed by the result
+    uint16_t DAA[2048]; // A << 8 | F after DAA, indexed by A | C << 8 | N << 9 | H << 10
+};
+constexpr FlagTables make_flag_tables() {
+    using Flags = ICPU::Flags;
+    FlagTables tables{};
+    for (int i = 0; i < 256; ++i) {
+        uint8_t value = (uint8_t)i;
+        uint8_t sz = (value & Flags::S) | (value == 0 ? Flags::Z : 0);
+        bool parity = true;
+        for (int bit = 0; bit < 8; ++bit)
+            parity ^= ((value >> bit) & 1) != 0;
+        tables.SZ[i] = sz;
+        tables.SZXY[i] = sz | (value & (Flags::X | Flags::Y));
+        tables.SZP[i] = tables.SZXY[i] | (parity ? Flags::PV : 0);
+        tables.INC[i] = tables.SZXY[i] | ((value & 0x0F) == 0x00 ? Flags::H : 0) | (value == 0x80 ? Flags::PV : 0);
+        tables.DEC[i] = tables.SZXY[i] | Flags::N | ((value & 0x0F) == 0x0F ? Flags::H : 0) |
+                        (value == 0x7F ? Flags::PV : 0);
+    }
+    for (int i = 0; i < 2048; ++i) {
+        uint8_t a = (uint8_t)i;
+        bool carry = (i & 0x100) != 0, subtract = (i & 0x200) != 0, half = (i & 0x400) != 0;
+        uint8_t correction = (carry || a > 0x99) ? 0x60 : 0x00;
+        if (half || (a & 0x0F) > 0x09)
+            correction |= 0x06;
+        uint8_t result = subtract ? (uint8_t)(a - correction) : (uint8_t)(a + correction);
+        bool half_out = subtract ? (half && (a & 0x0F) < 0x06) : (a & 0x0F) > 0x09;
+        uint8_t flags = tables.SZP[result] | (subtract ? Flags::N : 0) | (half_out ? Flags::H : 0) |
+                        (correction >= 0x60 ? Flags::C : 0);
+        tables.DAA[i] = (uint16_t)(result << 8 | flags);
+    }
+    return tables;
+}
+inline constexpr FlagTables FLAG_TABLES = make_flag_tables();
+
+// Compile-time options of the CPU core, passed as the fifth CPU template parameter. Derive from
+// StandardConfig and redefine a member to change it.
+struct StandardConfig {
+    // Record the last 8-bit ALU operation and build F from it only when F (or Q) is read
+    static constexpr bool LAZY_FLAGS = false;
+    // Accuracy profile: undocumented or bus-level state that ordinary software never observes. Each one can
+    // be dropped on its own; the default tracks all of them.
+    static constexpr bool TRACK_WZ = true;  // WZ (MEMPTR), visible only through BIT n,(HL) X/Y
+    static constexpr bool TRACK_Q = true;   // Q, the flags left by the last instruction (SCF/CCF X/Y)
+    static constexpr bool TRACK_XY = true;  // X/Y flag bits outside the shared ALU flag tables
+    static constexpr bool TRACK_R = true;   // R increments on opcode fetches
+    static constexpr bool TRACK_BUS = true; // Address and data bus mirrors (get_address_bus/get_data_bus)
+    // Lock-free mailbox for post_interrupt(), post_NMI() and request_stop() from other threads, drained at
+    // instruction boundaries. Off: the calls do not compile and the boundary check is removed.
+    static constexpr bool THREAD_MAILBOX = false;
+};
+struct LazyFlagsConfig : StandardConfig {
+    static constexpr bool LAZY_FLAGS = true;
+};
+struct MailboxConfig : StandardConfig {
+    static constexpr bool THREAD_MAILBOX = true;
+};
+// Functional profile for software that only depends on documented behaviour (CP/M tools, compilers):
+// WZ, Q, R and the bus mirrors stay at their last written value and X/Y are left unspecified.
+struct FunctionalConfig : StandardConfig {
+    static constexpr bool TRACK_WZ = false;
+    static constexpr bool TRACK_Q = false;
+    static constexpr bool TRACK_XY = false;
+    static constexpr bool TRACK_R = false;
+    static constexpr bool TRACK_BUS = false;
+};
+
+template <typename TBus = StandardBus, typename TEvents = StandardEvents, typename TDebugger = StandardDebugger,
+          bool EnableNext = false, typename TConfig = StandardConfig>
+class CPU : public ICPU, private ICPU::State {
 public:
+    using State = ICPU::State;
+    using Flags = BasicFlags<TConfig::TRACK_XY>;
+
     // Constructors, destructors and assignment operators
     CPU(TBus* bus = nullptr, TEvents* events = nullptr, TDebugger* debugger = nullptr)
-        : m_owns_bus(false), m_owns_events(false), m_owns_debugger(false), m_bus(bus), m_events(events),
+        : State(), m_owns_bus(false), m_owns_events(false), m_owns_debugger(false), m_bus(bus), m_events(events),
           m_debugger(debugger) {
 
         if (!m_bus) {
@@ -241,18 +368,21 @@ public:
             }
         }
         if (!m_events) {
-            if constexpr (std::is_default_constructible_v<TEvents>) {
+            if constexpr (std::is_same_v<TEvents, StandardEvents>)
+                m_events = get_shared_instance<StandardEvents>();
+            else if constexpr (std::is_default_constructible_v<TEvents>) {
                 m_events = new TEvents();
                 m_owns_events = true;
             }
         }
         if (!m_debugger) {
-            if constexpr (std::is_default_constructible_v<TDebugger>) {
+            if constexpr (std::is_same_v<TDebugger, StandardDebugger>)
+                m_debugger = get_shared_instance<StandardDebugger>();
+            else if constexpr (std::is_default_constructible_v<TDebugger>) {
                 m_debugger = new TDebugger();
                 m_owns_debugger = true;
             }
         }
-        precompute_parity();
         m_bus->connect(this);
         m_events->connect(this);
         m_debugger->connect(this);
@@ -267,7 +397,7 @@ public:
             delete m_debugger;
     }
     CPU(const CPU& other)
-        : m_bus(nullptr), m_events(nullptr), m_debugger(nullptr), m_owns_bus(false), m_owns_events(false),
+        : State(), m_bus(nullptr), m_events(nullptr), m_debugger(nullptr), m_owns_bus(false), m_owns_events(false),
           m_owns_debugger(false) {
         restore_state(other.save_state());
         if (other.m_owns_bus) {
@@ -294,7 +424,6 @@ public:
                 m_debugger = nullptr;
         } else
             m_debugger = other.m_debugger;
-        precompute_parity();
         if (m_bus)
             m_bus->connect(this);
         if (m_events)
@@ -347,6 +476,7 @@ public:
         m_bus->reset();
         m_events->reset();
         m_debugger->reset();
+        update_event_horizon();
     }
     void request_interrupt(uint8_t data) override {
         set_IRQ_request(true);
@@ -355,69 +485,44 @@ public:
     void request_NMI() override {
         set_NMI_pending(true);
     }
+    // Thread-safe counterparts of request_interrupt()/request_NMI() for device threads (TConfig::THREAD_MAILBOX).
+    // The request is taken over at the next instruction boundary of run() or step(); a later IRQ posted before
+    // then replaces the data byte.
+    void post_interrupt(uint8_t data) {
+        static_assert(TConfig::THREAD_MAILBOX, "post_interrupt() requires TConfig::THREAD_MAILBOX");
+        uint32_t mail = m_mailbox.load(std::memory_order_relaxed);
+        while (!m_mailbox.compare_exchange_weak(mail, (mail & ~MAILBOX_DATA) | MAILBOX_IRQ | data,
+                                                std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+    void post_NMI() {
+        static_assert(TConfig::THREAD_MAILBOX, "post_NMI() requires TConfig::THREAD_MAILBOX");
+        m_mailbox.fetch_or(MAILBOX_NMI, std::memory_order_release);
+    }
+    // Makes the run() in progress, or the next one, return at an instruction boundary. step() leaves it pending.
+    void request_stop() {
+        static_assert(TConfig::THREAD_MAILBOX, "request_stop() requires TConfig::THREAD_MAILBOX");
+        m_mailbox.fetch_or(MAILBOX_STOP, std::memory_order_release);
+    }
 
     // High-Level State Management Methods ---
     State save_state() const override {
-        State state;
-        state.m_AF.w = get_AF();
-        state.m_BC.w = get_BC();
-        state.m_DE.w = get_DE();
-        state.m_HL.w = get_HL();
-        state.m_IX.w = get_IX();
-        state.m_IY.w = get_IY();
-        state.m_SP.w = get_SP();
-        state.m_PC.w = get_PC();
-        state.m_AFp.w = get_AFp();
-        state.m_BCp.w = get_BCp();
-        state.m_DEp.w = get_DEp();
-        state.m_HLp.w = get_HLp();
-        state.m_WZ.w = get_WZ();
-        state.m_I = get_I();
+        State state = *this;
         state.m_R = get_R();
-        state.m_Q = get_Q();
-        state.m_IFF1 = get_IFF1();
-        state.m_IFF2 = get_IFF2();
-        state.m_halted = is_halted();
-        state.m_NMI_pending = is_NMI_pending();
-        state.m_IRQ_request = is_IRQ_requested();
-        state.m_EI_executed = is_EI_executed();
-        state.m_IRQ_data = get_IRQ_data();
-        state.m_flags_modified = get_flags_modified();
-        state.m_IRQ_mode = get_IRQ_mode();
-        state.m_index_mode = get_index_mode();
-        state.m_ticks = get_ticks();
-        state.m_RETI_signaled = is_RETI_signaled();
+        if constexpr (TConfig::LAZY_FLAGS) {
+            state.m_AF.w = get_AF();
+            state.m_Q = get_Q();
+        }
         return state;
     }
     void restore_state(const State& state) override {
-        set_AF(state.m_AF.w);
-        set_BC(state.m_BC.w);
-        set_DE(state.m_DE.w);
-        set_HL(state.m_HL.w);
-        set_IX(state.m_IX.w);
-        set_IY(state.m_IY.w);
-        set_SP(state.m_SP.w);
-        set_PC(state.m_PC.w);
-        set_AFp(state.m_AFp.w);
-        set_BCp(state.m_BCp.w);
-        set_DEp(state.m_DEp.w);
-        set_HLp(state.m_HLp.w);
-        set_WZ(state.m_WZ.w);
-        set_I(state.m_I);
-        set_R(state.m_R);
-        set_IFF1(state.m_IFF1);
-        set_IFF2(state.m_IFF2);
-        set_halted(state.m_halted);
-        set_NMI_pending(state.m_NMI_pending);
-        set_IRQ_request(state.m_IRQ_request);
-        set_EI_executed(state.m_EI_executed);
-        set_Q(state.m_Q);
-        set_IRQ_data(state.m_IRQ_data);
-        set_flags_modified(state.m_flags_modified);
-        set_IRQ_mode(state.m_IRQ_mode);
-        set_index_mode(state.m_index_mode);
-        set_ticks(state.m_ticks);
-        set_RETI_signaled(state.m_RETI_signaled);
+        static_cast<State&>(*this) = state;
+        m_R_fetches = 0;
+        if constexpr (TConfig::LAZY_FLAGS) {
+            set_F(state.m_AF.l);
+            set_Q(state.m_Q);
+        }
+        update_pending_events();
     }
 
     // Cycle counter
@@ -431,9 +536,16 @@ public:
         if constexpr (std::is_same_v<TEvents, StandardEvents>) {
             ++m_ticks;
         } else {
+#ifdef Z80_EVENT_HORIZON
+            if (Z80_LIKELY(++m_ticks != m_event_horizon))
+                return;
+            m_events->handle_event(m_ticks);
+            update_event_horizon();
+#else
             if (Z80_LIKELY(++m_ticks != m_events->get_event_limit()))
                 return;
             m_events->handle_event(m_ticks);
+#endif // Z80_EVENT_HORIZON
         }
     }
     void add_ticks(long long delta) override {
@@ -441,6 +553,18 @@ public:
             m_ticks += delta;
         } else {
             long long target_ticks = m_ticks + delta;
+#ifdef Z80_EVENT_HORIZON
+            if (Z80_LIKELY(target_ticks < m_event_horizon)) {
+                m_ticks = target_ticks;
+                return;
+            }
+            while (m_event_horizon <= target_ticks) {
+                m_ticks = m_event_horizon;
+                m_events->handle_event(m_ticks);
+                update_event_horizon();
+            }
+            m_ticks = target_ticks;
+#else
             if (Z80_LIKELY(target_ticks < m_events->get_event_limit())) {
                 m_ticks = target_ticks;
                 return;
@@ -451,6 +575,7 @@ public:
                 m_events->handle_event(m_ticks);
             }
             m_ticks = target_ticks;
+#endif // Z80_EVENT_HORIZON
         }
     }
 
@@ -494,8 +619,10 @@ public:
             delete m_events;
         m_events = events;
         m_owns_events = false;
-        if (m_events)
+        if (m_events) {
             m_events->connect(this);
+            update_event_horizon();
+        }
     }
     TDebugger* get_debugger() {
         return m_debugger;
@@ -514,10 +641,14 @@ public:
 
     // 16-bit main registers
     uint16_t get_AF() const override {
+        if constexpr (TConfig::LAZY_FLAGS)
+            return (m_AF.h << 8) | get_F();
         return m_AF.w;
     }
     void set_AF(uint16_t value) override {
         m_AF.w = value;
+        if constexpr (TConfig::LAZY_FLAGS)
+            m_pending_flags = (value & Flags::C) << 7;
     }
     uint16_t get_BC() const override {
         return m_BC.w;
@@ -550,16 +681,16 @@ public:
         m_IY.w = value;
     }
     uint16_t get_SP() const override {
-        return m_SP;
+        return m_SP.w;
     }
     void set_SP(uint16_t value) override {
-        m_SP = value;
+        m_SP.w = value;
     }
     uint16_t get_PC() const override {
-        return m_PC;
+        return m_PC.w;
     }
     void set_PC(uint16_t value) override {
-        m_PC = value;
+        m_PC.w = value;
     }
 
     // 16-bit internal temporary register
@@ -617,12 +748,19 @@ public:
     void set_A(uint8_t value) override {
         m_AF.h = value;
     }
-    Flags get_F() const override {
+    ICPU::Flags get_F() const override {
+        if constexpr (TConfig::LAZY_FLAGS) {
+            if ((m_pending_flags & 0x7F) != (uint8_t)FlagsOp::None)
+                return evaluate_flags(m_pending_flags);
+        }
         return m_AF.l;
     }
-    void set_F(Flags value) override {
+    void set_F(ICPU::Flags value) override {
         m_AF.l = value;
-        set_flags_modified(true);
+        if constexpr (TConfig::LAZY_FLAGS)
+            m_pending_flags = (value & Flags::C) << 7;
+        if constexpr (TConfig::TRACK_Q)
+            set_flags_modified(true);
     }
     uint8_t get_B() const override {
         return m_BC.h;
@@ -693,10 +831,11 @@ public:
         m_I = value;
     }
     uint8_t get_R() const override {
-        return m_R;
+        return (m_R & 0x80) | ((m_R + m_R_fetches) & 0x7F);
     }
     void set_R(uint8_t value) override {
         m_R = value;
+        m_R_fetches = 0;
     }
 
     // CPU state flags
@@ -705,12 +844,14 @@ public:
     }
     void set_IFF1(bool state) override {
         m_IFF1 = state;
+        update_pending_events();
     }
     bool is_EI_executed() const override {
         return m_EI_executed;
     }
     void set_EI_executed(bool state) override {
         m_EI_executed = state;
+        update_pending_events();
     }
     bool get_IFF2() const override {
         return m_IFF2;
@@ -723,6 +864,7 @@ public:
     }
     void set_halted(bool state) override {
         m_halted = state;
+        update_pending_events();
     }
 
     // Interrupt state flags
@@ -731,12 +873,14 @@ public:
     }
     void set_NMI_pending(bool state) override {
         m_NMI_pending = state;
+        update_pending_events();
     }
     bool is_IRQ_requested() const override {
         return m_IRQ_request;
     }
     void set_IRQ_request(bool state) override {
         m_IRQ_request = state;
+        update_pending_events();
     }
     bool is_IRQ_pending() const override {
         return is_IRQ_requested() && get_IFF1();
@@ -775,35 +919,119 @@ public:
     }
 
     uint8_t get_Q() const override {
+        if constexpr (TConfig::LAZY_FLAGS) {
+            if ((m_Q_flags & 0x7F) != (uint8_t)FlagsOp::None)
+                return evaluate_flags(m_Q_flags);
+        }
         return m_Q;
     }
     void set_Q(uint8_t value) override {
         m_Q = value;
+        if constexpr (TConfig::LAZY_FLAGS)
+            m_Q_flags = 0;
     }
 
 private:
-    // CPU registers
-    Register m_AF, m_BC, m_DE, m_HL;
-    Register m_AFp, m_BCp, m_DEp, m_HLp, m_WZ;
-    Register m_IX, m_IY;
-    uint16_t m_SP, m_PC;
-    uint8_t m_I, m_R, m_Q;
-    bool m_IFF1, m_IFF2;
+    // CPU registers and internal states are the members of the State base
 
-    // internal CPU states
-    bool m_halted, m_NMI_pending, m_IRQ_request, m_RETI_signaled, m_EI_executed;
-    uint8_t m_IRQ_data, m_IRQ_mode;
-    IndexMode m_index_mode;
-
-    bool m_flags_modified;
-    // CPU T-states
-    long long m_ticks;
+    // Conditions that make an instruction boundary leave the fast path, kept in step with the state flags
+    // by their setters so the boundary tests a single byte
+    enum PendingEvent : uint8_t {
+        PENDING_NMI = 1 << 0,
+        PENDING_EI = 1 << 1,
+        PENDING_IRQ = 1 << 2, // IRQ requested and accepted (IFF1)
+        PENDING_HALT = 1 << 3,
+        PENDING_INTERRUPTS = PENDING_NMI | PENDING_EI | PENDING_IRQ
+    };
+    uint8_t m_pending_events = 0;
+    // Requests posted by other threads: the IRQ data byte and the request bits
+    enum MailboxBit : uint32_t {
+        MAILBOX_DATA = 0xFF,
+        MAILBOX_IRQ = 1 << 8,
+        MAILBOX_NMI = 1 << 9,
+        MAILBOX_STOP = 1 << 10
+    };
+    std::atomic<uint32_t> m_mailbox{0};
+    // A single relaxed load, so the boundary fast paths only leave for the full boundary when mail has arrived
+    bool has_mail() const {
+        if constexpr (TConfig::THREAD_MAILBOX)
+            return m_mailbox.load(std::memory_order_relaxed) != 0;
+        else
+            return false;
+    }
+    // Hands the posted requests to the interrupt state; true when run() has to stop. A single step leaves a
+    // stop request in the mailbox for the next run().
+    template <bool TKeepStop> bool drain_mailbox() {
+        uint32_t mail = TKeepStop ? m_mailbox.fetch_and(MAILBOX_STOP, std::memory_order_acquire)
+                                  : m_mailbox.exchange(0, std::memory_order_acquire);
+        if (mail & MAILBOX_NMI)
+            request_NMI();
+        if (mail & MAILBOX_IRQ)
+            request_interrupt((uint8_t)(mail & MAILBOX_DATA));
+        return !TKeepStop && (mail & MAILBOX_STOP);
+    }
+    // Lazy R: opcode fetches since R was last written. get_R() adds them to the low 7 bits of m_R, so the
+    // fetch itself is a plain byte increment (256 is a multiple of the 7-bit period).
+    uint8_t m_R_fetches = 0;
+    void update_pending_events() {
+        m_pending_events = (m_NMI_pending ? PENDING_NMI : 0) | (m_EI_executed ? PENDING_EI : 0) |
+                           (m_IRQ_request && m_IFF1 ? PENDING_IRQ : 0) | (m_halted ? PENDING_HALT : 0);
+    }
+    // Lazy flags: the last 8-bit ALU operation whose flags have not been built yet, packed as
+    // op | carry << 7 | a << 8 | value << 16 | result << 24 (op None: F is in m_AF.l), and the same record for
+    // Q, which is F as left by the previous instruction when it changed the flags. The carry bit is always
+    // valid, so ADC/SBC/INC/DEC never build F. Add/Sub cover the carry variants (the carry in is recovered as
+    // result - a - value); Inc/Dec keep the previous carry flag in place of a.
+    enum class FlagsOp : uint8_t { None, Add, Sub, Cp, And, OrXor, Inc, Dec };
+    uint32_t m_pending_flags = 0, m_Q_flags = 0;
+#ifdef Z80_EVENT_HORIZON
+    long long m_event_horizon = LLONG_MAX;
+#endif // Z80_EVENT_HORIZON
+    // Tick limit of the run() in progress; block fast-forward is disabled outside run()
+    long long m_run_ticks_limit = LLONG_MIN;
+    // Idle loop candidate: a short side-effect-free loop closed by a backward JR/JP, armed with the CPU state
+    // at its start and confirmed when one more iteration brings the CPU back to exactly that state.
+    static constexpr int IDLE_LOOP_MAX_CODE = 16;
+    static constexpr int IDLE_LOOP_MAX_READS = 4;
+    enum class IdleRead : uint8_t { Absolute, BC, DE, HL };
+    struct IdleLoop {
+        bool armed = false;
+        uint16_t start, branch_pc;
+        uint8_t code_length;
+        uint8_t code[IDLE_LOOP_MAX_CODE + 3];
+        uint8_t read_count;
+        IdleRead read_kind[IDLE_LOOP_MAX_READS];
+        uint16_t read_address[IDLE_LOOP_MAX_READS];
+        uint8_t read_size[IDLE_LOOP_MAX_READS];
+        Register AF, BC, DE, HL, IX, IY, AFp, BCp, DEp, HLp, WZ;
+        uint16_t SP;
+        uint8_t I, R, Q;
+        long long ticks, iteration_ticks, event_limit;
+    } m_idle_loop;
 
     // Bus
     uint16_t m_address_bus; // A0-A15
     uint8_t m_data_bus;     // D0-D7
+    void update_address_bus(uint16_t address) {
+        if constexpr (TConfig::TRACK_BUS)
+            m_address_bus = address;
+    }
+    void update_data_bus(uint8_t data) {
+        if constexpr (TConfig::TRACK_BUS)
+            m_data_bus = data;
+    }
+    // Internal WZ (MEMPTR) updates, dropped when the accuracy profile does not track WZ
+    void update_WZ(uint16_t value) {
+        if constexpr (TConfig::TRACK_WZ)
+            m_WZ.w = value;
+    }
 
     // Memory and IO operations
+    // StandardEvents and StandardDebugger hold no state, so CPUs that create their own share one of each
+    template <typename T> static T* get_shared_instance() {
+        static T s_instance;
+        return &s_instance;
+    }
     TBus* m_bus;
     TEvents* m_events;
     TDebugger* m_debugger;
@@ -815,13 +1043,51 @@ private:
 #endif // Z80_DEBUGGER_OPCODES
 
     // Internal memory access helpers
+    uint8_t bus_read(uint16_t address) {
+        if constexpr (is_paged_bus_v<TBus>) {
+            const uint8_t* page = m_bus->get_read_pages()[address >> TBus::PAGE_BITS];
+            if (Z80_LIKELY(page != nullptr))
+                return page[address & ((1 << TBus::PAGE_BITS) - 1)];
+        }
+        return m_bus->read(address);
+    }
+    void bus_write(uint16_t address, uint8_t value) {
+        if constexpr (is_paged_bus_v<TBus>) {
+            uint8_t* page = m_bus->get_write_pages()[address >> TBus::PAGE_BITS];
+            if (Z80_LIKELY(page != nullptr)) {
+                page[address & ((1 << TBus::PAGE_BITS) - 1)] = value;
+                return;
+            }
+        }
+        m_bus->write(address, value);
+    }
+    // True when the next `ticks` T-states reach no event. A machine cycle checks this once and then moves the
+    // counter with plain adds; otherwise it steps T-state by T-state so each event fires on its exact T-state.
+    bool is_event_free(long long ticks) const {
+        if constexpr (std::is_same_v<TEvents, StandardEvents>) {
+            return true;
+        } else {
+#ifdef Z80_EVENT_HORIZON
+            return m_ticks + ticks < m_event_horizon;
+#else
+            return m_ticks + ticks < m_events->get_event_limit();
+#endif // Z80_EVENT_HORIZON
+        }
+    }
+    template <int TTicks> void add_cycle_ticks(bool event_free) {
+        if (Z80_LIKELY(event_free))
+            m_ticks += TTicks;
+        else
+            for (int i = 0; i < TTicks; ++i)
+                add_tick();
+    }
     uint8_t read_byte(uint16_t address) {
-        m_address_bus = address;
-        add_tick(); // T1
-        add_tick(); // T2
-        uint8_t data = m_bus->read(address);
-        m_data_bus = data;
-        add_tick(); // T3
+        update_address_bus(address);
+        bool event_free = is_event_free(3);
+        add_cycle_ticks<2>(event_free); // T1, T2
+        uint8_t data = bus_read(address);
+        update_data_bus(data);
+        add_cycle_ticks<1>(event_free); // T3
         return data;
     }
     uint16_t read_word(uint16_t address) {
@@ -830,12 +1096,13 @@ private:
         return ((uint16_t)(high_byte) << 8) | low_byte;
     }
     void write_byte(uint16_t address, uint8_t value) {
-        m_address_bus = address;
-        add_tick(); // T1
-        m_data_bus = value;
-        add_tick(); // T2
-        m_bus->write(address, value);
-        add_tick(); // T3
+        update_address_bus(address);
+        bool event_free = is_event_free(3);
+        add_cycle_ticks<1>(event_free); // T1
+        update_data_bus(value);
+        add_cycle_ticks<1>(event_free); // T2
+        bus_write(address, value);
+        add_cycle_ticks<1>(event_free); // T3
     }
     void write_word(uint16_t address, uint16_t value) {
         write_byte(address, value & 0xFF);
@@ -857,19 +1124,18 @@ private:
     }
     uint8_t fetch_next_opcode() {
         uint16_t current_pc = get_PC();
-        m_address_bus = current_pc;
-        add_tick(); // T1
-        add_tick(); // T2
-        uint8_t opcode = m_bus->read(current_pc);
-        m_data_bus = opcode;
+        update_address_bus(current_pc);
+        bool event_free = is_event_free(4);
+        add_cycle_ticks<2>(event_free); // T1, T2
+        uint8_t opcode = bus_read(current_pc);
+        update_data_bus(opcode);
 #ifdef Z80_DEBUGGER_OPCODES
         if constexpr (!std::is_same_v<TDebugger, StandardDebugger>)
             m_opcodes.push_back(opcode);
 #endif // Z80_DEBUGGER_OPCODES
-        uint8_t r_val = get_R();
-        set_R(((r_val + 1) & 0x7F) | (r_val & 0x80));
-        add_tick(); // T3
-        add_tick(); // T4
+        if constexpr (TConfig::TRACK_R)
+            ++m_R_fetches;
+        add_cycle_ticks<2>(event_free); // T3, T4
         set_PC(current_pc + 1);
         return opcode;
     }
@@ -890,240 +1156,692 @@ private:
     }
     // I/O operations
     uint8_t io_read(uint16_t port) {
-        m_address_bus = port;
+        update_address_bus(port);
         uint8_t value = m_bus->in(port);
-        m_data_bus = value;
+        update_data_bus(value);
         add_ticks(4);
         return value;
     }
     void io_write(uint16_t port, uint8_t value) {
-        m_address_bus = port;
-        m_data_bus = value;
+        update_address_bus(port);
+        update_data_bus(value);
         m_bus->out(port, value);
         add_ticks(4);
     }
-    // Parity bits
-    bool parity_table[256];
-    bool is_parity_even(uint8_t value) {
-        return parity_table[value];
-    }
-    void precompute_parity() {
-        for (int i = 0; i < 256; ++i) {
-            int count = 0;
-            int temp = i;
-            while (temp > 0) {
-                temp &= (temp - 1);
-                count++;
+#ifdef Z80_EVENT_HORIZON
+    // Caches the next event deadline. A deadline that is already behind the tick counter can never
+    // be hit again, so it is parked at LLONG_MAX until the next refresh.
+    void update_event_horizon() {
+        if constexpr (!std::is_same_v<TEvents, StandardEvents>) {
+            long long event_limit = m_events->get_event_limit();
+            m_event_horizon = (event_limit > m_ticks) ? event_limit : LLONG_MAX;
+        }
+    }
+#else
+    void update_event_horizon() {}
+#endif // Z80_EVENT_HORIZON
+    // Number of further iterations (of `ticks` T-states each) a repeating block instruction can run
+    // back to back: each must start below the run limit, and none may reach the next event or
+    // leave an interrupt waiting at an instruction boundary.
+    long long block_fast_forward_budget(long long iterations, long long ticks) const {
+        if (iterations <= 0 || m_ticks >= m_run_ticks_limit)
+            return 0;
+        if (m_pending_events & PENDING_INTERRUPTS)
+            return 0;
+        long long budget = std::min(iterations, (m_run_ticks_limit - m_ticks - 1) / ticks + 1);
+        if constexpr (!std::is_same_v<TEvents, StandardEvents>) {
+            long long event_limit = m_events->get_event_limit();
+            if (event_limit <= m_ticks)
+                return 0;
+            budget = std::min(budget, (event_limit - 1 - m_ticks) / ticks);
+        }
+        return budget;
+    }
+    // Commits `count` skipped iterations of a repeating ED instruction: two opcode fetches each.
+    void commit_block_iterations(long long count, long long ticks) {
+        if constexpr (TConfig::TRACK_R)
+            m_R_fetches += 2 * count;
+        m_ticks += count * ticks;
+        set_index_mode(IndexMode::HL);
+    }
+    // Host pointer behind `address` on a paged bus, or nullptr when the page goes through read()
+    const uint8_t* direct_read_ptr(uint16_t address) const {
+        const uint8_t* page = m_bus->get_read_pages()[address >> TBus::PAGE_BITS];
+        return page ? page + (address & ((1 << TBus::PAGE_BITS) - 1)) : nullptr;
+    }
+    // The iteration that just ran may have rewritten (or unmapped) the instruction it repeats
+    bool is_block_instruction_intact(uint8_t opcode) const {
+        const uint8_t* prefix = direct_read_ptr(get_PC());
+        const uint8_t* operand = direct_read_ptr(get_PC() + 1);
+        return prefix && operand && *prefix == 0xED && *operand == opcode;
+    }
+    enum class BlockCopy { LDIR, LDDR, LDIRX, LDDRX, LDPIRX, LDIRSCALE };
+    // Runs further iterations of a repeating block copy straight on the bus page pointers. Called once
+    // an iteration has decided to repeat (PC rewound, BC != 0); flags and WZ already hold what every
+    // later repeating iteration leaves behind. Stops at the last iteration, at unmapped or read-only
+    // pages and before the copy overwrites the instruction itself, leaving the rest to the loop.
+    template <BlockCopy TCopy> void fast_forward_block_copy() {
+        if constexpr (is_paged_bus_v<TBus> && std::is_same_v<TDebugger, StandardDebugger>) {
+            constexpr long long ITERATION_TICKS = 21;
+            constexpr int PAGE_BITS = TBus::PAGE_BITS;
+            constexpr uint32_t PAGE_SIZE = 1u << PAGE_BITS;
+            constexpr uint16_t PAGE_MASK = PAGE_SIZE - 1;
+            constexpr bool INCREMENT = TCopy != BlockCopy::LDDR && TCopy != BlockCopy::LDDRX;
+            constexpr bool BULK = TCopy != BlockCopy::LDPIRX && TCopy != BlockCopy::LDIRSCALE;
+            constexpr uint8_t OPCODE = TCopy == BlockCopy::LDIR ? 0xB0 : TCopy == BlockCopy::LDDR ? 0xB8
+                                     : TCopy == BlockCopy::LDIRX ? 0xB4 : TCopy == BlockCopy::LDDRX ? 0xBC
+                                     : TCopy == BlockCopy::LDPIRX ? 0xB7 : 0xB6;
+            long long count = block_fast_forward_budget(get_BC() - 1, ITERATION_TICKS);
+            if (count <= 0 || !is_block_instruction_intact(OPCODE))
+                return;
+            uint8_t* const* read_pages = m_bus->get_read_pages();
+            uint8_t* const* write_pages = m_bus->get_write_pages();
+            uintptr_t opcode_ptr = reinterpret_cast<uintptr_t>(direct_read_ptr(get_PC()));
+            uintptr_t operand_ptr = reinterpret_cast<uintptr_t>(direct_read_ptr(get_PC() + 1));
+            uint16_t hl = get_HL();
+            uint16_t de = get_DE();
+            uint16_t address = 0;
+            uint8_t value = 0;
+            long long done = 0;
+            while (done < count) {
+                const uint8_t* src_page = read_pages[hl >> PAGE_BITS];
+                uint8_t* dst_page = write_pages[de >> PAGE_BITS];
+                if (!src_page || !dst_page)
+                    break;
+                const uint8_t* src = src_page + (hl & PAGE_MASK);
+                uint8_t* dst = dst_page + (de & PAGE_MASK);
+                if constexpr (BULK) {
+                    // Page-bounded run; the low end of the run is at dst - (n - 1) when copying down
+                    uint32_t n = INCREMENT ? std::min(PAGE_SIZE - (hl & PAGE_MASK), PAGE_SIZE - (de & PAGE_MASK))
+                                           : std::min<uint32_t>((hl & PAGE_MASK) + 1, (de & PAGE_MASK) + 1);
+                    n = (uint32_t)std::min<long long>(n, count - done);
+                    uintptr_t dst_ptr = reinterpret_cast<uintptr_t>(dst);
+                    for (uintptr_t instruction_ptr : {opcode_ptr, operand_ptr}) {
+                        uintptr_t distance = INCREMENT ? instruction_ptr - dst_ptr : dst_ptr - instruction_ptr;
+                        if (distance < n)
+                            n = (uint32_t)distance;
+                    }
+                    if (n == 0)
+                        break;
+                    uintptr_t src_ptr = reinterpret_cast<uintptr_t>(src);
+                    uintptr_t lead = INCREMENT ? dst_ptr - src_ptr : src_ptr - dst_ptr;
+                    if (lead != 0 && lead < n) {
+                        // Destination trails the source inside the run: byte order matters
+                        for (uint32_t i = 0; i < n; ++i) {
+                            if constexpr (INCREMENT)
+                                dst[i] = src[i];
+                            else
+                                *(dst - i) = *(src - i);
+                        }
+                    } else if constexpr (INCREMENT)
+                        std::memmove(dst, src, n);
+                    else
+                        std::memmove(dst - (n - 1), src - (n - 1), n);
+                    value = INCREMENT ? dst[n - 1] : *(dst - (n - 1));
+                    address = INCREMENT ? de + n - 1 : de - (n - 1);
+                    hl = INCREMENT ? hl + n : hl - n;
+                    de = INCREMENT ? de + n : de - n;
+                    done += n;
+                } else {
+                    uintptr_t dst_ptr = reinterpret_cast<uintptr_t>(dst);
+                    if (dst_ptr == opcode_ptr || dst_ptr == operand_ptr)
+                        break;
+                    value = *src;
+                    if constexpr (TCopy == BlockCopy::LDPIRX) {
+                        if (value != get_A()) {
+                            *dst = value;
+                            address = de;
+                        } else
+                            address = hl;
+                        ++hl;
+                    } else {
+                        *dst = value;
+                        address = de;
+                        hl += get_BCp();
+                    }
+                    ++de;
+                    ++done;
+                }
+            }
+            if (done == 0)
+                return;
+            set_HL(hl);
+            set_DE(de);
+            set_BC(get_BC() - done);
+            update_address_bus(address);
+            update_data_bus(value);
+            commit_block_iterations(done, ITERATION_TICKS);
+        }
+    }
+    // Runs further iterations of CPIR/CPDR that neither match A nor exhaust BC by scanning the mapped
+    // pages directly. S and H come from the last byte compared; the rest of F and WZ are what every
+    // repeating iteration leaves behind. The matching iteration itself is left to the loop.
+    template <bool Increment> void fast_forward_block_compare() {
+        if constexpr (is_paged_bus_v<TBus> && std::is_same_v<TDebugger, StandardDebugger>) {
+            constexpr long long ITERATION_TICKS = 21;
+            constexpr uint32_t PAGE_SIZE = 1u << TBus::PAGE_BITS;
+            constexpr uint16_t PAGE_MASK = PAGE_SIZE - 1;
+            long long count = block_fast_forward_budget(get_BC() - 1, ITERATION_TICKS);
+            if (count <= 0 || !is_block_instruction_intact(Increment ? 0xB1 : 0xB9))
+                return;
+            uint8_t a = get_A();
+            uint16_t hl = get_HL();
+            uint16_t address = 0;
+            long long done = 0;
+            while (done < count) {
+                const uint8_t* src = direct_read_ptr(hl);
+                if (!src)
+                    break;
+                uint32_t n = Increment ? PAGE_SIZE - (hl & PAGE_MASK) : (hl & PAGE_MASK) + 1u;
+                n = (uint32_t)std::min<long long>(n, count - done);
+                uint32_t scanned = 0;
+                if constexpr (Increment) {
+                    const void* match = std::memchr(src, a, n);
+                    scanned = match ? (uint32_t)(static_cast<const uint8_t*>(match) - src) : n;
+                } else {
+                    while (scanned < n && *(src - scanned) != a)
+                        ++scanned;
+                }
+                if (scanned > 0) {
+                    address = Increment ? hl + scanned - 1 : hl - (scanned - 1);
+                    hl = Increment ? hl + scanned : hl - scanned;
+                    done += scanned;
+                }
+                if (scanned < n)
+                    break;
+            }
+            if (done == 0)
+                return;
+            uint8_t value = *direct_read_ptr(address);
+            set_HL(hl);
+            set_BC(get_BC() - done);
+            update_address_bus(address);
+            update_data_bus(value);
+            Flags flags = get_F();
+            flags.update(Flags::S, ((uint8_t)(a - value) & 0x80) != 0)
+                .update(Flags::H, (a & 0x0F) < (value & 0x0F));
+            set_F(flags);
+            commit_block_iterations(done, ITERATION_TICKS);
+        }
+    }
+    enum class BlockIO { INIR, INDR, OTIR, OTDR };
+    // Hands the following iterations of a repeating block I/O instruction to the bus in_block()/out_block()
+    // in one call. The memory side must be directly mapped (and, for input, must not cover the instruction);
+    // B, HL, flags, R, ticks and the bus mirrors are committed for as many transfers as the bus made.
+    template <BlockIO TIO> void fast_forward_block_io() {
+        constexpr bool INPUT = TIO == BlockIO::INIR || TIO == BlockIO::INDR;
+        constexpr bool INCREMENT = TIO == BlockIO::INIR || TIO == BlockIO::OTIR;
+        constexpr bool SUPPORTED = INPUT ? has_in_block_v<TBus> : has_out_block_v<TBus>;
+        if constexpr (SUPPORTED && is_paged_bus_v<TBus> && std::is_same_v<TDebugger, StandardDebugger>) {
+            constexpr long long ITERATION_TICKS = 21;
+            constexpr uint16_t PAGE_MASK = (1 << TBus::PAGE_BITS) - 1;
+            constexpr uint8_t OPCODE = TIO == BlockIO::INIR ? 0xB2 : TIO == BlockIO::INDR ? 0xBA
+                                     : TIO == BlockIO::OTIR ? 0xB3 : 0xBB;
+            long long count = block_fast_forward_budget(get_B() - 1, ITERATION_TICKS);
+            if (count <= 0 || !is_block_instruction_intact(OPCODE))
+                return;
+            const uint8_t* opcode_ptr = direct_read_ptr(get_PC());
+            const uint8_t* operand_ptr = direct_read_ptr(get_PC() + 1);
+            uint8_t buffer[256];
+            uint8_t* destinations[256];
+            uint16_t hl = get_HL();
+            size_t n = 0;
+            for (; n < (size_t)count; ++n) {
+                uint16_t address = INCREMENT ? hl + n : hl - n;
+                if constexpr (INPUT) {
+                    uint8_t* page = m_bus->get_write_pages()[address >> TBus::PAGE_BITS];
+                    if (!page)
+                        break;
+                    uint8_t* destination = page + (address & PAGE_MASK);
+                    if (destination == opcode_ptr || destination == operand_ptr)
+                        break;
+                    destinations[n] = destination;
+                } else {
+                    const uint8_t* source = direct_read_ptr(address);
+                    if (!source)
+                        break;
+                    buffer[n] = *source;
+                }
+            }
+            if (n == 0)
+                return;
+            uint8_t b = get_B();
+            uint8_t c = get_C();
+            size_t moved;
+            if constexpr (INPUT) {
+                moved = std::min(m_bus->in_block((uint16_t)((b << 8) | c), buffer, n), n);
+                for (size_t i = 0; i < moved; ++i)
+                    *destinations[i] = buffer[i];
+            } else
+                moved = std::min(m_bus->out_block((uint16_t)(((uint8_t)(b - 1) << 8) | c), buffer, n), n);
+            if (moved == 0)
+                return;
+            uint8_t value = buffer[moved - 1];
+            uint8_t new_b = b - (uint8_t)moved;
+            uint16_t last_address = INCREMENT ? hl + (moved - 1) : hl - (moved - 1);
+            hl = INCREMENT ? hl + moved : hl - moved;
+            set_B(new_b);
+            set_HL(hl);
+            update_address_bus(INPUT ? last_address : (uint16_t)((new_b << 8) | c));
+            update_data_bus(value);
+            if constexpr (INPUT)
+                set_IO_block_flags(value, value + (uint8_t)(INCREMENT ? c + 1 : c - 1), new_b);
+            else
+                set_IO_block_flags(value, (uint16_t)(hl & 0xFF) + value, new_b);
+            adjust_flags_after_IO_block();
+            commit_block_iterations(moved, ITERATION_TICKS);
+        }
+    }
+    // A halted CPU can only be woken by an interrupt, and only an event can raise one: sleep up to the next
+    // event rather than the whole run limit, so the interrupt is taken at the boundary right after it.
+    long long halted_ticks_target(long long ticks_limit) const {
+        if constexpr (!std::is_same_v<TEvents, StandardEvents>) {
+            long long event_limit = m_events->get_event_limit();
+            if (event_limit > m_ticks && event_limit < ticks_limit)
+                return event_limit;
+        }
+        return ticks_limit;
+    }
+    // Idle loops are only skipped when opcode fetches and data reads have no side effects: plain StandardBus
+    // memory or directly mapped pages, and no debugger watching each step.
+    static constexpr bool IDLE_LOOP_FAST_FORWARD = std::is_same_v<TDebugger, StandardDebugger> &&
+                                                   (std::is_same_v<TBus, StandardBus> || is_paged_bus_v<TBus>);
+    bool is_idle_read_pure(uint16_t address) const {
+        if constexpr (is_paged_bus_v<TBus>)
+            return direct_read_ptr(address) != nullptr;
+        else
+            return true;
+    }
+    bool peek_idle_code(uint16_t address, uint8_t& value) const {
+        if constexpr (is_paged_bus_v<TBus>) {
+            const uint8_t* ptr = direct_read_ptr(address);
+            if (!ptr)
+                return false;
+            value = *ptr;
+        } else
+            value = m_bus->peek(address);
+        return true;
+    }
+    // Length of one idle loop body instruction, or 0 when it may write memory or I/O, use the stack, branch,
+    // or read through a register pair the body has already changed. `modified` tracks B, C, D, E, H, L; the
+    // instruction's T-states are added to the loop's iteration time.
+    static int decode_idle_instruction(const uint8_t* code, int available, uint8_t& modified, IdleLoop& loop) {
+        constexpr uint8_t REG_BITS[8] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x00, 0x00};
+        auto add_read = [&](IdleRead kind, uint16_t address, uint8_t size) {
+            uint8_t pair = kind == IdleRead::BC ? 0x03 : kind == IdleRead::DE ? 0x0C : kind == IdleRead::HL ? 0x30 : 0;
+            if ((modified & pair) || loop.read_count == IDLE_LOOP_MAX_READS)
+                return false;
+            loop.read_kind[loop.read_count] = kind;
+            loop.read_address[loop.read_count] = address;
+            loop.read_size[loop.read_count++] = size;
+            return true;
+        };
+        uint8_t opcode = code[0];
+        int length = 1;
+        int ticks = 4;
+        if (opcode == 0x00 || (opcode & 0xC7) == 0x07) // NOP, RLCA..CCF
+            length = 1;
+        else if ((opcode & 0xC6) == 0x04 && ((opcode >> 3) & 7) != 6) // INC r / DEC r
+            modified |= REG_BITS[(opcode >> 3) & 7];
+        else if ((opcode & 0xC7) == 0x06 && ((opcode >> 3) & 7) != 6) { // LD r,n
+            length = 2;
+            ticks = 7;
+            modified |= REG_BITS[(opcode >> 3) & 7];
+        } else if (opcode == 0x0A || opcode == 0x1A) { // LD A,(BC) / LD A,(DE)
+            ticks = 7;
+            if (!add_read(opcode == 0x0A ? IdleRead::BC : IdleRead::DE, 0, 1))
+                return 0;
+        } else if (opcode == 0x3A || opcode == 0x2A) { // LD A,(nn) / LD HL,(nn)
+            length = 3;
+            ticks = opcode == 0x2A ? 16 : 13;
+            if (available < 3 || !add_read(IdleRead::Absolute, code[1] | (code[2] << 8), opcode == 0x2A ? 2 : 1))
+                return 0;
+            if (opcode == 0x2A)
+                modified |= 0x30;
+        } else if (opcode >= 0x40 && opcode <= 0xBF && (opcode & 0xF8) != 0x70) { // LD r,r' and ALU A,r
+            if ((opcode & 7) == 6) {
+                ticks = 7;
+                if (!add_read(IdleRead::HL, 0, 1))
+                    return 0;
+            }
+            if (opcode < 0x80)
+                modified |= REG_BITS[(opcode >> 3) & 7];
+        } else if ((opcode & 0xC7) == 0xC6) { // ALU A,n
+            length = 2;
+            ticks = 7;
+        } else if (opcode == 0xCB && available >= 2) { // BIT b,r / BIT b,(HL) and register-only CB operations
+            uint8_t cb_opcode = code[1];
+            length = 2;
+            ticks = 8;
+            if ((cb_opcode & 7) == 6) {
+                ticks = 12;
+                if ((cb_opcode & 0xC0) != 0x40 || !add_read(IdleRead::HL, 0, 1))
+                    return 0;
+            } else if ((cb_opcode & 0xC0) != 0x40)
+                modified |= REG_BITS[cb_opcode & 7];
+        } else
+            return 0;
+        loop.iteration_ticks += ticks;
+        return length <= available ? length : 0;
+    }
+    // Called by a taken JR/JP whose target (the current PC) is at most IDLE_LOOP_MAX_CODE bytes behind it.
+    void check_idle_loop(uint16_t branch_pc) {
+        if constexpr (IDLE_LOOP_FAST_FORWARD) {
+            uint16_t start = get_PC();
+            if ((uint16_t)(branch_pc - start) > IDLE_LOOP_MAX_CODE || m_run_ticks_limit == LLONG_MIN)
+                return;
+            IdleLoop& loop = m_idle_loop;
+            if (loop.armed && loop.start == start && loop.branch_pc == branch_pc && confirm_idle_loop())
+                fast_forward_idle_loop();
+            else
+                arm_idle_loop(start, branch_pc);
+        }
+    }
+    void arm_idle_loop(uint16_t start, uint16_t branch_pc) {
+        IdleLoop& loop = m_idle_loop;
+        loop.armed = false;
+        uint8_t branch_opcode;
+        if (!peek_idle_code(branch_pc, branch_opcode))
+            return;
+        bool is_jp = (branch_opcode & 0xC7) == 0xC2 || branch_opcode == 0xC3;
+        int body_length = (uint16_t)(branch_pc - start);
+        int length = body_length + (is_jp ? 3 : 2);
+        for (int i = 0; i < length; ++i)
+            if (!peek_idle_code(start + i, loop.code[i]))
+                return;
+        uint8_t modified = 0;
+        loop.read_count = 0;
+        loop.iteration_ticks = is_jp ? 10 : 12;
+        for (int offset = 0; offset < body_length;) {
+            int instruction_length = decode_idle_instruction(loop.code + offset, body_length - offset, modified, loop);
+            if (instruction_length == 0)
+                return;
+            offset += instruction_length;
+        }
+        loop.start = start;
+        loop.branch_pc = branch_pc;
+        loop.code_length = (uint8_t)length;
+        save_idle_loop_state();
+        loop.armed = true;
+    }
+    void save_idle_loop_state() {
+        IdleLoop& loop = m_idle_loop;
+        loop.AF.w = get_AF(); loop.BC = m_BC; loop.DE = m_DE; loop.HL = m_HL; loop.IX = m_IX; loop.IY = m_IY;
+        loop.AFp = m_AFp; loop.BCp = m_BCp; loop.DEp = m_DEp; loop.HLp = m_HLp; loop.WZ = m_WZ;
+        loop.SP = m_SP.w;
+        loop.I = m_I;
+        loop.R = get_R();
+        loop.Q = get_Q();
+        loop.ticks = m_ticks;
+        loop.event_limit = LLONG_MAX;
+        if constexpr (!std::is_same_v<TEvents, StandardEvents>)
+            loop.event_limit = m_events->get_event_limit();
+    }
+    // One iteration ran since the loop was armed. It is idle when that iteration started and ended in the
+    // same state, with the same code and no event or interrupt in between: every further iteration is then
+    // identical until an event or interrupt arrives.
+    bool confirm_idle_loop() {
+        IdleLoop& loop = m_idle_loop;
+        if (m_ticks - loop.ticks != loop.iteration_ticks)
+            return false;
+        if (loop.AF.w != get_AF() || loop.BC.w != m_BC.w || loop.DE.w != m_DE.w || loop.HL.w != m_HL.w ||
+            loop.IX.w != m_IX.w || loop.IY.w != m_IY.w || loop.AFp.w != m_AFp.w || loop.BCp.w != m_BCp.w ||
+            loop.DEp.w != m_DEp.w || loop.HLp.w != m_HLp.w || loop.WZ.w != m_WZ.w || loop.SP != m_SP.w ||
+            loop.I != m_I || loop.Q != get_Q())
+            return false;
+        if constexpr (!std::is_same_v<TEvents, StandardEvents>) {
+            if (m_events->get_event_limit() != loop.event_limit || loop.event_limit <= m_ticks)
+                return false;
+        }
+        for (int i = 0; i < loop.code_length; ++i) {
+            uint8_t value;
+            if (!peek_idle_code(loop.start + i, value) || value != loop.code[i])
+                return false;
+        }
+        for (int i = 0; i < loop.read_count; ++i) {
+            uint16_t address = loop.read_address[i];
+            switch (loop.read_kind[i]) {
+            case IdleRead::BC: address = m_BC.w; break;
+            case IdleRead::DE: address = m_DE.w; break;
+            case IdleRead::HL: address = m_HL.w; break;
+            default: break;
+            }
+            for (int byte = 0; byte < loop.read_size[i]; ++byte)
+                if (!is_idle_read_pure(address + byte))
+                    return false;
+        }
+        return true;
+    }
+    // Skips whole iterations up to the tick limit or just before the next event, then re-arms at the new point
+    void fast_forward_idle_loop() {
+        IdleLoop& loop = m_idle_loop;
+        long long iteration_ticks = loop.iteration_ticks;
+        uint8_t iteration_r = (get_R() - loop.R) & 0x7F;
+        if (!(m_pending_events & PENDING_INTERRUPTS)) {
+            long long count = (m_run_ticks_limit - m_ticks) / iteration_ticks;
+            if (loop.event_limit != LLONG_MAX)
+                count = std::min(count, (loop.event_limit - 1 - m_ticks) / iteration_ticks);
+            if (count > 0) {
+                m_ticks += count * iteration_ticks;
+                m_R_fetches += count * iteration_r;
             }
-            parity_table[i] = (count % 2) == 0;
         }
+        save_idle_loop_state();
+    }
+    // Parity bits
+    static bool is_parity_even(uint8_t value) {
+        return (FLAG_TABLES.SZP[value] & Flags::PV) != 0;
     }
 
-    // Indexed opcodes helpers
-    uint16_t get_indexed_HL() const {
-        if (Z80_LIKELY(m_index_mode == IndexMode::HL))
+    // Indexed opcodes helpers, resolved at compile time: handlers that touch HL are instantiated once
+    // per index mode, so the unprefixed ones carry no mode check
+    template <IndexMode TIndex> uint16_t get_indexed_HL() const {
+        if constexpr (TIndex == IndexMode::HL)
             return m_HL.w;
-        else if (m_index_mode == IndexMode::IX)
+        else if constexpr (TIndex == IndexMode::IX)
             return m_IX.w;
         else
             return m_IY.w;
     }
-    void set_indexed_HL(uint16_t value) {
-        if (Z80_LIKELY(m_index_mode == IndexMode::HL))
+    template <IndexMode TIndex> void set_indexed_HL(uint16_t value) {
+        if constexpr (TIndex == IndexMode::HL)
             set_HL(value);
-        else if (m_index_mode == IndexMode::IX)
+        else if constexpr (TIndex == IndexMode::IX)
             set_IX(value);
         else
             set_IY(value);
     }
-    uint8_t get_indexed_H() const {
-        if (Z80_LIKELY(m_index_mode == IndexMode::HL))
+    template <IndexMode TIndex> uint8_t get_indexed_H() const {
+        if constexpr (TIndex == IndexMode::HL)
             return get_H();
-        else if (m_index_mode == IndexMode::IX)
+        else if constexpr (TIndex == IndexMode::IX)
             return get_IXH();
         else
             return get_IYH();
     }
-    void set_indexed_H(uint8_t value) {
-        if (Z80_LIKELY(m_index_mode == IndexMode::HL))
+    template <IndexMode TIndex> void set_indexed_H(uint8_t value) {
+        if constexpr (TIndex == IndexMode::HL)
             set_H(value);
-        else if (m_index_mode == IndexMode::IX)
+        else if constexpr (TIndex == IndexMode::IX)
             set_IXH(value);
         else
             set_IYH(value);
     }
-    uint8_t get_indexed_L() const {
-        if (Z80_LIKELY(m_index_mode == IndexMode::HL))
+    template <IndexMode TIndex> uint8_t get_indexed_L() const {
+        if constexpr (TIndex == IndexMode::HL)
             return get_L();
-        else if (m_index_mode == IndexMode::IX)
+        else if constexpr (TIndex == IndexMode::IX)
             return get_IXL();
         else
             return get_IYL();
     }
-    void set_indexed_L(uint8_t value) {
-        if (Z80_LIKELY(m_index_mode == IndexMode::HL))
+    template <IndexMode TIndex> void set_indexed_L(uint8_t value) {
+        if constexpr (TIndex == IndexMode::HL)
             set_L(value);
-        else if (m_index_mode == IndexMode::IX)
+        else if constexpr (TIndex == IndexMode::IX)
             set_IXL(value);
         else
             set_IYL(value);
     }
-    uint16_t get_indexed_address() {
-        if (Z80_LIKELY(m_index_mode == IndexMode::HL))
+    template <IndexMode TIndex> uint16_t get_indexed_address() {
+        if constexpr (TIndex == IndexMode::HL)
             return get_HL();
         else {
             int8_t offset = (int8_t)fetch_next_byte();
-            uint16_t address = get_indexed_HL() + offset;
-            set_WZ(address);
+            uint16_t address = get_indexed_HL<TIndex>() + offset;
+            update_WZ(address);
             add_ticks(5);
             return address;
         }
     }
-    uint8_t get_indexed_HL_ptr() {
-        uint16_t address = get_indexed_address();
+    template <IndexMode TIndex> uint8_t get_indexed_HL_ptr() {
+        uint16_t address = get_indexed_address<TIndex>();
         return read_byte(address);
     }
-    void set_indexed_HL_ptr(uint8_t value) {
-        uint16_t address = get_indexed_address();
+    template <IndexMode TIndex> void set_indexed_HL_ptr(uint8_t value) {
+        uint16_t address = get_indexed_address<TIndex>();
         write_byte(address, value);
     }
 
+    // Flags helpers
+    // H is the carry (borrow) out of bit 3, read back from a ^ value ^ result; PV is the signed overflow
+    // moved from bit 7 down to bit 2; C is bit 8 of the 9-bit sum or difference.
+    template <FlagsOp TOp> static uint8_t compute_carry(uint8_t a, uint8_t value, uint8_t result) {
+        if constexpr (TOp == FlagsOp::Add)
+            return (a + value + (uint8_t)(result - a - value)) >> 8;
+        else if constexpr (TOp == FlagsOp::Sub || TOp == FlagsOp::Cp)
+            return ((a - value - (uint8_t)(a - value - result)) >> 8) & Flags::C;
+        else if constexpr (TOp == FlagsOp::Inc || TOp == FlagsOp::Dec)
+            return a;
+        else
+            return 0;
+    }
+    template <FlagsOp TOp> static uint8_t compute_flags(uint8_t a, uint8_t value, uint8_t result) {
+        if constexpr (TOp == FlagsOp::Add) {
+            return FLAG_TABLES.SZXY[result] | ((a ^ value ^ result) & Flags::H) |
+                   ((((a ^ value ^ 0x80) & (a ^ result)) & 0x80) >> 5) | compute_carry<TOp>(a, value, result);
+        } else if constexpr (TOp == FlagsOp::Sub || TOp == FlagsOp::Cp) {
+            uint8_t xy = TOp == FlagsOp::Cp ? FLAG_TABLES.SZ[result] | (value & (Flags::X | Flags::Y))
+                                            : FLAG_TABLES.SZXY[result];
+            return xy | Flags::N | ((a ^ value ^ result) & Flags::H) | ((((a ^ value) & (a ^ result)) & 0x80) >> 5) |
+                   compute_carry<TOp>(a, value, result);
+        } else if constexpr (TOp == FlagsOp::And)
+            return FLAG_TABLES.SZP[result] | Flags::H;
+        else if constexpr (TOp == FlagsOp::OrXor)
+            return FLAG_TABLES.SZP[result];
+        else if constexpr (TOp == FlagsOp::Inc)
+            return FLAG_TABLES.INC[result] | a;
+        else
+            return FLAG_TABLES.DEC[result] | a;
+    }
+    static uint8_t evaluate_flags(uint32_t pending) {
+        uint8_t a = pending >> 8, value = pending >> 16, result = pending >> 24;
+        switch ((FlagsOp)(pending & 0x7F)) {
+        case FlagsOp::Add: return compute_flags<FlagsOp::Add>(a, value, result);
+        case FlagsOp::Sub: return compute_flags<FlagsOp::Sub>(a, value, result);
+        case FlagsOp::Cp: return compute_flags<FlagsOp::Cp>(a, value, result);
+        case FlagsOp::And: return compute_flags<FlagsOp::And>(a, value, result);
+        case FlagsOp::OrXor: return compute_flags<FlagsOp::OrXor>(a, value, result);
+        case FlagsOp::Inc: return compute_flags<FlagsOp::Inc>(a, value, result);
+        case FlagsOp::Dec: return compute_flags<FlagsOp::Dec>(a, value, result);
+        default: return 0;
+        }
+    }
+    // Sets F after an 8-bit ALU operation, or only records the operation in lazy flags mode
+    template <FlagsOp TOp> void set_ALU_flags(uint8_t a, uint8_t value, uint8_t result) {
+        if constexpr (TConfig::LAZY_FLAGS) {
+            m_pending_flags = (uint32_t)TOp | compute_carry<TOp>(a, value, result) << 7 | a << 8 | value << 16 |
+                              (uint32_t)result << 24;
+            if constexpr (TConfig::TRACK_Q)
+                set_flags_modified(true);
+        } else
+            set_F(compute_flags<TOp>(a, value, result));
+    }
+    uint8_t get_carry() const {
+        if constexpr (TConfig::LAZY_FLAGS)
+            return (m_pending_flags >> 7) & Flags::C;
+        else
+            return m_AF.l & Flags::C;
+    }
+    // Single flag test for conditional instructions; in lazy flags mode S, Z and C come straight from the record
+    bool is_flag_set(uint8_t mask) const {
+        if constexpr (TConfig::LAZY_FLAGS) {
+            if (mask == Flags::C)
+                return get_carry() != 0;
+            if ((mask == Flags::Z || mask == Flags::S) && (m_pending_flags & 0x7F) != (uint8_t)FlagsOp::None) {
+                uint8_t result = m_pending_flags >> 24;
+                return mask == Flags::Z ? result == 0 : (result & 0x80) != 0;
+            }
+        }
+        return get_F().is_set(mask);
+    }
+    // Q latches F at the end of every instruction that changed the flags, and is 0 otherwise
+    void update_Q() {
+        if constexpr (!TConfig::TRACK_Q)
+            return;
+        else if constexpr (TConfig::LAZY_FLAGS) {
+            m_Q_flags = m_flags_modified ? m_pending_flags : 0;
+            m_Q = m_flags_modified ? m_AF.l : 0;
+        } else
+            m_Q = m_flags_modified ? m_AF.l : 0;
+    }
+
     // Arithmetics and logics operations helpers
     uint8_t inc_8bit(uint8_t value) {
         uint8_t result = value + 1;
-        Flags flags(get_F() & Flags::C);
-        flags.update(Flags::S, (result & 0x80) != 0)
-            .update(Flags::Z, result == 0)
-            .update(Flags::H, (value & 0x0F) == 0x0F)
-            .update(Flags::PV, value == 0x7F)
-            .clear(Flags::N)
-            .update(Flags::Y, (result & 0x20) != 0)
-            .update(Flags::X, (result & 0x08) != 0);
-        set_F(flags);
+        set_ALU_flags<FlagsOp::Inc>(get_carry(), value, result);
         return result;
     }
     uint8_t dec_8bit(uint8_t value) {
         uint8_t result = value - 1;
-        Flags flags(get_F() & Flags::C);
-        flags.set(Flags::N)
-            .update(Flags::S, (result & 0x80) != 0)
-            .update(Flags::Z, result == 0)
-            .update(Flags::H, (value & 0x0F) == 0x00)
-            .update(Flags::PV, value == 0x80)
-            .update(Flags::Y, (result & 0x20) != 0)
-            .update(Flags::X, (result & 0x08) != 0);
-        set_F(flags);
+        set_ALU_flags<FlagsOp::Dec>(get_carry(), value, result);
         return result;
     }
     void and_8bit(uint8_t value) {
-        uint8_t result = get_A() & value;
+        uint8_t a = get_A();
+        uint8_t result = a & value;
         set_A(result);
-        Flags flags(Flags::H);
-        flags.update(Flags::S, (result & 0x80) != 0)
-            .update(Flags::Z, result == 0)
-            .update(Flags::PV, is_parity_even(result))
-            .update(Flags::Y, (result & 0x20) != 0)
-            .update(Flags::X, (result & 0x08) != 0);
-        set_F(flags);
+        set_ALU_flags<FlagsOp::And>(a, value, result);
     }
     void or_8bit(uint8_t value) {
-        uint8_t result = get_A() | value;
+        uint8_t a = get_A();
+        uint8_t result = a | value;
         set_A(result);
-        Flags flags(0);
-        flags.update(Flags::S, (result & 0x80) != 0)
-            .update(Flags::Z, result == 0)
-            .update(Flags::PV, is_parity_even(result))
-            .update(Flags::Y, (result & 0x20) != 0)
-            .update(Flags::X, (result & 0x08) != 0);
-        set_F(flags);
+        set_ALU_flags<FlagsOp::OrXor>(a, value, result);
     }
     void xor_8bit(uint8_t value) {
-        uint8_t result = get_A() ^ value;
+        uint8_t a = get_A();
+        uint8_t result = a ^ value;
         set_A(result);
-        Flags flags(0);
-        flags.update(Flags::S, (result & 0x80) != 0)
-            .update(Flags::Z, result == 0)
-            .update(Flags::PV, is_parity_even(result))
-            .update(Flags::Y, (result & 0x20) != 0)
-            .update(Flags::X, (result & 0x08) != 0);
-        set_F(flags);
+        set_ALU_flags<FlagsOp::OrXor>(a, value, result);
     }
     void cp_8bit(uint8_t value) {
         uint8_t a = get_A();
-        uint8_t result = a - value;
-        Flags flags(0);
-        flags.set(Flags::N)
-            .update(Flags::S, (result & 0x80) != 0)
-            .update(Flags::Z, result == 0)
-            .update(Flags::H, (a & 0x0F) < (value & 0x0F))
-            .update(Flags::PV, ((a ^ value) & (a ^ result)) & 0x80)
-            .update(Flags::C, a < value)
-            .update(Flags::X, (value & Flags::X) != 0)
-            .update(Flags::Y, (value & Flags::Y) != 0);
-        set_F(flags);
+        set_ALU_flags<FlagsOp::Cp>(a, value, a - value);
     }
     void add_8bit(uint8_t value) {
         uint8_t a = get_A();
-        uint16_t result16 = (uint16_t)a + (uint16_t)value;
-        uint8_t result = result16 & 0xFF;
+        uint8_t result = a + value;
         set_A(result);
-        Flags flags(0);
-        flags.update(Flags::S, (result & 0x80) != 0)
-            .update(Flags::Z, result == 0)
-            .update(Flags::H, ((a & 0x0F) + (value & 0x0F)) > 0x0F)
-            .update(Flags::PV, ((a ^ value ^ 0x80) & (a ^ result)) & 0x80)
-            .update(Flags::C, result16 > 0xFF)
-            .update(Flags::X, (result & Flags::X) != 0)
-            .update(Flags::Y, (result & Flags::Y) != 0);
-        set_F(flags);
+        set_ALU_flags<FlagsOp::Add>(a, value, result);
     }
     void adc_8bit(uint8_t value) {
         uint8_t a = get_A();
-        Flags flags = get_F();
-        uint8_t carry = flags.is_set(Flags::C);
-        uint16_t result16 = (uint16_t)a + (uint16_t)value + carry;
-        uint8_t result = result16 & 0xFF;
+        uint8_t result = a + value + get_carry();
         set_A(result);
-        flags.zero()
-            .update(Flags::S, (result & 0x80) != 0)
-            .update(Flags::Z, result == 0)
-            .update(Flags::H, ((a & 0x0F) + (value & 0x0F) + carry) > 0x0F)
-            .update(Flags::PV, ((a ^ value ^ 0x80) & (a ^ result)) & 0x80)
-            .update(Flags::C, result16 > 0xFF)
-            .update(Flags::X, (result & Flags::X) != 0)
-            .update(Flags::Y, (result & Flags::Y) != 0);
-        set_F(flags);
+        set_ALU_flags<FlagsOp::Add>(a, value, result);
     }
     void sub_8bit(uint8_t value) {
         uint8_t a = get_A();
         uint8_t result = a - value;
         set_A(result);
-        Flags flags(Flags::N);
-        flags.update(Flags::S, (result & 0x80) != 0)
-            .update(Flags::Z, result == 0)
-            .update(Flags::H, (a & 0x0F) < (value & 0x0F))
-            .update(Flags::PV, ((a ^ value) & (a ^ result)) & 0x80)
-            .update(Flags::C, a < value)
-            .update(Flags::X, (result & Flags::X) != 0)
-            .update(Flags::Y, (result & Flags::Y) != 0);
-        set_F(flags);
+        set_ALU_flags<FlagsOp::Sub>(a, value, result);
     }
     void sbc_8bit(uint8_t value) {
-        Flags flags = get_F();
         uint8_t a = get_A();
-        uint8_t carry = flags.is_set(Flags::C);
-        uint16_t result16 = (uint16_t)a - (uint16_t)value - carry;
-        uint8_t result = result16 & 0xFF;
+        uint8_t result = a - value - get_carry();
         set_A(result);
-        flags.assign(Flags::N)
-            .update(Flags::S, (result & 0x80) != 0)
-            .update(Flags::Z, result == 0)
-            .update(Flags::H, (a & 0x0F) < ((value & 0x0F) + carry))
-            .update(Flags::PV, ((a ^ value) & (a ^ result)) & 0x80)
-            .update(Flags::C, result16 > 0x00FF)
-            .update(Flags::X, (result & Flags::X) != 0)
-            .update(Flags::Y, (result & Flags::Y) != 0);
-        set_F(flags);
+        set_ALU_flags<FlagsOp::Sub>(a, value, result);
     }
     uint16_t add_16bit(uint16_t reg, uint16_t value) {
         uint32_t result32 = (uint32_t)reg + (uint32_t)value;
@@ -1171,100 +1889,42 @@ private:
     }
     uint8_t rlc_8bit(uint8_t value) {
         uint8_t result = (value << 1) | (value >> 7);
-        Flags flags(0);
-        flags.update(Flags::S, (result & 0x80) != 0)
-            .update(Flags::Z, result == 0)
-            .update(Flags::PV, is_parity_even(result))
-            .update(Flags::C, (value & 0x80) != 0)
-            .update(Flags::Y, (result & 0x20) != 0)
-            .update(Flags::X, (result & 0x08) != 0);
-        set_F(flags);
+        set_F(FLAG_TABLES.SZP[result] | (value >> 7));
         return result;
     }
     uint8_t rrc_8bit(uint8_t value) {
         uint8_t result = (value >> 1) | (value << 7);
-        Flags flags(0);
-        flags.update(Flags::S, (result & 0x80) != 0)
-            .update(Flags::Z, result == 0)
-            .update(Flags::PV, is_parity_even(result))
-            .update(Flags::C, (value & 0x01) != 0)
-            .update(Flags::Y, (result & 0x20) != 0)
-            .update(Flags::X, (result & 0x08) != 0);
-        set_F(flags);
+        set_F(FLAG_TABLES.SZP[result] | (value & Flags::C));
         return result;
     }
     uint8_t rl_8bit(uint8_t value) {
-        Flags flags = get_F();
-        uint8_t result = (value << 1) | (flags.is_set(Flags::C) ? 1 : 0);
-        flags.zero()
-            .update(Flags::S, (result & 0x80) != 0)
-            .update(Flags::Z, result == 0)
-            .update(Flags::PV, is_parity_even(result))
-            .update(Flags::C, (value & 0x80) != 0)
-            .update(Flags::Y, (result & 0x20) != 0)
-            .update(Flags::X, (result & 0x08) != 0);
-        set_F(flags);
+        uint8_t result = (value << 1) | get_carry();
+        set_F(FLAG_TABLES.SZP[result] | (value >> 7));
         return result;
     }
     uint8_t rr_8bit(uint8_t value) {
-        Flags flags = get_F();
-        uint8_t result = (value >> 1) | (flags.is_set(Flags::C) ? 0x80 : 0);
-        flags.zero()
-            .update(Flags::S, (result & 0x80) != 0)
-            .update(Flags::Z, result == 0)
-            .update(Flags::PV, is_parity_even(result))
-            .update(Flags::C, (value & 0x01) != 0)
-            .update(Flags::Y, (result & 0x20) != 0)
-            .update(Flags::X, (result & 0x08) != 0);
-        set_F(flags);
+        uint8_t result = (value >> 1) | (get_carry() << 7);
+        set_F(FLAG_TABLES.SZP[result] | (value & Flags::C));
         return result;
     }
     uint8_t sla_8bit(uint8_t value) {
         uint8_t result = value << 1;
-        Flags flags(0);
-        flags.update(Flags::S, (result & 0x80) != 0)
-            .update(Flags::Z, result == 0)
-            .update(Flags::PV, is_parity_even(result))
-            .update(Flags::C, (value & 0x80) != 0)
-            .update(Flags::Y, (result & 0x20) != 0)
-            .update(Flags::X, (result & 0x08) != 0);
-        set_F(flags);
+        set_F(FLAG_TABLES.SZP[result] | (value >> 7));
         return result;
     }
     uint8_t sra_8bit(uint8_t value) {
         uint8_t result = (value >> 1) | (value & 0x80);
-        Flags flags(0);
-        flags.update(Flags::S, (result & 0x80) != 0)
-            .update(Flags::Z, result == 0)
-            .update(Flags::PV, is_parity_even(result))
-            .update(Flags::C, (value & 0x01) != 0)
-            .update(Flags::Y, (result & 0x20) != 0)
-            .update(Flags::X, (result & 0x08) != 0);
-        set_F(flags);
+        set_F(FLAG_TABLES.SZP[result] | (value & Flags::C));
         return result;
     }
     uint8_t sll_8bit(uint8_t value) {
         uint8_t result = (value << 1) | 0x01;
-        Flags flags(0);
-        flags.update(Flags::S, (result & 0x80) != 0)
-            .update(Flags::Z, result == 0)
-            .update(Flags::PV, is_parity_even(result))
-            .update(Flags::C, (value & 0x80) != 0)
-            .update(Flags::Y, (result & 0x20) != 0)
-            .update(Flags::X, (result & 0x08) != 0);
-        set_F(flags);
+        set_F(FLAG_TABLES.SZP[result] | (value >> 7));
         return result;
     }
     uint8_t srl_8bit(uint8_t value) {
         uint8_t result = value >> 1;
-        Flags flags(0);
-        flags.update(Flags::S, (result & 0x80) != 0)
-            .update(Flags::Z, result == 0)
-            .update(Flags::PV, is_parity_even(result))
-            .update(Flags::C, (value & 0x01) != 0)
-            .update(Flags::Y, (result & 0x20) != 0)
-            .update(Flags::X, (result & 0x08) != 0);
-        set_F(flags);
+        set_F(FLAG_TABLES.SZP[result] | (value & Flags::C));
         return result;
     }
     void bit_8bit(uint8_t bit, uint8_t value, bool mem_ptr) {
@@ -1294,7 +1954,7 @@ private:
         uint16_t port = get_BC();
         uint8_t value = io_read(port);
         Flags flags = get_F();
-        set_WZ(port + 1);
+        update_WZ(port + 1);
         flags.update(Flags::S, (value & 0x80) != 0)
             .update(Flags::Z, value == 0)
             .clear(Flags::H | Flags::N)
@@ -1306,7 +1966,20 @@ private:
     }
     void out_c_r(uint8_t value) {
         io_write(get_BC(), value);
-        set_WZ(get_BC() + 1);
+        update_WZ(get_BC() + 1);
+    }
+    // Flags of INI/IND/OUTI/OUTD: `temp` is the transferred value plus C +/- 1 (input) or L (output)
+    void set_IO_block_flags(uint8_t value, uint16_t temp, uint8_t new_b) {
+        Flags flags(0);
+        flags.update(Flags::S, (new_b & 0x80) != 0)
+            .update(Flags::Z, new_b == 0)
+            .update(Flags::C, temp > 0xFF)
+            .update(Flags::H, temp > 0xFF)
+            .update(Flags::PV, is_parity_even(((uint8_t)temp & 0x07) ^ new_b))
+            .update(Flags::N, (value & 0x80) != 0)
+            .update(Flags::X, (new_b & Flags::X) != 0)
+            .update(Flags::Y, (new_b & Flags::Y) != 0);
+        set_F(flags);
     }
     void adjust_flags_after_IO_block() {
         uint16_t pc = get_PC();
@@ -1329,11 +2002,12 @@ private:
     void handle_NMI() {
         if constexpr (!std::is_same_v<TDebugger, StandardDebugger>)
             m_debugger->before_NMI();
+        m_idle_loop.armed = false;
         set_halted(false);
         set_IFF2(get_IFF1());
         set_IFF1(false);
         push_word(get_PC());
-        set_WZ(0x0066);
+        update_WZ(0x0066);
         set_PC(0x0066);
         set_NMI_pending(false);
         add_ticks(4);
@@ -1343,6 +2017,7 @@ private:
     void handle_IRQ() {
         if constexpr (!std::is_same_v<TDebugger, StandardDebugger>)
             m_debugger->before_IRQ();
+        m_idle_loop.armed = false;
         set_halted(false);
         add_ticks(2); // Two wait states during interrupt acknowledge cycle
         set_IFF2(get_IFF1());
@@ -1354,35 +2029,35 @@ private:
             uint8_t opcode = get_IRQ_data();
             switch (opcode) {
             case 0xC7:
-                set_WZ(0x0000);
+                update_WZ(0x0000);
                 set_PC(0x0000);
                 break;
             case 0xCF:
-                set_WZ(0x0008);
+                update_WZ(0x0008);
                 set_PC(0x0008);
                 break;
             case 0xD7:
-                set_WZ(0x0010);
+                update_WZ(0x0010);
                 set_PC(0x0010);
                 break;
             case 0xDF:
-                set_WZ(0x0018);
+                update_WZ(0x0018);
                 set_PC(0x0018);
                 break;
             case 0xE7:
-                set_WZ(0x0020);
+                update_WZ(0x0020);
                 set_PC(0x0020);
                 break;
             case 0xEF:
-                set_WZ(0x0028);
+                update_WZ(0x0028);
                 set_PC(0x0028);
                 break;
             case 0xF7:
-                set_WZ(0x0030);
+                update_WZ(0x0030);
                 set_PC(0x0030);
                 break;
             case 0xFF:
-                set_WZ(0x0038);
+                update_WZ(0x0038);
                 set_PC(0x0038);
                 break;
             }
@@ -1390,7 +2065,7 @@ private:
         }
         case 1: {
             add_ticks(4); // Internal operations for RST 38H
-            set_WZ(0x0038);
+            update_WZ(0x0038);
             set_PC(0x0038);
             break;
         }
@@ -1398,7 +2073,7 @@ private:
             uint16_t vector_address = ((uint16_t)get_I() << 8) | get_IRQ_data();
             uint16_t handler_address = read_word(vector_address);
             add_ticks(4); // Internal operations
-            set_WZ(handler_address);
+            update_WZ(handler_address);
             set_PC(handler_address);
             break;
         }
@@ -1409,191 +2084,108 @@ private:
     }
 
     // Opcodes handling
-    void handle_CB_opcodes(uint8_t opcode) {
-        uint8_t operation_group = opcode >> 6;
-        uint8_t bit = (opcode >> 3) & 0x07;
-        uint8_t target_reg = opcode & 0x07;
-        uint8_t value;
-        uint8_t result = 0;
-        uint16_t flags_source = 0;
-        switch (target_reg) {
-        case 0:
-            value = get_B();
-            break;
-        case 1:
-            value = get_C();
-            break;
-        case 2:
-            value = get_D();
-            break;
-        case 3:
-            value = get_E();
-            break;
-        case 4:
-            value = get_H();
-            break;
-        case 5:
-            value = get_L();
-            break;
-        case 6:
-            flags_source = get_HL();
-            value = read_byte(flags_source);
-            break;
-        case 7:
-            value = get_A();
-            break;
-        }
-        switch (operation_group) {
-        case 0:
-            switch (bit) {
-            case 0:
-                result = rlc_8bit(value);
-                break;
-            case 1:
-                result = rrc_8bit(value);
-                break;
-            case 2:
-                result = rl_8bit(value);
-                break;
-            case 3:
-                result = rr_8bit(value);
-                break;
-            case 4:
-                result = sla_8bit(value);
-                break;
-            case 5:
-                result = sra_8bit(value);
-                break;
-            case 6:
-                result = sll_8bit(value);
-                break;
-            case 7:
-                result = srl_8bit(value);
-                break;
-            }
-            break;
-        case 1: {
-            if (target_reg == 6) {
+    // CB opcodes: the operation group, bit number and register are template arguments taken from the
+    // opcode, so each of the 256 handlers (and 256 DDCB/FDCB ones) is straight-line code.
+    template <uint8_t TReg> uint8_t get_CB_register() const {
+        if constexpr (TReg == 0)
+            return get_B();
+        else if constexpr (TReg == 1)
+            return get_C();
+        else if constexpr (TReg == 2)
+            return get_D();
+        else if constexpr (TReg == 3)
+            return get_E();
+        else if constexpr (TReg == 4)
+            return get_H();
+        else if constexpr (TReg == 5)
+            return get_L();
+        else
+            return get_A();
+    }
+    template <uint8_t TReg> void set_CB_register(uint8_t value) {
+        if constexpr (TReg == 0)
+            set_B(value);
+        else if constexpr (TReg == 1)
+            set_C(value);
+        else if constexpr (TReg == 2)
+            set_D(value);
+        else if constexpr (TReg == 3)
+            set_E(value);
+        else if constexpr (TReg == 4)
+            set_H(value);
+        else if constexpr (TReg == 5)
+            set_L(value);
+        else if constexpr (TReg == 7)
+            set_A(value);
+    }
+    // Rotate/shift (group 0), RES (group 2) or SET (group 3)
+    template <uint8_t TGroup, uint8_t TBit> uint8_t CB_operation(uint8_t value) {
+        if constexpr (TGroup == 2)
+            return res_8bit(TBit, value);
+        else if constexpr (TGroup == 3)
+            return set_8bit(TBit, value);
+        else if constexpr (TBit == 0)
+            return rlc_8bit(value);
+        else if constexpr (TBit == 1)
+            return rrc_8bit(value);
+        else if constexpr (TBit == 2)
+            return rl_8bit(value);
+        else if constexpr (TBit == 3)
+            return rr_8bit(value);
+        else if constexpr (TBit == 4)
+            return sla_8bit(value);
+        else if constexpr (TBit == 5)
+            return sra_8bit(value);
+        else if constexpr (TBit == 6)
+            return sll_8bit(value);
+        else
+            return srl_8bit(value);
+    }
+    template <uint8_t Opcode> void handle_CB_opcode() {
+        constexpr uint8_t group = Opcode >> 6;
+        constexpr uint8_t bit = (Opcode >> 3) & 0x07;
+        constexpr uint8_t reg = Opcode & 0x07;
+        if constexpr (reg == 6) {
+            uint16_t address = get_HL();
+            uint8_t value = read_byte(address);
+            if constexpr (group == 1) {
                 bit_8bit(bit, value, true);
                 add_tick();
-            } else
-                bit_8bit(bit, value, false);
-            return;
-        }
-        case 2:
-            result = res_8bit(bit, value);
-            break;
-        case 3:
-            result = set_8bit(bit, value);
-            break;
-        }
-        switch (target_reg) {
-        case 0:
-            set_B(result);
-            break;
-        case 1:
-            set_C(result);
-            break;
-        case 2:
-            set_D(result);
-            break;
-        case 3:
-            set_E(result);
-            break;
-        case 4:
-            set_H(result);
-            break;
-        case 5:
-            set_L(result);
-            break;
-        case 6:
-            add_tick();
-            write_byte(get_HL(), result);
-            break;
-        case 7:
-            set_A(result);
-            break;
-        }
+            } else {
+                uint8_t result = CB_operation<group, bit>(value);
+                add_tick();
+                write_byte(address, result);
+            }
+        } else if constexpr (group == 1)
+            bit_8bit(bit, get_CB_register<reg>(), false);
+        else
+            set_CB_register<reg>(CB_operation<group, bit>(get_CB_register<reg>()));
     }
-    void handle_CB_indexed_opcodes(uint16_t index_register, int8_t offset, uint8_t opcode) {
+    template <uint8_t Opcode> void handle_CB_indexed_opcode(uint16_t index_register, int8_t offset) {
+        constexpr uint8_t group = Opcode >> 6;
+        constexpr uint8_t bit = (Opcode >> 3) & 0x07;
         uint16_t address = index_register + offset;
-        set_WZ(address);
+        update_WZ(address);
         add_ticks(2); // 2 T-states for address calculation
         uint8_t value = read_byte(address);
-        uint8_t operation_group = opcode >> 6;
-        uint8_t bit = (opcode >> 3) & 0x07;
-        uint8_t result = value;
-        switch (operation_group) {
-        case 0:
-            switch (bit) {
-            case 0:
-                result = rlc_8bit(value);
-                break;
-            case 1:
-                result = rrc_8bit(value);
-                break;
-            case 2:
-                result = rl_8bit(value);
-                break;
-            case 3:
-                result = rr_8bit(value);
-                break;
-            case 4:
-                result = sla_8bit(value);
-                break;
-            case 5:
-                result = sra_8bit(value);
-                break;
-            case 6:
-                result = sll_8bit(value);
-                break;
-            case 7:
-                result = srl_8bit(value);
-                break;
-            }
-            break;
-
-        case 1: {
+        if constexpr (group == 1) {
             bit_8bit(bit, value, true);
             add_tick();
-            return;
-        }
-        case 2:
-            result = res_8bit(bit, value);
-            break;
-        case 3:
-            result = set_8bit(bit, value);
-            break;
-        }
-        add_tick(); // 1 T-state for internal operation
-        write_byte(address, result);
-        uint8_t target_reg_code = opcode & 0x07;
-        if (target_reg_code != 0x06) {
-            switch (target_reg_code) {
-            case 0:
-                set_B(result);
-                break;
-            case 1:
-                set_C(result);
-                break;
-            case 2:
-                set_D(result);
-                break;
-            case 3:
-                set_E(result);
-                break;
-            case 4:
-                set_H(result);
-                break;
-            case 5:
-                set_L(result);
-                break;
-            case 7:
-                set_A(result);
-                break;
-            }
+        } else {
+            uint8_t result = CB_operation<group, bit>(value);
+            add_tick(); // 1 T-state for internal operation
+            write_byte(address, result);
+            set_CB_register<Opcode & 0x07>(result); // Undocumented copy to a register, none for (IX+d)
         }
     }
+    void handle_CB_opcodes(uint8_t opcode) {
+        static constexpr OpcodeTable s_CB_table = make_CB_table(std::make_index_sequence<256>{});
+        (this->*s_CB_table[opcode])();
+    }
+    void handle_CB_indexed_opcodes(uint16_t index_register, int8_t offset, uint8_t opcode) {
+        static constexpr IndexedCBTable s_CB_indexed_table = make_CB_indexed_table(std::make_index_sequence<256>{});
+        (this->*s_CB_indexed_table[opcode])(index_register, offset);
+    }
     void handle_opcode_0x00_NOP() {
     }
     void handle_opcode_0x01_LD_BC_nn() {
@@ -1602,7 +2194,7 @@ private:
     void handle_opcode_0x02_LD_BC_ptr_A() {
         uint16_t address = get_BC();
         write_byte(address, get_A());
-        set_WZ(((uint16_t)get_A() << 8) | ((address + 1) & 0xFF));
+        update_WZ(((uint16_t)get_A() << 8) | ((address + 1) & 0xFF));
     }
     void handle_opcode_0x03_INC_BC() {
         set_BC(get_BC() + 1);
@@ -1634,16 +2226,16 @@ private:
         set_AF(get_AFp());
         set_AFp(temp_AF);
     }
-    void handle_opcode_0x09_ADD_HL_BC() {
+    template <IndexMode TIndex> void handle_opcode_0x09_ADD_HL_BC() {
         add_ticks(7);
-        uint16_t value = get_indexed_HL();
-        set_WZ(value + 1);
-        set_indexed_HL(add_16bit(value, get_BC()));
+        uint16_t value = get_indexed_HL<TIndex>();
+        update_WZ(value + 1);
+        set_indexed_HL<TIndex>(add_16bit(value, get_BC()));
     }
     void handle_opcode_0x0A_LD_A_BC_ptr() {
         uint16_t address = get_BC();
         set_A(read_byte(address));
-        set_WZ(address + 1);
+        update_WZ(address + 1);
     }
     void handle_opcode_0x0B_DEC_BC() {
         set_BC(get_BC() - 1);
@@ -1677,7 +2269,7 @@ private:
         set_B(new_b_value);
         add_tick();
         if (new_b_value != 0) {
-            set_WZ(address);
+            update_WZ(address);
             set_PC(address);
             add_ticks(5);
         }
@@ -1688,7 +2280,7 @@ private:
     void handle_opcode_0x12_LD_DE_ptr_A() {
         uint16_t address = get_DE();
         write_byte(address, get_A());
-        set_WZ(((uint16_t)get_A() << 8) | ((address + 1) & 0xFF));
+        update_WZ(((uint16_t)get_A() << 8) | ((address + 1) & 0xFF));
     }
     void handle_opcode_0x13_INC_DE() {
         set_DE(get_DE() + 1);
@@ -1705,7 +2297,7 @@ private:
     }
     void handle_opcode_0x17_RLA() {
         uint8_t value = get_A();
-        uint8_t old_carry_bit = get_F().is_set(Flags::C) ? 1 : 0;
+        uint8_t old_carry_bit = is_flag_set(Flags::C) ? 1 : 0;
         uint8_t new_carry_bit = (value >> 7) & 0x01;
         uint8_t result = (value << 1) | old_carry_bit;
         set_A(result);
@@ -1719,20 +2311,21 @@ private:
     void handle_opcode_0x18_JR_d() {
         int8_t offset = (int8_t)fetch_next_byte();
         uint16_t address = get_PC() + offset;
-        set_WZ(address);
+        update_WZ(address);
         set_PC(address);
         add_ticks(5);
+        check_idle_loop(address - offset - 2);
     }
-    void handle_opcode_0x19_ADD_HL_DE() {
+    template <IndexMode TIndex> void handle_opcode_0x19_ADD_HL_DE() {
         add_ticks(7);
-        uint16_t value = get_indexed_HL();
-        set_WZ(value + 1);
-        set_indexed_HL(add_16bit(value, get_DE()));
+        uint16_t value = get_indexed_HL<TIndex>();
+        update_WZ(value + 1);
+        set_indexed_HL<TIndex>(add_16bit(value, get_DE()));
     }
     void handle_opcode_0x1A_LD_A_DE_ptr() {
         uint16_t address = get_DE();
         set_A(read_byte(address));
-        set_WZ(address + 1);
+        update_WZ(address + 1);
     }
     void handle_opcode_0x1B_DEC_DE() {
         set_DE(get_DE() - 1);
@@ -1749,7 +2342,7 @@ private:
     }
     void handle_opcode_0x1F_RRA() {
         uint8_t value = get_A();
-        bool old_carry_bit = get_F().is_set(Flags::C);
+        bool old_carry_bit = is_flag_set(Flags::C);
         bool new_carry_bit = (value & 0x01) != 0;
         uint8_t result = (value >> 1) | (old_carry_bit ? 0x80 : 0);
         set_A(result);
@@ -1763,97 +2356,73 @@ private:
     void handle_opcode_0x20_JR_NZ_d() {
         int8_t offset = (int8_t)fetch_next_byte();
         uint16_t address = get_PC() + offset;
-        if (!get_F().is_set(Flags::Z)) {
+        if (!is_flag_set(Flags::Z)) {
             set_PC(address);
-            set_WZ(address);
+            update_WZ(address);
             add_ticks(5);
+            check_idle_loop(address - offset - 2);
         }
     }
-    void handle_opcode_0x21_LD_HL_nn() {
-        set_indexed_HL(fetch_next_word());
+    template <IndexMode TIndex> void handle_opcode_0x21_LD_HL_nn() {
+        set_indexed_HL<TIndex>(fetch_next_word());
     }
-    void handle_opcode_0x22_LD_nn_ptr_HL() {
+    template <IndexMode TIndex> void handle_opcode_0x22_LD_nn_ptr_HL() {
         uint16_t address = fetch_next_word();
-        write_word(address, get_indexed_HL());
-        set_WZ(address + 1);
+        write_word(address, get_indexed_HL<TIndex>());
+        update_WZ(address + 1);
     }
-    void handle_opcode_0x23_INC_HL() {
-        set_indexed_HL(get_indexed_HL() + 1);
+    template <IndexMode TIndex> void handle_opcode_0x23_INC_HL() {
+        set_indexed_HL<TIndex>(get_indexed_HL<TIndex>() + 1);
         add_ticks(2);
     }
-    void handle_opcode_0x24_INC_H() {
-        set_indexed_H(inc_8bit(get_indexed_H()));
+    template <IndexMode TIndex> void handle_opcode_0x24_INC_H() {
+        set_indexed_H<TIndex>(inc_8bit(get_indexed_H<TIndex>()));
     }
-    void handle_opcode_0x25_DEC_H() {
-        set_indexed_H(dec_8bit(get_indexed_H()));
+    template <IndexMode TIndex> void handle_opcode_0x25_DEC_H() {
+        set_indexed_H<TIndex>(dec_8bit(get_indexed_H<TIndex>()));
     }
-    void handle_opcode_0x26_LD_H_n() {
-        set_indexed_H(fetch_next_byte());
+    template <IndexMode TIndex> void handle_opcode_0x26_LD_H_n() {
+        set_indexed_H<TIndex>(fetch_next_byte());
     }
     void handle_opcode_0x27_DAA() {
-        uint8_t a = get_A();
-        uint8_t correction = 0;
-        Flags flags = get_F();
-        bool carry = flags.is_set(Flags::C);
-        if (flags.is_set(Flags::N)) {
-            if (carry || (a > 0x99))
-                correction = 0x60;
-            if (flags.is_set(Flags::H) || ((a & 0x0F) > 0x09))
-                correction |= 0x06;
-            set_A(a - correction);
-            flags.update(Flags::H, flags.is_set(Flags::H) && ((a & 0x0F) < 0x06));
-        } else {
-            if (carry || (a > 0x99)) {
-                correction = 0x60;
-                flags.set(Flags::C);
-            }
-            if (flags.is_set(Flags::H) || ((a & 0x0F) > 0x09))
-                correction |= 0x06;
-            set_A(a + correction);
-            flags.update(Flags::H, (a & 0x0F) > 0x09);
-        }
-        if (correction >= 0x60)
-            flags.set(Flags::C);
-        uint8_t result = get_A();
-        flags.update(Flags::S, (result & 0x80) != 0)
-            .update(Flags::Z, result == 0)
-            .update(Flags::PV, is_parity_even(result))
-            .update(Flags::X, (result & Flags::X) != 0)
-            .update(Flags::Y, (result & Flags::Y) != 0);
-        set_F(flags);
+        uint8_t flags = get_F();
+        uint16_t result = FLAG_TABLES.DAA[get_A() | (flags & (Flags::C | Flags::N)) << 8 | (flags & Flags::H) << 6];
+        set_A(result >> 8);
+        set_F(result & 0xFF);
     }
     void handle_opcode_0x28_JR_Z_d() {
         int8_t offset = (int8_t)fetch_next_byte();
         uint16_t address = get_PC() + offset;
-        if (get_F().is_set(Flags::Z)) {
+        if (is_flag_set(Flags::Z)) {
             set_PC(address);
-            set_WZ(address);
+            update_WZ(address);
             add_ticks(5);
+            check_idle_loop(address - offset - 2);
         }
     }
-    void handle_opcode_0x29_ADD_HL_HL() {
+    template <IndexMode TIndex> void handle_opcode_0x29_ADD_HL_HL() {
         add_ticks(7);
-        uint16_t value = get_indexed_HL();
-        set_WZ(value + 1);
-        set_indexed_HL(add_16bit(value, value));
+        uint16_t value = get_indexed_HL<TIndex>();
+        update_WZ(value + 1);
+        set_indexed_HL<TIndex>(add_16bit(value, value));
     }
-    void handle_opcode_0x2A_LD_HL_nn_ptr() {
+    template <IndexMode TIndex> void handle_opcode_0x2A_LD_HL_nn_ptr() {
         uint16_t address = fetch_next_word();
-        set_indexed_HL(read_word(address));
-        set_WZ(address + 1);
+        set_indexed_HL<TIndex>(read_word(address));
+        update_WZ(address + 1);
     }
-    void handle_opcode_0x2B_DEC_HL() {
-        set_indexed_HL(get_indexed_HL() - 1);
+    template <IndexMode TIndex> void handle_opcode_0x2B_DEC_HL() {
+        set_indexed_HL<TIndex>(get_indexed_HL<TIndex>() - 1);
         add_ticks(2);
     }
-    void handle_opcode_0x2C_INC_L() {
-        set_indexed_L(inc_8bit(get_indexed_L()));
+    template <IndexMode TIndex> void handle_opcode_0x2C_INC_L() {
+        set_indexed_L<TIndex>(inc_8bit(get_indexed_L<TIndex>()));
     }
-    void handle_opcode_0x2D_DEC_L() {
-        set_indexed_L(dec_8bit(get_indexed_L()));
+    template <IndexMode TIndex> void handle_opcode_0x2D_DEC_L() {
+        set_indexed_L<TIndex>(dec_8bit(get_indexed_L<TIndex>()));
     }
-    void handle_opcode_0x2E_LD_L_n() {
-        set_indexed_L(fetch_next_byte());
+    template <IndexMode TIndex> void handle_opcode_0x2E_LD_L_n() {
+        set_indexed_L<TIndex>(fetch_next_byte());
     }
     void handle_opcode_0x2F_CPL() {
         uint8_t result = ~get_A();
@@ -1867,10 +2436,11 @@ private:
     void handle_opcode_0x30_JR_NC_d() {
         int8_t offset = (int8_t)fetch_next_byte();
         uint16_t address = get_PC() + offset;
-        if (!get_F().is_set(Flags::C)) {
+        if (!is_flag_set(Flags::C)) {
             set_PC(address);
-            set_WZ(address);
+            update_WZ(address);
             add_ticks(5);
+            check_idle_loop(address - offset - 2);
         }
     }
     void handle_opcode_0x31_LD_SP_nn() {
@@ -1879,32 +2449,32 @@ private:
     void handle_opcode_0x32_LD_nn_ptr_A() {
         uint16_t address = fetch_next_word();
         write_byte(address, get_A());
-        set_WZ(((uint16_t)get_A() << 8) | ((address + 1) & 0xFF));
+        update_WZ(((uint16_t)get_A() << 8) | ((address + 1) & 0xFF));
     }
     void handle_opcode_0x33_INC_SP() {
         set_SP(get_SP() + 1);
         add_ticks(2);
     }
-    void handle_opcode_0x34_INC_HL_ptr() {
-        uint16_t address = get_indexed_address();
+    template <IndexMode TIndex> void handle_opcode_0x34_INC_HL_ptr() {
+        uint16_t address = get_indexed_address<TIndex>();
         uint8_t value = read_byte(address);
         add_tick();
         write_byte(address, inc_8bit(value));
     }
-    void handle_opcode_0x35_DEC_HL_ptr() {
-        uint16_t address = get_indexed_address();
+    template <IndexMode TIndex> void handle_opcode_0x35_DEC_HL_ptr() {
+        uint16_t address = get_indexed_address<TIndex>();
         uint8_t value = read_byte(address);
         add_tick();
         write_byte(address, dec_8bit(value));
     }
-    void handle_opcode_0x36_LD_HL_ptr_n() {
-        if (get_index_mode() == IndexMode::HL) {
+    template <IndexMode TIndex> void handle_opcode_0x36_LD_HL_ptr_n() {
+        if constexpr (TIndex == IndexMode::HL) {
             uint8_t value = fetch_next_byte();
             write_byte(get_HL(), value);
         } else {
             int8_t offset = (int8_t)fetch_next_byte();
-            uint16_t address = (get_index_mode() == IndexMode::IX ? get_IX() : get_IY()) + offset;
-            set_WZ(address);
+            uint16_t address = get_indexed_HL<TIndex>() + offset;
+            update_WZ(address);
             add_ticks(2);
             uint8_t value = fetch_next_byte();
             write_byte(address, value);
@@ -1924,22 +2494,23 @@ private:
     void handle_opcode_0x38_JR_C_d() {
         int8_t offset = (int8_t)fetch_next_byte();
         uint16_t address = get_PC() + offset;
-        if (get_F().is_set(Flags::C)) {
+        if (is_flag_set(Flags::C)) {
             set_PC(address);
-            set_WZ(address);
+            update_WZ(address);
             add_ticks(5);
+            check_idle_loop(address - offset - 2);
         }
     }
-    void handle_opcode_0x39_ADD_HL_SP() {
+    template <IndexMode TIndex> void handle_opcode_0x39_ADD_HL_SP() {
         add_ticks(7);
-        uint16_t value = get_indexed_HL();
-        set_WZ(value + 1);
-        set_indexed_HL(add_16bit(value, get_SP()));
+        uint16_t value = get_indexed_HL<TIndex>();
+        update_WZ(value + 1);
+        set_indexed_HL<TIndex>(add_16bit(value, get_SP()));
     }
     void handle_opcode_0x3A_LD_A_nn_ptr() {
         uint16_t address = fetch_next_word();
         set_A(read_byte(address));
-        set_WZ(address + 1);
+        update_WZ(address + 1);
     }
     void handle_opcode_0x3B_DEC_SP() {
         set_SP(get_SP() - 1);
@@ -1977,14 +2548,14 @@ private:
     void handle_opcode_0x43_LD_B_E() {
         set_B(get_E());
     }
-    void handle_opcode_0x44_LD_B_H() {
-        set_B(get_indexed_H());
+    template <IndexMode TIndex> void handle_opcode_0x44_LD_B_H() {
+        set_B(get_indexed_H<TIndex>());
     }
-    void handle_opcode_0x45_LD_B_L() {
-        set_B(get_indexed_L());
+    template <IndexMode TIndex> void handle_opcode_0x45_LD_B_L() {
+        set_B(get_indexed_L<TIndex>());
     }
-    void handle_opcode_0x46_LD_B_HL_ptr() {
-        set_B(get_indexed_HL_ptr());
+    template <IndexMode TIndex> void handle_opcode_0x46_LD_B_HL_ptr() {
+        set_B(get_indexed_HL_ptr<TIndex>());
     }
     void handle_opcode_0x47_LD_B_A() {
         set_B(get_A());
@@ -2000,14 +2571,14 @@ private:
     void handle_opcode_0x4B_LD_C_E() {
         set_C(get_E());
     }
-    void handle_opcode_0x4C_LD_C_H() {
-        set_C(get_indexed_H());
+    template <IndexMode TIndex> void handle_opcode_0x4C_LD_C_H() {
+        set_C(get_indexed_H<TIndex>());
     }
-    void handle_opcode_0x4D_LD_C_L() {
-        set_C(get_indexed_L());
+    template <IndexMode TIndex> void handle_opcode_0x4D_LD_C_L() {
+        set_C(get_indexed_L<TIndex>());
     }
-    void handle_opcode_0x4E_LD_C_HL_ptr() {
-        set_C(get_indexed_HL_ptr());
+    template <IndexMode TIndex> void handle_opcode_0x4E_LD_C_HL_ptr() {
+        set_C(get_indexed_HL_ptr<TIndex>());
     }
     void handle_opcode_0x4F_LD_C_A() {
         set_C(get_A());
@@ -2023,14 +2594,14 @@ private:
     void handle_opcode_0x53_LD_D_E() {
         set_D(get_E());
     }
-    void handle_opcode_0x54_LD_D_H() {
-        set_D(get_indexed_H());
+    template <IndexMode TIndex> void handle_opcode_0x54_LD_D_H() {
+        set_D(get_indexed_H<TIndex>());
     }
-    void handle_opcode_0x55_LD_D_L() {
-        set_D(get_indexed_L());
+    template <IndexMode TIndex> void handle_opcode_0x55_LD_D_L() {
+        set_D(get_indexed_L<TIndex>());
     }
-    void handle_opcode_0x56_LD_D_HL_ptr() {
-        set_D(get_indexed_HL_ptr());
+    template <IndexMode TIndex> void handle_opcode_0x56_LD_D_HL_ptr() {
+        set_D(get_indexed_HL_ptr<TIndex>());
     }
     void handle_opcode_0x57_LD_D_A() {
         set_D(get_A());
@@ -2046,87 +2617,87 @@ private:
     }
     void handle_opcode_0x5B_LD_E_E() {
     }
-    void handle_opcode_0x5C_LD_E_H() {
-        set_E(get_indexed_H());
+    template <IndexMode TIndex> void handle_opcode_0x5C_LD_E_H() {
+        set_E(get_indexed_H<TIndex>());
     }
-    void handle_opcode_0x5D_LD_E_L() {
-        set_E(get_indexed_L());
+    template <IndexMode TIndex> void handle_opcode_0x5D_LD_E_L() {
+        set_E(get_indexed_L<TIndex>());
     }
-    void handle_opcode_0x5E_LD_E_HL_ptr() {
-        set_E(get_indexed_HL_ptr());
+    template <IndexMode TIndex> void handle_opcode_0x5E_LD_E_HL_ptr() {
+        set_E(get_indexed_HL_ptr<TIndex>());
     }
     void handle_opcode_0x5F_LD_E_A() {
         set_E(get_A());
     }
-    void handle_opcode_0x60_LD_H_B() {
-        set_indexed_H(get_B());
+    template <IndexMode TIndex> void handle_opcode_0x60_LD_H_B() {
+        set_indexed_H<TIndex>(get_B());
     }
-    void handle_opcode_0x61_LD_H_C() {
-        set_indexed_H(get_C());
+    template <IndexMode TIndex> void handle_opcode_0x61_LD_H_C() {
+        set_indexed_H<TIndex>(get_C());
     }
-    void handle_opcode_0x62_LD_H_D() {
-        set_indexed_H(get_D());
+    template <IndexMode TIndex> void handle_opcode_0x62_LD_H_D() {
+        set_indexed_H<TIndex>(get_D());
     }
-    void handle_opcode_0x63_LD_H_E() {
-        set_indexed_H(get_E());
+    template <IndexMode TIndex> void handle_opcode_0x63_LD_H_E() {
+        set_indexed_H<TIndex>(get_E());
     }
     void handle_opcode_0x64_LD_H_H() {
     }
-    void handle_opcode_0x65_LD_H_L() {
-        set_indexed_H(get_indexed_L());
+    template <IndexMode TIndex> void handle_opcode_0x65_LD_H_L() {
+        set_indexed_H<TIndex>(get_indexed_L<TIndex>());
     }
-    void handle_opcode_0x66_LD_H_HL_ptr() {
-        set_H(get_indexed_HL_ptr());
+    template <IndexMode TIndex> void handle_opcode_0x66_LD_H_HL_ptr() {
+        set_H(get_indexed_HL_ptr<TIndex>());
     }
-    void handle_opcode_0x67_LD_H_A() {
-        set_indexed_H(get_A());
+    template <IndexMode TIndex> void handle_opcode_0x67_LD_H_A() {
+        set_indexed_H<TIndex>(get_A());
     }
-    void handle_opcode_0x68_LD_L_B() {
-        set_indexed_L(get_B());
+    template <IndexMode TIndex> void handle_opcode_0x68_LD_L_B() {
+        set_indexed_L<TIndex>(get_B());
     }
-    void handle_opcode_0x69_LD_L_C() {
-        set_indexed_L(get_C());
+    template <IndexMode TIndex> void handle_opcode_0x69_LD_L_C() {
+        set_indexed_L<TIndex>(get_C());
     }
-    void handle_opcode_0x6A_LD_L_D() {
-        set_indexed_L(get_D());
+    template <IndexMode TIndex> void handle_opcode_0x6A_LD_L_D() {
+        set_indexed_L<TIndex>(get_D());
     }
-    void handle_opcode_0x6B_LD_L_E() {
-        set_indexed_L(get_E());
+    template <IndexMode TIndex> void handle_opcode_0x6B_LD_L_E() {
+        set_indexed_L<TIndex>(get_E());
     }
-    void handle_opcode_0x6C_LD_L_H() {
-        set_indexed_L(get_indexed_H());
+    template <IndexMode TIndex> void handle_opcode_0x6C_LD_L_H() {
+        set_indexed_L<TIndex>(get_indexed_H<TIndex>());
     }
     void handle_opcode_0x6D_LD_L_L() {
     }
-    void handle_opcode_0x6E_LD_L_HL_ptr() {
-        set_L(get_indexed_HL_ptr());
+    template <IndexMode TIndex> void handle_opcode_0x6E_LD_L_HL_ptr() {
+        set_L(get_indexed_HL_ptr<TIndex>());
     }
-    void handle_opcode_0x6F_LD_L_A() {
-        set_indexed_L(get_A());
+    template <IndexMode TIndex> void handle_opcode_0x6F_LD_L_A() {
+        set_indexed_L<TIndex>(get_A());
     }
-    void handle_opcode_0x70_LD_HL_ptr_B() {
-        set_indexed_HL_ptr(get_B());
+    template <IndexMode TIndex> void handle_opcode_0x70_LD_HL_ptr_B() {
+        set_indexed_HL_ptr<TIndex>(get_B());
     }
-    void handle_opcode_0x71_LD_HL_ptr_C() {
-        set_indexed_HL_ptr(get_C());
+    template <IndexMode TIndex> void handle_opcode_0x71_LD_HL_ptr_C() {
+        set_indexed_HL_ptr<TIndex>(get_C());
     }
-    void handle_opcode_0x72_LD_HL_ptr_D() {
-        set_indexed_HL_ptr(get_D());
+    template <IndexMode TIndex> void handle_opcode_0x72_LD_HL_ptr_D() {
+        set_indexed_HL_ptr<TIndex>(get_D());
     }
-    void handle_opcode_0x73_LD_HL_ptr_E() {
-        set_indexed_HL_ptr(get_E());
+    template <IndexMode TIndex> void handle_opcode_0x73_LD_HL_ptr_E() {
+        set_indexed_HL_ptr<TIndex>(get_E());
     }
-    void handle_opcode_0x74_LD_HL_ptr_H() {
-        set_indexed_HL_ptr(get_H());
+    template <IndexMode TIndex> void handle_opcode_0x74_LD_HL_ptr_H() {
+        set_indexed_HL_ptr<TIndex>(get_H());
     }
-    void handle_opcode_0x75_LD_HL_ptr_L() {
-        set_indexed_HL_ptr(get_L());
+    template <IndexMode TIndex> void handle_opcode_0x75_LD_HL_ptr_L() {
+        set_indexed_HL_ptr<TIndex>(get_L());
     }
     void handle_opcode_0x76_HALT() {
         set_halted(true);
     }
-    void handle_opcode_0x77_LD_HL_ptr_A() {
-        set_indexed_HL_ptr(get_A());
+    template <IndexMode TIndex> void handle_opcode_0x77_LD_HL_ptr_A() {
+        set_indexed_HL_ptr<TIndex>(get_A());
     }
     void handle_opcode_0x78_LD_A_B() {
         set_A(get_B());
@@ -2140,14 +2711,14 @@ private:
     void handle_opcode_0x7B_LD_A_E() {
         set_A(get_E());
     }
-    void handle_opcode_0x7C_LD_A_H() {
-        set_A(get_indexed_H());
+    template <IndexMode TIndex> void handle_opcode_0x7C_LD_A_H() {
+        set_A(get_indexed_H<TIndex>());
     }
-    void handle_opcode_0x7D_LD_A_L() {
-        set_A(get_indexed_L());
+    template <IndexMode TIndex> void handle_opcode_0x7D_LD_A_L() {
+        set_A(get_indexed_L<TIndex>());
     }
-    void handle_opcode_0x7E_LD_A_HL_ptr() {
-        set_A(get_indexed_HL_ptr());
+    template <IndexMode TIndex> void handle_opcode_0x7E_LD_A_HL_ptr() {
+        set_A(get_indexed_HL_ptr<TIndex>());
     }
     void handle_opcode_0x7F_LD_A_A() {
     }
@@ -2163,14 +2734,14 @@ private:
     void handle_opcode_0x83_ADD_A_E() {
         add_8bit(get_E());
     }
-    void handle_opcode_0x84_ADD_A_H() {
-        add_8bit(get_indexed_H());
+    template <IndexMode TIndex> void handle_opcode_0x84_ADD_A_H() {
+        add_8bit(get_indexed_H<TIndex>());
     }
-    void handle_opcode_0x85_ADD_A_L() {
-        add_8bit(get_indexed_L());
+    template <IndexMode TIndex> void handle_opcode_0x85_ADD_A_L() {
+        add_8bit(get_indexed_L<TIndex>());
     }
-    void handle_opcode_0x86_ADD_A_HL_ptr() {
-        add_8bit(get_indexed_HL_ptr());
+    template <IndexMode TIndex> void handle_opcode_0x86_ADD_A_HL_ptr() {
+        add_8bit(get_indexed_HL_ptr<TIndex>());
     }
     void handle_opcode_0x87_ADD_A_A() {
         add_8bit(get_A());
@@ -2187,14 +2758,14 @@ private:
     void handle_opcode_0x8B_ADC_A_E() {
         adc_8bit(get_E());
     }
-    void handle_opcode_0x8C_ADC_A_H() {
-        adc_8bit(get_indexed_H());
+    template <IndexMode TIndex> void handle_opcode_0x8C_ADC_A_H() {
+        adc_8bit(get_indexed_H<TIndex>());
     }
-    void handle_opcode_0x8D_ADC_A_L() {
-        adc_8bit(get_indexed_L());
+    template <IndexMode TIndex> void handle_opcode_0x8D_ADC_A_L() {
+        adc_8bit(get_indexed_L<TIndex>());
     }
-    void handle_opcode_0x8E_ADC_A_HL_ptr() {
-        adc_8bit(get_indexed_HL_ptr());
+    template <IndexMode TIndex> void handle_opcode_0x8E_ADC_A_HL_ptr() {
+        adc_8bit(get_indexed_HL_ptr<TIndex>());
     }
     void handle_opcode_0x8F_ADC_A_A() {
         adc_8bit(get_A());
@@ -2211,14 +2782,14 @@ private:
     void handle_opcode_0x93_SUB_E() {
         sub_8bit(get_E());
     }
-    void handle_opcode_0x94_SUB_H() {
-        sub_8bit(get_indexed_H());
+    template <IndexMode TIndex> void handle_opcode_0x94_SUB_H() {
+        sub_8bit(get_indexed_H<TIndex>());
     }
-    void handle_opcode_0x95_SUB_L() {
-        sub_8bit(get_indexed_L());
+    template <IndexMode TIndex> void handle_opcode_0x95_SUB_L() {
+        sub_8bit(get_indexed_L<TIndex>());
     }
-    void handle_opcode_0x96_SUB_HL_ptr() {
-        sub_8bit(get_indexed_HL_ptr());
+    template <IndexMode TIndex> void handle_opcode_0x96_SUB_HL_ptr() {
+        sub_8bit(get_indexed_HL_ptr<TIndex>());
     }
     void handle_opcode_0x97_SUB_A() {
         sub_8bit(get_A());
@@ -2235,14 +2806,14 @@ private:
     void handle_opcode_0x9B_SBC_A_E() {
         sbc_8bit(get_E());
     }
-    void handle_opcode_0x9C_SBC_A_H() {
-        sbc_8bit(get_indexed_H());
+    template <IndexMode TIndex> void handle_opcode_0x9C_SBC_A_H() {
+        sbc_8bit(get_indexed_H<TIndex>());
     }
-    void handle_opcode_0x9D_SBC_A_L() {
-        sbc_8bit(get_indexed_L());
+    template <IndexMode TIndex> void handle_opcode_0x9D_SBC_A_L() {
+        sbc_8bit(get_indexed_L<TIndex>());
     }
-    void handle_opcode_0x9E_SBC_A_HL_ptr() {
-        sbc_8bit(get_indexed_HL_ptr());
+    template <IndexMode TIndex> void handle_opcode_0x9E_SBC_A_HL_ptr() {
+        sbc_8bit(get_indexed_HL_ptr<TIndex>());
     }
     void handle_opcode_0x9F_SBC_A_A() {
         sbc_8bit(get_A());
@@ -2259,14 +2830,14 @@ private:
     void handle_opcode_0xA3_AND_E() {
         and_8bit(get_E());
     }
-    void handle_opcode_0xA4_AND_H() {
-        and_8bit(get_indexed_H());
+    template <IndexMode TIndex> void handle_opcode_0xA4_AND_H() {
+        and_8bit(get_indexed_H<TIndex>());
     }
-    void handle_opcode_0xA5_AND_L() {
-        and_8bit(get_indexed_L());
+    template <IndexMode TIndex> void handle_opcode_0xA5_AND_L() {
+        and_8bit(get_indexed_L<TIndex>());
     }
-    void handle_opcode_0xA6_AND_HL_ptr() {
-        and_8bit(get_indexed_HL_ptr());
+    template <IndexMode TIndex> void handle_opcode_0xA6_AND_HL_ptr() {
+        and_8bit(get_indexed_HL_ptr<TIndex>());
     }
     void handle_opcode_0xA7_AND_A() {
         and_8bit(get_A());
@@ -2283,14 +2854,14 @@ private:
     void handle_opcode_0xAB_XOR_E() {
         xor_8bit(get_E());
     }
-    void handle_opcode_0xAC_XOR_H() {
-        xor_8bit(get_indexed_H());
+    template <IndexMode TIndex> void handle_opcode_0xAC_XOR_H() {
+        xor_8bit(get_indexed_H<TIndex>());
     }
-    void handle_opcode_0xAD_XOR_L() {
-        xor_8bit(get_indexed_L());
+    template <IndexMode TIndex> void handle_opcode_0xAD_XOR_L() {
+        xor_8bit(get_indexed_L<TIndex>());
     }
-    void handle_opcode_0xAE_XOR_HL_ptr() {
-        xor_8bit(get_indexed_HL_ptr());
+    template <IndexMode TIndex> void handle_opcode_0xAE_XOR_HL_ptr() {
+        xor_8bit(get_indexed_HL_ptr<TIndex>());
     }
     void handle_opcode_0xAF_XOR_A() {
         xor_8bit(get_A());
@@ -2307,14 +2878,14 @@ private:
     void handle_opcode_0xB3_OR_E() {
         or_8bit(get_E());
     }
-    void handle_opcode_0xB4_OR_H() {
-        or_8bit(get_indexed_H());
+    template <IndexMode TIndex> void handle_opcode_0xB4_OR_H() {
+        or_8bit(get_indexed_H<TIndex>());
     }
-    void handle_opcode_0xB5_OR_L() {
-        or_8bit(get_indexed_L());
+    template <IndexMode TIndex> void handle_opcode_0xB5_OR_L() {
+        or_8bit(get_indexed_L<TIndex>());
     }
-    void handle_opcode_0xB6_OR_HL_ptr() {
-        or_8bit(get_indexed_HL_ptr());
+    template <IndexMode TIndex> void handle_opcode_0xB6_OR_HL_ptr() {
+        or_8bit(get_indexed_HL_ptr<TIndex>());
     }
     void handle_opcode_0xB7_OR_A() {
         or_8bit(get_A());
@@ -2331,23 +2902,23 @@ private:
     void handle_opcode_0xBB_CP_E() {
         cp_8bit(get_E());
     }
-    void handle_opcode_0xBC_CP_H() {
-        cp_8bit(get_indexed_H());
+    template <IndexMode TIndex> void handle_opcode_0xBC_CP_H() {
+        cp_8bit(get_indexed_H<TIndex>());
     }
-    void handle_opcode_0xBD_CP_L() {
-        cp_8bit(get_indexed_L());
+    template <IndexMode TIndex> void handle_opcode_0xBD_CP_L() {
+        cp_8bit(get_indexed_L<TIndex>());
     }
-    void handle_opcode_0xBE_CP_HL_ptr() {
-        cp_8bit(get_indexed_HL_ptr());
+    template <IndexMode TIndex> void handle_opcode_0xBE_CP_HL_ptr() {
+        cp_8bit(get_indexed_HL_ptr<TIndex>());
     }
     void handle_opcode_0xBF_CP_A() {
         cp_8bit(get_A());
     }
     void handle_opcode_0xC0_RET_NZ() {
         add_tick();
-        if (!get_F().is_set(Flags::Z)) {
+        if (!is_flag_set(Flags::Z)) {
             uint16_t address = pop_word();
-            set_WZ(address);
+            update_WZ(address);
             set_PC(address);
         }
     }
@@ -2356,19 +2927,24 @@ private:
     }
     void handle_opcode_0xC2_JP_NZ_nn() {
         uint16_t address = fetch_next_word();
-        set_WZ(address);
-        if (!get_F().is_set(Flags::Z))
+        update_WZ(address);
+        if (!is_flag_set(Flags::Z)) {
+            uint16_t branch_pc = get_PC() - 3;
             set_PC(address);
+            check_idle_loop(branch_pc);
+        }
     }
     void handle_opcode_0xC3_JP_nn() {
         uint16_t address = fetch_next_word();
-        set_WZ(address);
+        uint16_t branch_pc = get_PC() - 3;
+        update_WZ(address);
         set_PC(address);
+        check_idle_loop(branch_pc);
     }
     void handle_opcode_0xC4_CALL_NZ_nn() {
         uint16_t address = fetch_next_word();
-        set_WZ(address);
-        if (!get_F().is_set(Flags::Z)) {
+        update_WZ(address);
+        if (!is_flag_set(Flags::Z)) {
             push_word(get_PC());
             set_PC(address);
         }
@@ -2381,39 +2957,42 @@ private:
     }
     void handle_opcode_0xC7_RST_00H() {
         push_word(get_PC());
-        set_WZ(0x0000);
+        update_WZ(0x0000);
         set_PC(0x0000);
     }
     void handle_opcode_0xC8_RET_Z() {
         add_tick();
-        if (get_F().is_set(Flags::Z)) {
+        if (is_flag_set(Flags::Z)) {
             uint16_t address = pop_word();
-            set_WZ(address);
+            update_WZ(address);
             set_PC(address);
         }
     }
     void handle_opcode_0xC9_RET() {
         uint16_t address = pop_word();
-        set_WZ(address);
+        update_WZ(address);
         set_PC(address);
     }
     void handle_opcode_0xCA_JP_Z_nn() {
         uint16_t address = fetch_next_word();
-        set_WZ(address);
-        if (get_F().is_set(Flags::Z))
+        update_WZ(address);
+        if (is_flag_set(Flags::Z)) {
+            uint16_t branch_pc = get_PC() - 3;
             set_PC(address);
+            check_idle_loop(branch_pc);
+        }
     }
     void handle_opcode_0xCC_CALL_Z_nn() {
         uint16_t address = fetch_next_word();
-        set_WZ(address);
-        if (get_F().is_set(Flags::Z)) {
+        update_WZ(address);
+        if (is_flag_set(Flags::Z)) {
             push_word(get_PC());
             set_PC(address);
         }
     }
     void handle_opcode_0xCD_CALL_nn() {
         uint16_t address = fetch_next_word();
-        set_WZ(address);
+        update_WZ(address);
         push_word(get_PC());
         set_PC(address);
     }
@@ -2422,14 +3001,14 @@ private:
     }
     void handle_opcode_0xCF_RST_08H() {
         push_word(get_PC());
-        set_WZ(0x0008);
+        update_WZ(0x0008);
         set_PC(0x0008);
     }
     void handle_opcode_0xD0_RET_NC() {
         add_tick();
-        if (!get_F().is_set(Flags::C)) {
+        if (!is_flag_set(Flags::C)) {
             uint16_t address = pop_word();
-            set_WZ(address);
+            update_WZ(address);
             set_PC(address);
         }
     }
@@ -2438,20 +3017,23 @@ private:
     }
     void handle_opcode_0xD2_JP_NC_nn() {
         uint16_t address = fetch_next_word();
-        set_WZ(address);
-        if (!get_F().is_set(Flags::C))
+        update_WZ(address);
+        if (!is_flag_set(Flags::C)) {
+            uint16_t branch_pc = get_PC() - 3;
             set_PC(address);
+            check_idle_loop(branch_pc);
+        }
     }
     void handle_opcode_0xD3_OUT_n_ptr_A() {
         uint8_t port_lo = fetch_next_byte();
         uint16_t port = (get_A() << 8) | port_lo;
         io_write(port, get_A());
-        set_WZ(((uint16_t)get_A() << 8) | ((port_lo + 1) & 0xFF));
+        update_WZ(((uint16_t)get_A() << 8) | ((port_lo + 1) & 0xFF));
     }
     void handle_opcode_0xD4_CALL_NC_nn() {
         uint16_t address = fetch_next_word();
-        set_WZ(address);
-        if (!get_F().is_set(Flags::C)) {
+        update_WZ(address);
+        if (!is_flag_set(Flags::C)) {
             push_word(get_PC());
             set_PC(address);
         }
@@ -2464,14 +3046,14 @@ private:
     }
     void handle_opcode_0xD7_RST_10H() {
         push_word(get_PC());
-        set_WZ(0x0010);
+        update_WZ(0x0010);
         set_PC(0x0010);
     }
     void handle_opcode_0xD8_RET_C() {
         add_tick();
-        if (get_F().is_set(Flags::C)) {
+        if (is_flag_set(Flags::C)) {
             uint16_t address = pop_word();
-            set_WZ(address);
+            update_WZ(address);
             set_PC(address);
         }
     }
@@ -2488,20 +3070,23 @@ private:
     }
     void handle_opcode_0xDA_JP_C_nn() {
         uint16_t address = fetch_next_word();
-        set_WZ(address);
-        if (get_F().is_set(Flags::C))
+        update_WZ(address);
+        if (is_flag_set(Flags::C)) {
+            uint16_t branch_pc = get_PC() - 3;
             set_PC(address);
+            check_idle_loop(branch_pc);
+        }
     }
     void handle_opcode_0xDB_IN_A_n_ptr() {
         uint8_t port_lo = fetch_next_byte();
         uint16_t port = (get_A() << 8) | port_lo;
-        set_WZ(port + 1);
+        update_WZ(port + 1);
         set_A(io_read(port));
     }
     void handle_opcode_0xDC_CALL_C_nn() {
         uint16_t address = fetch_next_word();
-        set_WZ(address);
-        if (get_F().is_set(Flags::C)) {
+        update_WZ(address);
+        if (is_flag_set(Flags::C)) {
             push_word(get_PC());
             set_PC(address);
         }
@@ -2511,69 +3096,75 @@ private:
     }
     void handle_opcode_0xDF_RST_18H() {
         push_word(get_PC());
-        set_WZ(0x0018);
+        update_WZ(0x0018);
         set_PC(0x0018);
     }
     void handle_opcode_0xE0_RET_PO() {
         add_tick();
-        if (!get_F().is_set(Flags::PV)) {
+        if (!is_flag_set(Flags::PV)) {
             uint16_t address = pop_word();
-            set_WZ(address);
+            update_WZ(address);
             set_PC(address);
         }
     }
-    void handle_opcode_0xE1_POP_HL() {
-        set_indexed_HL(pop_word());
+    template <IndexMode TIndex> void handle_opcode_0xE1_POP_HL() {
+        set_indexed_HL<TIndex>(pop_word());
     }
     void handle_opcode_0xE2_JP_PO_nn() {
         uint16_t address = fetch_next_word();
-        set_WZ(address);
-        if (!get_F().is_set(Flags::PV))
+        update_WZ(address);
+        if (!is_flag_set(Flags::PV)) {
+            uint16_t branch_pc = get_PC() - 3;
             set_PC(address);
+            check_idle_loop(branch_pc);
+        }
     }
-    void handle_opcode_0xE3_EX_SP_ptr_HL() {
+    template <IndexMode TIndex> void handle_opcode_0xE3_EX_SP_ptr_HL() {
         uint16_t from_stack = read_word(get_SP());
         add_tick(); // 1 T-state for internal operation
-        set_WZ(from_stack);
-        write_word(get_SP(), get_indexed_HL());
-        set_indexed_HL(from_stack);
+        update_WZ(from_stack);
+        write_word(get_SP(), get_indexed_HL<TIndex>());
+        set_indexed_HL<TIndex>(from_stack);
         add_ticks(2); // 2 T-states for internal operation
     }
     void handle_opcode_0xE4_CALL_PO_nn() {
         uint16_t address = fetch_next_word();
-        set_WZ(address);
-        if (!get_F().is_set(Flags::PV)) {
+        update_WZ(address);
+        if (!is_flag_set(Flags::PV)) {
             push_word(get_PC());
             set_PC(address);
         }
     }
-    void handle_opcode_0xE5_PUSH_HL() {
-        push_word(get_indexed_HL());
+    template <IndexMode TIndex> void handle_opcode_0xE5_PUSH_HL() {
+        push_word(get_indexed_HL<TIndex>());
     }
     void handle_opcode_0xE6_AND_n() {
         and_8bit(fetch_next_byte());
     }
     void handle_opcode_0xE7_RST_20H() {
         push_word(get_PC());
-        set_WZ(0x0020);
+        update_WZ(0x0020);
         set_PC(0x0020);
     }
     void handle_opcode_0xE8_RET_PE() {
         add_tick();
-        if (get_F().is_set(Flags::PV)) {
+        if (is_flag_set(Flags::PV)) {
             uint16_t address = pop_word();
-            set_WZ(address);
+            update_WZ(address);
             set_PC(address);
         }
     }
-    void handle_opcode_0xE9_JP_HL_ptr() {
-        set_PC(get_indexed_HL());
+    template <IndexMode TIndex> void handle_opcode_0xE9_JP_HL_ptr() {
+        set_PC(get_indexed_HL<TIndex>());
     }
     void handle_opcode_0xEA_JP_PE_nn() {
         uint16_t address = fetch_next_word();
-        set_WZ(address);
-        if (get_F().is_set(Flags::PV))
+        update_WZ(address);
+        if (is_flag_set(Flags::PV)) {
+            uint16_t branch_pc = get_PC() - 3;
             set_PC(address);
+            check_idle_loop(branch_pc);
+        }
     }
     void handle_opcode_0xEB_EX_DE_HL() {
         uint16_t temp = get_HL();
@@ -2582,8 +3173,8 @@ private:
     }
     void handle_opcode_0xEC_CALL_PE_nn() {
         uint16_t address = fetch_next_word();
-        set_WZ(address);
-        if (get_F().is_set(Flags::PV)) {
+        update_WZ(address);
+        if (is_flag_set(Flags::PV)) {
             push_word(get_PC());
             set_PC(address);
         }
@@ -2593,14 +3184,14 @@ private:
     }
     void handle_opcode_0xEF_RST_28H() {
         push_word(get_PC());
-        set_WZ(0x0028);
+        update_WZ(0x0028);
         set_PC(0x0028);
     }
     void handle_opcode_0xF0_RET_P() {
         add_tick();
-        if (!get_F().is_set(Flags::S)) {
+        if (!is_flag_set(Flags::S)) {
             uint16_t address = pop_word();
-            set_WZ(address);
+            update_WZ(address);
             set_PC(address);
         }
     }
@@ -2609,9 +3200,12 @@ private:
     }
     void handle_opcode_0xF2_JP_P_nn() {
         uint16_t address = fetch_next_word();
-        set_WZ(address);
-        if (!get_F().is_set(Flags::S))
+        update_WZ(address);
+        if (!is_flag_set(Flags::S)) {
+            uint16_t branch_pc = get_PC() - 3;
             set_PC(address);
+            check_idle_loop(branch_pc);
+        }
     }
     void handle_opcode_0xF3_DI() {
         set_IFF1(false);
@@ -2619,8 +3213,8 @@ private:
     }
     void handle_opcode_0xF4_CALL_P_nn() {
         uint16_t address = fetch_next_word();
-        set_WZ(address);
-        if (!get_F().is_set(Flags::S)) {
+        update_WZ(address);
+        if (!is_flag_set(Flags::S)) {
             push_word(get_PC());
             set_PC(address);
         }
@@ -2633,26 +3227,29 @@ private:
     }
     void handle_opcode_0xF7_RST_30H() {
         push_word(get_PC());
-        set_WZ(0x0030);
+        update_WZ(0x0030);
         set_PC(0x0030);
     }
     void handle_opcode_0xF8_RET_M() {
         add_tick();
-        if (get_F().is_set(Flags::S)) {
+        if (is_flag_set(Flags::S)) {
             uint16_t address = pop_word();
-            set_WZ(address);
+            update_WZ(address);
             set_PC(address);
         }
     }
-    void handle_opcode_0xF9_LD_SP_HL() {
-        set_SP(get_indexed_HL());
+    template <IndexMode TIndex> void handle_opcode_0xF9_LD_SP_HL() {
+        set_SP(get_indexed_HL<TIndex>());
         add_ticks(2);
     }
     void handle_opcode_0xFA_JP_M_nn() {
         uint16_t address = fetch_next_word();
-        set_WZ(address);
-        if (get_F().is_set(Flags::S))
+        update_WZ(address);
+        if (is_flag_set(Flags::S)) {
+            uint16_t branch_pc = get_PC() - 3;
             set_PC(address);
+            check_idle_loop(branch_pc);
+        }
     }
     void handle_opcode_0xFB_EI() {
         set_IFF1(true);
@@ -2661,8 +3258,8 @@ private:
     }
     void handle_opcode_0xFC_CALL_M_nn() {
         uint16_t address = fetch_next_word();
-        set_WZ(address);
-        if (get_F().is_set(Flags::S)) {
+        update_WZ(address);
+        if (is_flag_set(Flags::S)) {
             push_word(get_PC());
             set_PC(address);
         }
@@ -2672,7 +3269,7 @@ private:
     }
     void handle_opcode_0xFF_RST_38H() {
         push_word(get_PC());
-        set_WZ(0x0038);
+        update_WZ(0x0038);
         set_PC(0x0038);
     }
     void handle_opcode_0xED_0x40_IN_B_C_ptr() {
@@ -2684,13 +3281,13 @@ private:
     void handle_opcode_0xED_0x42_SBC_HL_BC() {
         add_ticks(7);
         uint16_t value = get_HL();
-        set_WZ(value + 1);
+        update_WZ(value + 1);
         set_HL(sbc_16bit(value, get_BC()));
     }
     void handle_opcode_0xED_0x43_LD_nn_ptr_BC() {
         uint16_t address = fetch_next_word();
         write_word(address, get_BC());
-        set_WZ(address + 1);
+        update_WZ(address + 1);
     }
     void handle_NEG() {
         uint8_t value = get_A();
@@ -2733,7 +3330,7 @@ private:
     void handle_RETN() {
         set_IFF1(get_IFF2());
         uint16_t address = pop_word();
-        set_WZ(address);
+        update_WZ(address);
         set_PC(address);
     }
     void handle_opcode_0xED_0x45_RETN() {
@@ -2878,21 +3475,21 @@ private:
     void handle_opcode_0xED_0x91_NEXTREG_n_n() {
         uint8_t reg = fetch_next_byte();
         uint8_t val = fetch_next_byte();
-        m_address_bus = PORT_NEXT_REG_SELECT;
-        m_data_bus = reg;
+        update_address_bus(PORT_NEXT_REG_SELECT);
+        update_data_bus(reg);
         m_bus->out(PORT_NEXT_REG_SELECT, reg);
-        m_address_bus = PORT_NEXT_REG_DATA;
-        m_data_bus = val;
+        update_address_bus(PORT_NEXT_REG_DATA);
+        update_data_bus(val);
         m_bus->out(PORT_NEXT_REG_DATA, val);
         add_ticks(3);
     }
     void handle_opcode_0xED_0x92_NEXTREG_n_A() {
         uint8_t reg = fetch_next_byte();
-        m_address_bus = PORT_NEXT_REG_SELECT;
-        m_data_bus = reg;
+        update_address_bus(PORT_NEXT_REG_SELECT);
+        update_data_bus(reg);
         m_bus->out(PORT_NEXT_REG_SELECT, reg);
-        m_address_bus = PORT_NEXT_REG_DATA;
-        m_data_bus = get_A();
+        update_address_bus(PORT_NEXT_REG_DATA);
+        update_data_bus(get_A());
         m_bus->out(PORT_NEXT_REG_DATA, get_A());
         add_ticks(6);
     }
@@ -2962,8 +3559,9 @@ private:
         if (get_BC() != 0) {
             uint16_t new_pc = get_PC() - 2;
             set_PC(new_pc);
-            set_WZ(new_pc + 1);
+            update_WZ(new_pc + 1);
             add_ticks(5);
+            fast_forward_block_copy<BlockCopy::LDIRX>();
         }
     }
     void handle_opcode_0xED_0xB6_LDIRSCALE() {
@@ -2976,7 +3574,7 @@ private:
         if (get_BC() != 0) {
             uint16_t new_pc = get_PC() - 2;
             set_PC(new_pc);
-            set_WZ(new_pc + 1);
+            update_WZ(new_pc + 1);
             add_ticks(5);
         }
         Flags flags = get_F();
@@ -2984,6 +3582,8 @@ private:
              .update(Flags::PV, get_BC() != 0)
              .update(Flags::Z, get_BC() == 0);
         set_F(flags);
+        if (get_BC() != 0)
+            fast_forward_block_copy<BlockCopy::LDIRSCALE>();
     }
     void handle_opcode_0xED_0xB7_LDPIRX() {
         uint8_t val = read_byte(get_HL());
@@ -2999,21 +3599,24 @@ private:
         if (get_BC() != 0) {
             uint16_t new_pc = get_PC() - 2;
             set_PC(new_pc);
-            set_WZ(new_pc + 1);
+            update_WZ(new_pc + 1);
             add_ticks(5);
         }
         Flags flags = get_F();
         flags.clear(Flags::N | Flags::H)
              .update(Flags::PV, get_BC() != 0);
         set_F(flags);
+        if (get_BC() != 0)
+            fast_forward_block_copy<BlockCopy::LDPIRX>();
     }
     void handle_opcode_0xED_0xBC_LDDRX() {
         handle_opcode_0xED_0xAC_LDDX();
         if (get_BC() != 0) {
             uint16_t new_pc = get_PC() - 2;
             set_PC(new_pc);
-            set_WZ(new_pc + 1);
+            update_WZ(new_pc + 1);
             add_ticks(5);
+            fast_forward_block_copy<BlockCopy::LDDRX>();
         }
     }
     void handle_IM_0() {
@@ -3044,19 +3647,19 @@ private:
     void handle_opcode_0xED_0x4A_ADC_HL_BC() {
         add_ticks(7);
         uint16_t value = get_HL();
-        set_WZ(value + 1);
+        update_WZ(value + 1);
         set_HL(adc_16bit(value, get_BC()));
     }
     void handle_opcode_0xED_0x4B_LD_BC_nn_ptr() {
         uint16_t address = fetch_next_word();
         set_BC(read_word(address));
-        set_WZ(address + 1);
+        update_WZ(address + 1);
     }
     void handle_opcode_0xED_0x4D_RETI() {
         set_IFF1(get_IFF2());
         set_RETI_signaled(true);
         uint16_t address = pop_word();
-        set_WZ(address);
+        update_WZ(address);
         set_PC(address);
     }
     void handle_opcode_0xED_0x4F_LD_R_A() {
@@ -3072,13 +3675,13 @@ private:
     void handle_opcode_0xED_0x52_SBC_HL_DE() {
         add_ticks(7);
         uint16_t value = get_HL();
-        set_WZ(value + 1);
+        update_WZ(value + 1);
         set_HL(sbc_16bit(value, get_DE()));
     }
     void handle_opcode_0xED_0x53_LD_nn_ptr_DE() {
         uint16_t address = fetch_next_word();
         write_word(address, get_DE());
-        set_WZ(address + 1);
+        update_WZ(address + 1);
     }
     void handle_IM_1() {
         set_IRQ_mode(1);
@@ -3093,7 +3696,7 @@ private:
         add_tick();
         uint8_t i_value = get_I();
         set_A(i_value);
-        Flags flags(get_F() & Flags::C);
+        Flags flags(get_carry());
         flags.clear(Flags::H | Flags::N)
             .update(Flags::S, (i_value & 0x80) != 0)
             .update(Flags::Z, i_value == 0)
@@ -3111,13 +3714,13 @@ private:
     void handle_opcode_0xED_0x5A_ADC_HL_DE() {
         add_ticks(7);
         uint16_t value = get_HL();
-        set_WZ(value + 1);
+        update_WZ(value + 1);
         set_HL(adc_16bit(value, get_DE()));
     }
     void handle_opcode_0xED_0x5B_LD_DE_nn_ptr() {
         uint16_t address = fetch_next_word();
         set_DE(read_word(address));
-        set_WZ(address + 1);
+        update_WZ(address + 1);
     }
     void handle_IM_2() {
         set_IRQ_mode(2);
@@ -3132,7 +3735,7 @@ private:
         add_tick();
         uint8_t r_value = get_R();
         set_A(r_value);
-        Flags flags(get_F() & Flags::C);
+        Flags flags(get_carry());
         flags.clear(Flags::H | Flags::N)
             .update(Flags::S, (r_value & 0x80) != 0)
             .update(Flags::Z, r_value == 0)
@@ -3150,13 +3753,13 @@ private:
     void handle_opcode_0xED_0x62_SBC_HL_HL() {
         add_ticks(7);
         uint16_t value = get_HL();
-        set_WZ(value + 1);
+        update_WZ(value + 1);
         set_HL(sbc_16bit(value, value));
     }
     void handle_opcode_0xED_0x63_LD_nn_ptr_HL_ED() {
         uint16_t address = fetch_next_word();
         write_word(address, get_HL());
-        set_WZ(address + 1);
+        update_WZ(address + 1);
     }
     void handle_opcode_0xED_0x67_RRD() {
         uint16_t address = get_HL();
@@ -3167,8 +3770,8 @@ private:
         set_A(new_a);
         add_ticks(4);
         write_byte(address, new_mem);
-        set_WZ(address + 1);
-        Flags flags(get_F() & Flags::C);
+        update_WZ(address + 1);
+        Flags flags(get_carry());
         flags.clear(Flags::H | Flags::N)
             .update(Flags::S, (new_a & 0x80) != 0)
             .update(Flags::Z, new_a == 0)
@@ -3186,13 +3789,13 @@ private:
     void handle_opcode_0xED_0x6A_ADC_HL_HL() {
         add_ticks(7);
         uint16_t value = get_HL();
-        set_WZ(value + 1);
+        update_WZ(value + 1);
         set_HL(adc_16bit(value, value));
     }
     void handle_opcode_0xED_0x6B_LD_HL_nn_ptr_ED() {
         uint16_t address = fetch_next_word();
         set_HL(read_word(address));
-        set_WZ(address + 1);
+        update_WZ(address + 1);
     }
     void handle_opcode_0xED_0x6F_RLD() {
         uint16_t address = get_HL();
@@ -3202,9 +3805,9 @@ private:
         uint8_t new_mem = (mem_val << 4) | (a_val & 0x0F);
         set_A(new_a);
         add_ticks(4);
-        set_WZ(address + 1);
+        update_WZ(address + 1);
         write_byte(address, new_mem);
-        Flags flags(get_F() & Flags::C);
+        Flags flags(get_carry());
         flags.clear(Flags::H | Flags::N)
             .update(Flags::S, (new_a & 0x80) != 0)
             .update(Flags::Z, new_a == 0)
@@ -3222,13 +3825,13 @@ private:
     void handle_opcode_0xED_0x72_SBC_HL_SP() {
         add_ticks(7);
         uint16_t value = get_HL();
-        set_WZ(value + 1);
+        update_WZ(value + 1);
         set_HL(sbc_16bit(value, get_SP()));
     }
     void handle_opcode_0xED_0x73_LD_nn_ptr_SP() {
         uint16_t address = fetch_next_word();
         write_word(address, get_SP());
-        set_WZ(address + 1);
+        update_WZ(address + 1);
     }
     void handle_opcode_0xED_0x78_IN_A_C_ptr() {
         set_A(in_r_c());
@@ -3239,13 +3842,13 @@ private:
     void handle_opcode_0xED_0x7A_ADC_HL_SP() {
         add_ticks(7);
         uint16_t value = get_HL();
-        set_WZ(value + 1);
+        update_WZ(value + 1);
         set_HL(adc_16bit(value, get_SP()));
     }
     void handle_opcode_0xED_0x7B_LD_SP_nn_ptr() {
         uint16_t address = fetch_next_word();
         set_SP(read_word(address));
-        set_WZ(address + 1);
+        update_WZ(address + 1);
     }
     void handle_opcode_0xED_0xA0_LDI() {
         uint8_t value = read_byte(get_HL());
@@ -3266,7 +3869,7 @@ private:
     void handle_opcode_0xED_0xA1_CPI() {
         uint8_t value = read_byte(get_HL());
         uint8_t result = get_A() - value;
-        set_WZ(get_WZ() + 1);
+        update_WZ(get_WZ() + 1);
         bool half_carry = (get_A() & 0x0F) < (value & 0x0F);
         set_HL(get_HL() + 1);
         set_BC(get_BC() - 1);
@@ -3284,25 +3887,14 @@ private:
     }
     void handle_opcode_0xED_0xA2_INI() {
         uint8_t port_val = io_read(get_BC());
-        set_WZ(get_BC() + 1);
+        update_WZ(get_BC() + 1);
         uint8_t new_b = get_B() - 1;
         set_B(new_b);
         add_tick(); // 1 T-state for wait cycle
         write_byte(get_HL(), port_val);
         set_HL(get_HL() + 1);
 
-        uint16_t temp = port_val + (uint8_t)(get_C() + 1);
-        Flags flags(0);
-        flags.zero()
-            .update(Flags::S, (new_b & 0x80) != 0)
-            .update(Flags::Z, new_b == 0)
-            .update(Flags::C, temp > 0xFF)
-            .update(Flags::H, temp > 0xFF)
-            .update(Flags::PV, is_parity_even(((temp & 0x07) ^ new_b)))
-            .update(Flags::N, (port_val & 0x80) != 0)
-            .update(Flags::X, (new_b & Flags::X) != 0)
-            .update(Flags::Y, (new_b & Flags::Y) != 0);
-        set_F(flags);
+        set_IO_block_flags(port_val, port_val + (uint8_t)(get_C() + 1), new_b);
     }
     void handle_opcode_0xED_0xA3_OUTI() {
         add_tick(); // 1 T-state for wait cycle
@@ -3311,18 +3903,8 @@ private:
         uint8_t new_b = get_B() - 1;
         set_B(new_b);
         io_write(get_BC(), mem_val);
-        set_WZ(get_BC() + 1);
-        uint16_t temp = (uint16_t)get_L() + mem_val;
-        Flags flags(0);
-        flags.update(Flags::S, (new_b & 0x80) != 0)
-            .update(Flags::Z, new_b == 0)
-            .update(Flags::C, temp > 0xFF)
-            .update(Flags::H, temp > 0xFF)
-            .update(Flags::PV, is_parity_even(((uint8_t)temp & 0x07) ^ new_b))
-            .update(Flags::N, (mem_val & 0x80) != 0)
-            .update(Flags::X, (new_b & Flags::X) != 0)
-            .update(Flags::Y, (new_b & Flags::Y) != 0);
-        set_F(flags);
+        update_WZ(get_BC() + 1);
+        set_IO_block_flags(mem_val, (uint16_t)get_L() + mem_val, new_b);
     }
     void handle_opcode_0xED_0xA8_LDD() {
         uint8_t value = read_byte(get_HL());
@@ -3342,7 +3924,7 @@ private:
     void handle_opcode_0xED_0xA9_CPD() {
         uint8_t value = read_byte(get_HL());
         uint8_t result = get_A() - value;
-        set_WZ(get_WZ() - 1);
+        update_WZ(get_WZ() - 1);
         bool half_carry = (get_A() & 0x0F) < (value & 0x0F);
         set_HL(get_HL() - 1);
         set_BC(get_BC() - 1);
@@ -3361,66 +3943,47 @@ private:
     void handle_opcode_0xED_0xAA_IND() {
         add_tick(); // 1 T-state for wait cycle
         uint8_t port_val = io_read(get_BC());
-        set_WZ(get_BC() - 1);
+        update_WZ(get_BC() - 1);
         uint8_t new_b = get_B() - 1;
         set_B(new_b);
         write_byte(get_HL(), port_val);
         set_HL(get_HL() - 1);
-        uint16_t temp = port_val + (uint8_t)(get_C() - 1);
-        Flags flags(0);
-        flags.update(Flags::S, (new_b & 0x80) != 0)
-            .update(Flags::Z, new_b == 0)
-            .update(Flags::C, temp > 0xFF)
-            .update(Flags::H, temp > 0xFF)
-            .update(Flags::PV, is_parity_even(((uint8_t)temp & 0x07) ^ new_b))
-            .update(Flags::N, (port_val & 0x80) != 0)
-            .update(Flags::X, (new_b & Flags::X) != 0)
-            .update(Flags::Y, (new_b & Flags::Y) != 0);
-        set_F(flags);
+        set_IO_block_flags(port_val, port_val + (uint8_t)(get_C() - 1), new_b);
     }
     void handle_opcode_0xED_0xAB_OUTD() {
         uint8_t mem_val = read_byte(get_HL());
         uint8_t new_b = get_B() - 1;
         set_B(new_b);
         io_write(get_BC(), mem_val);
-        set_WZ(get_BC() - 1);
+        update_WZ(get_BC() - 1);
         set_HL(get_HL() - 1);
         add_tick();
-        uint16_t temp = (uint16_t)get_L() + mem_val;
-        bool carry = temp > 0xFF;
-        Flags flags(0);
-        flags.update(Flags::S, (new_b & 0x80) != 0)
-            .update(Flags::Z, new_b == 0)
-            .update(Flags::H, carry)
-            .update(Flags::PV, is_parity_even(((temp & 0x07) ^ new_b) & 0xFF))
-            .update(Flags::N, (mem_val & 0x80) != 0)
-            .update(Flags::C, carry)
-            .update(Flags::X, (new_b & Flags::X) != 0)
-            .update(Flags::Y, (new_b & Flags::Y) != 0);
-        set_F(flags);
+        set_IO_block_flags(mem_val, (uint16_t)get_L() + mem_val, new_b);
     }
     void handle_opcode_0xED_0xB0_LDIR() {
         handle_opcode_0xED_0xA0_LDI();
         if (get_BC() != 0) {
             uint16_t new_pc = get_PC() - 2;
             set_PC(new_pc);
-            set_WZ(new_pc + 1);
+            update_WZ(new_pc + 1);
             add_ticks(5);
             Flags flags = get_F();
             flags.update(Flags::X, (new_pc & 0x0800) != 0).update(Flags::Y, (new_pc & 0x2000) != 0);
             set_F(flags);
+            fast_forward_block_copy<BlockCopy::LDIR>();
         }
     }
     void handle_opcode_0xED_0xB1_CPIR() {
         handle_opcode_0xED_0xA1_CPI();
-        if (get_BC() != 0 && !get_F().is_set(Flags::Z)) {
+        if (get_BC() != 0 && !is_flag_set(Flags::Z)) {
             uint16_t new_pc = get_PC() - 2;
             set_PC(new_pc);
-            set_WZ(new_pc + 1);
+            update_WZ(new_pc + 1);
             add_ticks(5);
             Flags flags = get_F();
             flags.update(Flags::X, (new_pc & 0x0800) != 0).update(Flags::Y, (new_pc & 0x2000) != 0);
             set_F(flags);
+            fast_forward_block_compare<true>();
         }
     }
     void handle_opcode_0xED_0xB2_INIR() {
@@ -3428,9 +3991,10 @@ private:
         if (get_B() != 0) {
             uint16_t new_pc = get_PC() - 2;
             set_PC(new_pc);
-            set_WZ(new_pc + 1);
+            update_WZ(new_pc + 1);
             adjust_flags_after_IO_block();
             add_ticks(5);
+            fast_forward_block_io<BlockIO::INIR>();
         }
     }
     void handle_opcode_0xED_0xB3_OTIR() {
@@ -3439,8 +4003,9 @@ private:
             add_ticks(5);
             uint16_t new_pc = get_PC() - 2;
             set_PC(new_pc);
-            set_WZ(new_pc + 1);
+            update_WZ(new_pc + 1);
             adjust_flags_after_IO_block();
+            fast_forward_block_io<BlockIO::OTIR>();
         }
     }
     void handle_opcode_0xED_0xB8_LDDR() {
@@ -3448,23 +4013,25 @@ private:
         if (get_BC() != 0) {
             uint16_t new_pc = get_PC() - 2;
             set_PC(new_pc);
-            set_WZ(new_pc + 1);
+            update_WZ(new_pc + 1);
             add_ticks(5);
             Flags flags = get_F();
             flags.update(Flags::X, (new_pc & 0x0800) != 0).update(Flags::Y, (new_pc & 0x2000) != 0);
             set_F(flags);
+            fast_forward_block_copy<BlockCopy::LDDR>();
         }
     }
     void handle_opcode_0xED_0xB9_CPDR() {
         handle_opcode_0xED_0xA9_CPD();
-        if (get_BC() != 0 && !get_F().is_set(Flags::Z)) {
+        if (get_BC() != 0 && !is_flag_set(Flags::Z)) {
             uint16_t new_pc = get_PC() - 2;
             set_PC(new_pc);
-            set_WZ(new_pc + 1);
+            update_WZ(new_pc + 1);
             add_ticks(5);
             Flags flags = get_F();
             flags.update(Flags::X, (new_pc & 0x0800) != 0).update(Flags::Y, (new_pc & 0x2000) != 0);
             set_F(flags);
+            fast_forward_block_compare<false>();
         }
     }
     void handle_opcode_0xED_0xBA_INDR() {
@@ -3473,8 +4040,9 @@ private:
             add_ticks(5);
             uint16_t new_pc = get_PC() - 2;
             set_PC(new_pc);
-            set_WZ(new_pc + 1);
+            update_WZ(new_pc + 1);
             adjust_flags_after_IO_block();
+            fast_forward_block_io<BlockIO::INDR>();
         }
     }
     void handle_opcode_0xED_0xBB_OTDR() {
@@ -3483,1085 +4051,1818 @@ private:
             add_ticks(5);
             uint16_t new_pc = get_PC() - 2;
             set_PC(new_pc);
-            set_WZ(new_pc + 1);
+            update_WZ(new_pc + 1);
             adjust_flags_after_IO_block();
+            fast_forward_block_io<BlockIO::OTDR>();
         }
     }
 
-    // Opcodes processing
-    enum class OperateMode { ToLimit, SingleStep };
-    template <OperateMode TMode> long long operate(long long ticks_limit) {
-        long long initial_ticks = get_ticks();
-        while (true) {
-            if (is_NMI_pending())
-                handle_NMI();
-            else if (is_EI_executed())
-                set_EI_executed(false);
-            else if (is_IRQ_pending())
-                handle_IRQ();
-            if (is_halted()) {
-                if constexpr (TMode == OperateMode::SingleStep)
-                    add_ticks(4);
-                else
-                    add_ticks(ticks_limit - get_ticks());
-            } else {
-                if constexpr (!std::is_same_v<TDebugger, StandardDebugger>) {
-#ifdef Z80_DEBUGGER_OPCODES
-                    m_opcodes.clear();
-#endif // Z80_DEBUGGER_OPCODES
-                    m_debugger->before_step();
-                }
-                set_index_mode(IndexMode::HL);
-                uint8_t opcode = fetch_next_opcode();
-                set_flags_modified(false);
-                while (opcode == 0xDD || opcode == 0xFD) {
-                    set_index_mode((opcode == 0xDD) ? IndexMode::IX : IndexMode::IY);
-                    opcode = fetch_next_opcode();
-                }
-                switch (opcode) {
-                case 0x00:
-                    handle_opcode_0x00_NOP();
-                    break;
-                case 0x01:
-                    handle_opcode_0x01_LD_BC_nn();
-                    break;
-                case 0x02:
-                    handle_opcode_0x02_LD_BC_ptr_A();
-                    break;
-                case 0x03:
-                    handle_opcode_0x03_INC_BC();
-                    break;
-                case 0x04:
-                    handle_opcode_0x04_INC_B();
-                    break;
-                case 0x05:
-                    handle_opcode_0x05_DEC_B();
-                    break;
-                case 0x06:
-                    handle_opcode_0x06_LD_B_n();
-                    break;
-                case 0x07:
-                    handle_opcode_0x07_RLCA();
-                    break;
-                case 0x08:
-                    handle_opcode_0x08_EX_AF_AFp();
-                    break;
-                case 0x09:
-                    handle_opcode_0x09_ADD_HL_BC();
-                    break;
-                case 0x0A:
-                    handle_opcode_0x0A_LD_A_BC_ptr();
-                    break;
-                case 0x0B:
-                    handle_opcode_0x0B_DEC_BC();
-                    break;
-                case 0x0C:
-                    handle_opcode_0x0C_INC_C();
-                    break;
-                case 0x0D:
-                    handle_opcode_0x0D_DEC_C();
-                    break;
-                case 0x0E:
-                    handle_opcode_0x0E_LD_C_n();
-                    break;
-                case 0x0F:
-                    handle_opcode_0x0F_RRCA();
-                    break;
-                case 0x10:
-                    handle_opcode_0x10_DJNZ_d();
-                    break;
-                case 0x11:
-                    handle_opcode_0x11_LD_DE_nn();
-                    break;
-                case 0x12:
-                    handle_opcode_0x12_LD_DE_ptr_A();
-                    break;
-                case 0x13:
-                    handle_opcode_0x13_INC_DE();
-                    break;
-                case 0x14:
-                    handle_opcode_0x14_INC_D();
-                    break;
-                case 0x15:
-                    handle_opcode_0x15_DEC_D();
-                    break;
-                case 0x16:
-                    handle_opcode_0x16_LD_D_n();
-                    break;
-                case 0x17:
-                    handle_opcode_0x17_RLA();
-                    break;
-                case 0x18:
-                    handle_opcode_0x18_JR_d();
-                    break;
-                case 0x19:
-                    handle_opcode_0x19_ADD_HL_DE();
-                    break;
-                case 0x1A:
-                    handle_opcode_0x1A_LD_A_DE_ptr();
-                    break;
-                case 0x1B:
-                    handle_opcode_0x1B_DEC_DE();
-                    break;
-                case 0x1C:
-                    handle_opcode_0x1C_INC_E();
-                    break;
-                case 0x1D:
-                    handle_opcode_0x1D_DEC_E();
-                    break;
-                case 0x1E:
-                    handle_opcode_0x1E_LD_E_n();
-                    break;
-                case 0x1F:
-                    handle_opcode_0x1F_RRA();
-                    break;
-                case 0x20:
-                    handle_opcode_0x20_JR_NZ_d();
-                    break;
-                case 0x21:
-                    handle_opcode_0x21_LD_HL_nn();
-                    break;
-                case 0x22:
-                    handle_opcode_0x22_LD_nn_ptr_HL();
-                    break;
-                case 0x23:
-                    handle_opcode_0x23_INC_HL();
-                    break;
-                case 0x24:
-                    handle_opcode_0x24_INC_H();
-                    break;
-                case 0x25:
-                    handle_opcode_0x25_DEC_H();
-                    break;
-                case 0x26:
-                    handle_opcode_0x26_LD_H_n();
-                    break;
-                case 0x27:
-                    handle_opcode_0x27_DAA();
-                    break;
-                case 0x28:
-                    handle_opcode_0x28_JR_Z_d();
-                    break;
-                case 0x29:
-                    handle_opcode_0x29_ADD_HL_HL();
-                    break;
-                case 0x2A:
-                    handle_opcode_0x2A_LD_HL_nn_ptr();
-                    break;
-                case 0x2B:
-                    handle_opcode_0x2B_DEC_HL();
-                    break;
-                case 0x2C:
-                    handle_opcode_0x2C_INC_L();
-                    break;
-                case 0x2D:
-                    handle_opcode_0x2D_DEC_L();
-                    break;
-                case 0x2E:
-                    handle_opcode_0x2E_LD_L_n();
-                    break;
-                case 0x2F:
-                    handle_opcode_0x2F_CPL();
-                    break;
-                case 0x30:
-                    handle_opcode_0x30_JR_NC_d();
-                    break;
-                case 0x31:
-                    handle_opcode_0x31_LD_SP_nn();
-                    break;
-                case 0x32:
-                    handle_opcode_0x32_LD_nn_ptr_A();
-                    break;
-                case 0x33:
-                    handle_opcode_0x33_INC_SP();
-                    break;
-                case 0x34:
-                    handle_opcode_0x34_INC_HL_ptr();
-                    break;
-                case 0x35:
-                    handle_opcode_0x35_DEC_HL_ptr();
-                    break;
-                case 0x36:
-                    handle_opcode_0x36_LD_HL_ptr_n();
-                    break;
-                case 0x37:
-                    handle_opcode_0x37_SCF();
-                    break;
-                case 0x38:
-                    handle_opcode_0x38_JR_C_d();
-                    break;
-                case 0x39:
-                    handle_opcode_0x39_ADD_HL_SP();
-                    break;
-                case 0x3A:
-                    handle_opcode_0x3A_LD_A_nn_ptr();
-                    break;
-                case 0x3B:
-                    handle_opcode_0x3B_DEC_SP();
-                    break;
-                case 0x3C:
-                    handle_opcode_0x3C_INC_A();
-                    break;
-                case 0x3D:
-                    handle_opcode_0x3D_DEC_A();
-                    break;
-                case 0x3E:
-                    handle_opcode_0x3E_LD_A_n();
-                    break;
-                case 0x3F:
-                    handle_opcode_0x3F_CCF();
-                    break;
-                case 0x40:
-                    handle_opcode_0x40_LD_B_B();
-                    break;
-                case 0x41:
-                    handle_opcode_0x41_LD_B_C();
-                    break;
-                case 0x42:
-                    handle_opcode_0x42_LD_B_D();
-                    break;
-                case 0x43:
-                    handle_opcode_0x43_LD_B_E();
-                    break;
-                case 0x44:
-                    handle_opcode_0x44_LD_B_H();
-                    break;
-                case 0x45:
-                    handle_opcode_0x45_LD_B_L();
-                    break;
-                case 0x46:
-                    handle_opcode_0x46_LD_B_HL_ptr();
-                    break;
-                case 0x47:
-                    handle_opcode_0x47_LD_B_A();
-                    break;
-                case 0x48:
-                    handle_opcode_0x48_LD_C_B();
-                    break;
-                case 0x49:
-                    handle_opcode_0x49_LD_C_C();
-                    break;
-                case 0x4A:
-                    handle_opcode_0x4A_LD_C_D();
-                    break;
-                case 0x4B:
-                    handle_opcode_0x4B_LD_C_E();
-                    break;
-                case 0x4C:
-                    handle_opcode_0x4C_LD_C_H();
-                    break;
-                case 0x4D:
-                    handle_opcode_0x4D_LD_C_L();
-                    break;
-                case 0x4E:
-                    handle_opcode_0x4E_LD_C_HL_ptr();
-                    break;
-                case 0x4F:
-                    handle_opcode_0x4F_LD_C_A();
-                    break;
-                case 0x50:
-                    handle_opcode_0x50_LD_D_B();
-                    break;
-                case 0x51:
-                    handle_opcode_0x51_LD_D_C();
-                    break;
-                case 0x52:
-                    handle_opcode_0x52_LD_D_D();
-                    break;
-                case 0x53:
-                    handle_opcode_0x53_LD_D_E();
-                    break;
-                case 0x54:
-                    handle_opcode_0x54_LD_D_H();
-                    break;
-                case 0x55:
-                    handle_opcode_0x55_LD_D_L();
-                    break;
-                case 0x56:
-                    handle_opcode_0x56_LD_D_HL_ptr();
-                    break;
-                case 0x57:
-                    handle_opcode_0x57_LD_D_A();
-                    break;
-                case 0x58:
-                    handle_opcode_0x58_LD_E_B();
-                    break;
-                case 0x59:
-                    handle_opcode_0x59_LD_E_C();
-                    break;
-                case 0x5A:
-                    handle_opcode_0x5A_LD_E_D();
-                    break;
-                case 0x5B:
-                    handle_opcode_0x5B_LD_E_E();
-                    break;
-                case 0x5C:
-                    handle_opcode_0x5C_LD_E_H();
-                    break;
-                case 0x5D:
-                    handle_opcode_0x5D_LD_E_L();
-                    break;
-                case 0x5E:
-                    handle_opcode_0x5E_LD_E_HL_ptr();
-                    break;
-                case 0x5F:
-                    handle_opcode_0x5F_LD_E_A();
-                    break;
-                case 0x60:
-                    handle_opcode_0x60_LD_H_B();
-                    break;
-                case 0x61:
-                    handle_opcode_0x61_LD_H_C();
-                    break;
-                case 0x62:
-                    handle_opcode_0x62_LD_H_D();
-                    break;
-                case 0x63:
-                    handle_opcode_0x63_LD_H_E();
-                    break;
-                case 0x64:
-                    handle_opcode_0x64_LD_H_H();
-                    break;
-                case 0x65:
-                    handle_opcode_0x65_LD_H_L();
-                    break;
-                case 0x66:
-                    handle_opcode_0x66_LD_H_HL_ptr();
-                    break;
-                case 0x67:
-                    handle_opcode_0x67_LD_H_A();
-                    break;
-                case 0x68:
-                    handle_opcode_0x68_LD_L_B();
-                    break;
-                case 0x69:
-                    handle_opcode_0x69_LD_L_C();
-                    break;
-                case 0x6A:
-                    handle_opcode_0x6A_LD_L_D();
-                    break;
-                case 0x6B:
-                    handle_opcode_0x6B_LD_L_E();
-                    break;
-                case 0x6C:
-                    handle_opcode_0x6C_LD_L_H();
-                    break;
-                case 0x6D:
-                    handle_opcode_0x6D_LD_L_L();
-                    break;
-                case 0x6E:
-                    handle_opcode_0x6E_LD_L_HL_ptr();
-                    break;
-                case 0x6F:
-                    handle_opcode_0x6F_LD_L_A();
-                    break;
-                case 0x70:
-                    handle_opcode_0x70_LD_HL_ptr_B();
-                    break;
-                case 0x71:
-                    handle_opcode_0x71_LD_HL_ptr_C();
-                    break;
-                case 0x72:
-                    handle_opcode_0x72_LD_HL_ptr_D();
-                    break;
-                case 0x73:
-                    handle_opcode_0x73_LD_HL_ptr_E();
-                    break;
-                case 0x74:
-                    handle_opcode_0x74_LD_HL_ptr_H();
-                    break;
-                case 0x75:
-                    handle_opcode_0x75_LD_HL_ptr_L();
-                    break;
-                case 0x76:
-                    handle_opcode_0x76_HALT();
-                    break;
-                case 0x77:
-                    handle_opcode_0x77_LD_HL_ptr_A();
-                    break;
-                case 0x78:
-                    handle_opcode_0x78_LD_A_B();
-                    break;
-                case 0x79:
-                    handle_opcode_0x79_LD_A_C();
-                    break;
-                case 0x7A:
-                    handle_opcode_0x7A_LD_A_D();
-                    break;
-                case 0x7B:
-                    handle_opcode_0x7B_LD_A_E();
-                    break;
-                case 0x7C:
-                    handle_opcode_0x7C_LD_A_H();
-                    break;
-                case 0x7D:
-                    handle_opcode_0x7D_LD_A_L();
-                    break;
-                case 0x7E:
-                    handle_opcode_0x7E_LD_A_HL_ptr();
-                    break;
-                case 0x7F:
-                    handle_opcode_0x7F_LD_A_A();
-                    break;
-                case 0x80:
-                    handle_opcode_0x80_ADD_A_B();
-                    break;
-                case 0x81:
-                    handle_opcode_0x81_ADD_A_C();
-                    break;
-                case 0x82:
-                    handle_opcode_0x82_ADD_A_D();
-                    break;
-                case 0x83:
-                    handle_opcode_0x83_ADD_A_E();
-                    break;
-                case 0x84:
-                    handle_opcode_0x84_ADD_A_H();
-                    break;
-                case 0x85:
-                    handle_opcode_0x85_ADD_A_L();
-                    break;
-                case 0x86:
-                    handle_opcode_0x86_ADD_A_HL_ptr();
-                    break;
-                case 0x87:
-                    handle_opcode_0x87_ADD_A_A();
-                    break;
-                case 0x88:
-                    handle_opcode_0x88_ADC_A_B();
-                    break;
-                case 0x89:
-                    handle_opcode_0x89_ADC_A_C();
-                    break;
-                case 0x8A:
-                    handle_opcode_0x8A_ADC_A_D();
-                    break;
-                case 0x8B:
-                    handle_opcode_0x8B_ADC_A_E();
-                    break;
-                case 0x8C:
-                    handle_opcode_0x8C_ADC_A_H();
-                    break;
-                case 0x8D:
-                    handle_opcode_0x8D_ADC_A_L();
-                    break;
-                case 0x8E:
-                    handle_opcode_0x8E_ADC_A_HL_ptr();
-                    break;
-                case 0x8F:
-                    handle_opcode_0x8F_ADC_A_A();
-                    break;
-                case 0x90:
-                    handle_opcode_0x90_SUB_B();
-                    break;
-                case 0x91:
-                    handle_opcode_0x91_SUB_C();
-                    break;
-                case 0x92:
-                    handle_opcode_0x92_SUB_D();
-                    break;
-                case 0x93:
-                    handle_opcode_0x93_SUB_E();
-                    break;
-                case 0x94:
-                    handle_opcode_0x94_SUB_H();
-                    break;
-                case 0x95:
-                    handle_opcode_0x95_SUB_L();
-                    break;
-                case 0x96:
-                    handle_opcode_0x96_SUB_HL_ptr();
-                    break;
-                case 0x97:
-                    handle_opcode_0x97_SUB_A();
-                    break;
-                case 0x98:
-                    handle_opcode_0x98_SBC_A_B();
-                    break;
-                case 0x99:
-                    handle_opcode_0x99_SBC_A_C();
-                    break;
-                case 0x9A:
-                    handle_opcode_0x9A_SBC_A_D();
-                    break;
-                case 0x9B:
-                    handle_opcode_0x9B_SBC_A_E();
-                    break;
-                case 0x9C:
-                    handle_opcode_0x9C_SBC_A_H();
-                    break;
-                case 0x9D:
-                    handle_opcode_0x9D_SBC_A_L();
-                    break;
-                case 0x9E:
-                    handle_opcode_0x9E_SBC_A_HL_ptr();
-                    break;
-                case 0x9F:
-                    handle_opcode_0x9F_SBC_A_A();
-                    break;
-                case 0xA0:
-                    handle_opcode_0xA0_AND_B();
-                    break;
-                case 0xA1:
-                    handle_opcode_0xA1_AND_C();
-                    break;
-                case 0xA2:
-                    handle_opcode_0xA2_AND_D();
-                    break;
-                case 0xA3:
-                    handle_opcode_0xA3_AND_E();
-                    break;
-                case 0xA4:
-                    handle_opcode_0xA4_AND_H();
-                    break;
-                case 0xA5:
-                    handle_opcode_0xA5_AND_L();
-                    break;
-                case 0xA6:
-                    handle_opcode_0xA6_AND_HL_ptr();
-                    break;
-                case 0xA7:
-                    handle_opcode_0xA7_AND_A();
-                    break;
-                case 0xA8:
-                    handle_opcode_0xA8_XOR_B();
-                    break;
-                case 0xA9:
-                    handle_opcode_0xA9_XOR_C();
-                    break;
-                case 0xAA:
-                    handle_opcode_0xAA_XOR_D();
-                    break;
-                case 0xAB:
-                    handle_opcode_0xAB_XOR_E();
-                    break;
-                case 0xAC:
-                    handle_opcode_0xAC_XOR_H();
-                    break;
-                case 0xAD:
-                    handle_opcode_0xAD_XOR_L();
-                    break;
-                case 0xAE:
-                    handle_opcode_0xAE_XOR_HL_ptr();
-                    break;
-                case 0xAF:
-                    handle_opcode_0xAF_XOR_A();
-                    break;
-                case 0xB0:
-                    handle_opcode_0xB0_OR_B();
-                    break;
-                case 0xB1:
-                    handle_opcode_0xB1_OR_C();
-                    break;
-                case 0xB2:
-                    handle_opcode_0xB2_OR_D();
-                    break;
-                case 0xB3:
-                    handle_opcode_0xB3_OR_E();
-                    break;
-                case 0xB4:
-                    handle_opcode_0xB4_OR_H();
-                    break;
-                case 0xB5:
-                    handle_opcode_0xB5_OR_L();
-                    break;
-                case 0xB6:
-                    handle_opcode_0xB6_OR_HL_ptr();
-                    break;
-                case 0xB7:
-                    handle_opcode_0xB7_OR_A();
-                    break;
-                case 0xB8:
-                    handle_opcode_0xB8_CP_B();
-                    break;
-                case 0xB9:
-                    handle_opcode_0xB9_CP_C();
-                    break;
-                case 0xBA:
-                    handle_opcode_0xBA_CP_D();
-                    break;
-                case 0xBB:
-                    handle_opcode_0xBB_CP_E();
-                    break;
-                case 0xBC:
-                    handle_opcode_0xBC_CP_H();
-                    break;
-                case 0xBD:
-                    handle_opcode_0xBD_CP_L();
-                    break;
-                case 0xBE:
-                    handle_opcode_0xBE_CP_HL_ptr();
-                    break;
-                case 0xBF:
-                    handle_opcode_0xBF_CP_A();
-                    break;
-                case 0xC0:
-                    handle_opcode_0xC0_RET_NZ();
-                    break;
-                case 0xC1:
-                    handle_opcode_0xC1_POP_BC();
-                    break;
-                case 0xC2:
-                    handle_opcode_0xC2_JP_NZ_nn();
-                    break;
-                case 0xC3:
-                    handle_opcode_0xC3_JP_nn();
-                    break;
-                case 0xC4:
-                    handle_opcode_0xC4_CALL_NZ_nn();
-                    break;
-                case 0xC5:
-                    handle_opcode_0xC5_PUSH_BC();
-                    break;
-                case 0xC6:
-                    handle_opcode_0xC6_ADD_A_n();
-                    break;
-                case 0xC7:
-                    handle_opcode_0xC7_RST_00H();
-                    break;
-                case 0xC8:
-                    handle_opcode_0xC8_RET_Z();
-                    break;
-                case 0xC9:
-                    handle_opcode_0xC9_RET();
-                    break;
-                case 0xCA:
-                    handle_opcode_0xCA_JP_Z_nn();
-                    break;
-                case 0xCB:
-                    if (Z80_LIKELY((get_index_mode() == IndexMode::HL))) {
-                        uint8_t cb_opcode = fetch_next_opcode();
-                        handle_CB_opcodes(cb_opcode);
-                    } else { // DDCB d xx or FDCB d xx
-                        uint16_t index_reg = (get_index_mode() == IndexMode::IX) ? get_IX() : get_IY();
-                        int8_t offset = (int8_t)fetch_next_byte();
-                        uint8_t cb_opcode = fetch_next_byte();
-                        handle_CB_indexed_opcodes(index_reg, offset, cb_opcode);
-                    }
-                    break;
-                case 0xCC:
-                    handle_opcode_0xCC_CALL_Z_nn();
-                    break;
-                case 0xCD:
-                    handle_opcode_0xCD_CALL_nn();
-                    break;
-                case 0xCE:
-                    handle_opcode_0xCE_ADC_A_n();
-                    break;
-                case 0xCF:
-                    handle_opcode_0xCF_RST_08H();
-                    break;
-                case 0xD0:
-                    handle_opcode_0xD0_RET_NC();
-                    break;
-                case 0xD1:
-                    handle_opcode_0xD1_POP_DE();
-                    break;
-                case 0xD2:
-                    handle_opcode_0xD2_JP_NC_nn();
-                    break;
-                case 0xD3:
-                    handle_opcode_0xD3_OUT_n_ptr_A();
-                    break;
-                case 0xD4:
-                    handle_opcode_0xD4_CALL_NC_nn();
-                    break;
-                case 0xD5:
-                    handle_opcode_0xD5_PUSH_DE();
-                    break;
-                case 0xD6:
-                    handle_opcode_0xD6_SUB_n();
-                    break;
-                case 0xD7:
-                    handle_opcode_0xD7_RST_10H();
-                    break;
-                case 0xD8:
-                    handle_opcode_0xD8_RET_C();
-                    break;
-                case 0xD9:
-                    handle_opcode_0xD9_EXX();
-                    break;
-                case 0xDA:
-                    handle_opcode_0xDA_JP_C_nn();
-                    break;
-                case 0xDB:
-                    handle_opcode_0xDB_IN_A_n_ptr();
-                    break;
-                case 0xDC:
-                    handle_opcode_0xDC_CALL_C_nn();
-                    break;
-                case 0xDE:
-                    handle_opcode_0xDE_SBC_A_n();
-                    break;
-                case 0xDF:
-                    handle_opcode_0xDF_RST_18H();
-                    break;
-                case 0xE0:
-                    handle_opcode_0xE0_RET_PO();
-                    break;
-                case 0xE1:
-                    handle_opcode_0xE1_POP_HL();
-                    break;
-                case 0xE2:
-                    handle_opcode_0xE2_JP_PO_nn();
-                    break;
-                case 0xE3:
-                    handle_opcode_0xE3_EX_SP_ptr_HL();
-                    break;
-                case 0xE4:
-                    handle_opcode_0xE4_CALL_PO_nn();
-                    break;
-                case 0xE5:
-                    handle_opcode_0xE5_PUSH_HL();
-                    break;
-                case 0xE6:
-                    handle_opcode_0xE6_AND_n();
-                    break;
-                case 0xE7:
-                    handle_opcode_0xE7_RST_20H();
-                    break;
-                case 0xE8:
-                    handle_opcode_0xE8_RET_PE();
-                    break;
-                case 0xE9:
-                    handle_opcode_0xE9_JP_HL_ptr();
-                    break;
-                case 0xEA:
-                    handle_opcode_0xEA_JP_PE_nn();
-                    break;
-                case 0xEB:
-                    handle_opcode_0xEB_EX_DE_HL();
-                    break;
-                case 0xEC:
-                    handle_opcode_0xEC_CALL_PE_nn();
-                    break;
-                case 0xED: {
-                    uint8_t opcodeED = fetch_next_opcode();
-                    set_index_mode(IndexMode::HL);
-                    switch (opcodeED) {
-                    case 0x40:
-                        handle_opcode_0xED_0x40_IN_B_C_ptr();
-                        break;
-                    case 0x41:
-                        handle_opcode_0xED_0x41_OUT_C_ptr_B();
-                        break;
-                    case 0x42:
-                        handle_opcode_0xED_0x42_SBC_HL_BC();
-                        break;
-                    case 0x43:
-                        handle_opcode_0xED_0x43_LD_nn_ptr_BC();
-                        break;
-                    case 0x23: if constexpr (EnableNext) handle_opcode_0xED_0x23_SWAPNIB(); break;
-                    case 0x24: if constexpr (EnableNext) handle_opcode_0xED_0x24_MIRROR(); break;
-                    case 0x27: if constexpr (EnableNext) handle_opcode_0xED_0x27_TEST_n(); break;
-                    case 0x28: if constexpr (EnableNext) handle_opcode_0xED_0x28_BSLA_DE_B(); break;
-                    case 0x29: if constexpr (EnableNext) handle_opcode_0xED_0x29_BSRA_DE_B(); break;
-                    case 0x2A: if constexpr (EnableNext) handle_opcode_0xED_0x2A_BSRL_DE_B(); break;
-                    case 0x2B: if constexpr (EnableNext) handle_opcode_0xED_0x2B_BSRF_DE_B(); break;
-                    case 0x2C: if constexpr (EnableNext) handle_opcode_0xED_0x2C_BRLC_DE_B(); break;
-                    case 0x30: if constexpr (EnableNext) handle_opcode_0xED_0x30_MUL_D_E(); break;
-                    case 0x31: if constexpr (EnableNext) handle_opcode_0xED_0x31_ADD_HL_A(); break;
-                    case 0x32: if constexpr (EnableNext) handle_opcode_0xED_0x32_ADD_DE_A(); break;
-                    case 0x33: if constexpr (EnableNext) handle_opcode_0xED_0x33_ADD_BC_A(); break;
-                    case 0x34: if constexpr (EnableNext) handle_opcode_0xED_0x34_ADD_HL_nn(); break;
-                    case 0x35: if constexpr (EnableNext) handle_opcode_0xED_0x35_ADD_DE_nn(); break;
-                    case 0x36: if constexpr (EnableNext) handle_opcode_0xED_0x36_ADD_BC_nn(); break;
-                    case 0x8A: if constexpr (EnableNext) handle_opcode_0xED_0x8A_PUSH_nn(); break;
-                    case 0x90: if constexpr (EnableNext) handle_opcode_0xED_0x90_OUTINB(); break;
-                    case 0x91: if constexpr (EnableNext) handle_opcode_0xED_0x91_NEXTREG_n_n(); break;
-                    case 0x92: if constexpr (EnableNext) handle_opcode_0xED_0x92_NEXTREG_n_A(); break;
-                    case 0x93: if constexpr (EnableNext) handle_opcode_0xED_0x93_PIXELAD(); break;
-                    case 0x94: if constexpr (EnableNext) handle_opcode_0xED_0x94_PIXELDN(); break;
-                    case 0x95: if constexpr (EnableNext) handle_opcode_0xED_0x95_SETAE(); break;
-                    case 0x98: if constexpr (EnableNext) handle_opcode_0xED_0x98_JP_C(); break;
-                    case 0xA4: if constexpr (EnableNext) handle_opcode_0xED_0xA4_LDIX(); break;
-                    case 0xA5: if constexpr (EnableNext) handle_opcode_0xED_0xA5_LDWS(); break;
-                    case 0xAC: if constexpr (EnableNext) handle_opcode_0xED_0xAC_LDDX(); break;
-                    case 0xB4: if constexpr (EnableNext) handle_opcode_0xED_0xB4_LDIRX(); break;
-                    case 0xB6: if constexpr (EnableNext) handle_opcode_0xED_0xB6_LDIRSCALE(); break;
-                    case 0xB7: if constexpr (EnableNext) handle_opcode_0xED_0xB7_LDPIRX(); break;
-                    case 0xBC: if constexpr (EnableNext) handle_opcode_0xED_0xBC_LDDRX(); break;
-                    case 0x44:
-                        handle_opcode_0xED_0x44_NEG();
-                        break;
-                    case 0x45:
-                        handle_opcode_0xED_0x45_RETN();
-                        break;
-                    case 0x46:
-                        handle_opcode_0xED_0x46_IM_0();
-                        break;
-                    case 0x47:
-                        handle_opcode_0xED_0x47_LD_I_A();
-                        break;
-                    case 0x48:
-                        handle_opcode_0xED_0x48_IN_C_C_ptr();
-                        break;
-                    case 0x49:
-                        handle_opcode_0xED_0x49_OUT_C_ptr_C();
-                        break;
-                    case 0x4A:
-                        handle_opcode_0xED_0x4A_ADC_HL_BC();
-                        break;
-                    case 0x4B:
-                        handle_opcode_0xED_0x4B_LD_BC_nn_ptr();
-                        break;
-                    case 0x4C:
-                        handle_opcode_0xED_0x4C_NEG();
-                        break;
-                    case 0x4D:
-                        handle_opcode_0xED_0x4D_RETI();
-                        break;
-                    case 0x4E:
-                        handle_opcode_0xED_0x4E_IM_0();
-                        break;
-                    case 0x4F:
-                        handle_opcode_0xED_0x4F_LD_R_A();
-                        break;
-                    case 0x50:
-                        handle_opcode_0xED_0x50_IN_D_C_ptr();
-                        break;
-                    case 0x51:
-                        handle_opcode_0xED_0x51_OUT_C_ptr_D();
-                        break;
-                    case 0x52:
-                        handle_opcode_0xED_0x52_SBC_HL_DE();
-                        break;
-                    case 0x53:
-                        handle_opcode_0xED_0x53_LD_nn_ptr_DE();
-                        break;
-                    case 0x54:
-                        handle_opcode_0xED_0x54_NEG();
-                        break;
-                    case 0x55:
-                        handle_opcode_0xED_0x55_RETN();
-                        break;
-                    case 0x56:
-                        handle_opcode_0xED_0x56_IM_1();
-                        break;
-                    case 0x57:
-                        handle_opcode_0xED_0x57_LD_A_I();
-                        break;
-                    case 0x58:
-                        handle_opcode_0xED_0x58_IN_E_C_ptr();
-                        break;
-                    case 0x59:
-                        handle_opcode_0xED_0x59_OUT_C_ptr_E();
-                        break;
-                    case 0x5A:
-                        handle_opcode_0xED_0x5A_ADC_HL_DE();
-                        break;
-                    case 0x5B:
-                        handle_opcode_0xED_0x5B_LD_DE_nn_ptr();
-                        break;
-                    case 0x5C:
-                        handle_opcode_0xED_0x5C_NEG();
-                        break;
-                    case 0x5D:
-                        handle_opcode_0xED_0x5D_RETN();
-                        break;
-                    case 0x5E:
-                        handle_opcode_0xED_0x5E_IM_2();
-                        break;
-                    case 0x5F:
-                        handle_opcode_0xED_0x5F_LD_A_R();
-                        break;
-                    case 0x60:
-                        handle_opcode_0xED_0x60_IN_H_C_ptr();
-                        break;
-                    case 0x61:
-                        handle_opcode_0xED_0x61_OUT_C_ptr_H();
-                        break;
-                    case 0x62:
-                        handle_opcode_0xED_0x62_SBC_HL_HL();
-                        break;
-                    case 0x63:
-                        handle_opcode_0xED_0x63_LD_nn_ptr_HL_ED();
-                        break;
-                    case 0x64:
-                        handle_opcode_0xED_0x64_NEG();
-                        break;
-                    case 0x65:
-                        handle_opcode_0xED_0x65_RETN();
-                        break;
-                    case 0x66:
-                        handle_opcode_0xED_0x66_IM_0();
-                        break;
-                    case 0x67:
-                        handle_opcode_0xED_0x67_RRD();
-                        break;
-                    case 0x68:
-                        handle_opcode_0xED_0x68_IN_L_C_ptr();
-                        break;
-                    case 0x69:
-                        handle_opcode_0xED_0x69_OUT_C_ptr_L();
-                        break;
-                    case 0x6A:
-                        handle_opcode_0xED_0x6A_ADC_HL_HL();
-                        break;
-                    case 0x6B:
-                        handle_opcode_0xED_0x6B_LD_HL_nn_ptr_ED();
-                        break;
-                    case 0x6C:
-                        handle_opcode_0xED_0x6C_NEG();
-                        break;
-                    case 0x6D:
-                        handle_opcode_0xED_0x6D_RETN();
-                        break;
-                    case 0x6E:
-                        handle_opcode_0xED_0x6E_IM_0();
-                        break;
-                    case 0x6F:
-                        handle_opcode_0xED_0x6F_RLD();
-                        break;
-                    case 0x70:
-                        handle_opcode_0xED_0x70_IN_C_ptr();
-                        break;
-                    case 0x71:
-                        handle_opcode_0xED_0x71_OUT_C_ptr_0();
-                        break;
-                    case 0x72:
-                        handle_opcode_0xED_0x72_SBC_HL_SP();
-                        break;
-                    case 0x73:
-                        handle_opcode_0xED_0x73_LD_nn_ptr_SP();
-                        break;
-                    case 0x74:
-                        handle_opcode_0xED_0x74_NEG();
-                        break;
-                    case 0x75:
-                        handle_opcode_0xED_0x75_RETN();
-                        break;
-                    case 0x76:
-                        handle_opcode_0xED_0x76_IM_1();
-                        break;
-                    case 0x78:
-                        handle_opcode_0xED_0x78_IN_A_C_ptr();
-                        break;
-                    case 0x79:
-                        handle_opcode_0xED_0x79_OUT_C_ptr_A();
-                        break;
-                    case 0x7A:
-                        handle_opcode_0xED_0x7A_ADC_HL_SP();
-                        break;
-                    case 0x7B:
-                        handle_opcode_0xED_0x7B_LD_SP_nn_ptr();
-                        break;
-                    case 0x7C:
-                        handle_opcode_0xED_0x7C_NEG();
-                        break;
-                    case 0x7D:
-                        handle_opcode_0xED_0x7D_RETN();
-                        break;
-                    case 0x7E:
-                        handle_opcode_0xED_0x7E_IM_2();
-                        break;
-                    case 0xA0:
-                        handle_opcode_0xED_0xA0_LDI();
-                        break;
-                    case 0xA1:
-                        handle_opcode_0xED_0xA1_CPI();
-                        break;
-                    case 0xA2:
-                        handle_opcode_0xED_0xA2_INI();
-                        break;
-                    case 0xA3:
-                        handle_opcode_0xED_0xA3_OUTI();
-                        break;
-                    case 0xA8:
-                        handle_opcode_0xED_0xA8_LDD();
-                        break;
-                    case 0xA9:
-                        handle_opcode_0xED_0xA9_CPD();
-                        break;
-                    case 0xAA:
-                        handle_opcode_0xED_0xAA_IND();
-                        break;
-                    case 0xAB:
-                        handle_opcode_0xED_0xAB_OUTD();
-                        break;
-                    case 0xB0:
-                        handle_opcode_0xED_0xB0_LDIR();
-                        break;
-                    case 0xB1:
-                        handle_opcode_0xED_0xB1_CPIR();
-                        break;
-                    case 0xB2:
-                        handle_opcode_0xED_0xB2_INIR();
-                        break;
-                    case 0xB3:
-                        handle_opcode_0xED_0xB3_OTIR();
-                        break;
-                    case 0xB8:
-                        handle_opcode_0xED_0xB8_LDDR();
-                        break;
-                    case 0xB9:
-                        handle_opcode_0xED_0xB9_CPDR();
-                        break;
-                    case 0xBA:
-                        handle_opcode_0xED_0xBA_INDR();
-                        break;
-                    case 0xBB:
-                        handle_opcode_0xED_0xBB_OTDR();
-                        break;
-                    }
-                    break;
-                }
-                case 0xEE:
-                    handle_opcode_0xEE_XOR_n();
-                    break;
-                case 0xEF:
-                    handle_opcode_0xEF_RST_28H();
-                    break;
-                case 0xF0:
-                    handle_opcode_0xF0_RET_P();
-                    break;
-                case 0xF1:
-                    handle_opcode_0xF1_POP_AF();
-                    break;
-                case 0xF2:
-                    handle_opcode_0xF2_JP_P_nn();
-                    break;
-                case 0xF3:
-                    handle_opcode_0xF3_DI();
-                    break;
-                case 0xF4:
-                    handle_opcode_0xF4_CALL_P_nn();
-                    break;
-                case 0xF5:
-                    handle_opcode_0xF5_PUSH_AF();
-                    break;
-                case 0xF6:
-                    handle_opcode_0xF6_OR_n();
-                    break;
-                case 0xF7:
-                    handle_opcode_0xF7_RST_30H();
-                    break;
-                case 0xF8:
-                    handle_opcode_0xF8_RET_M();
-                    break;
-                case 0xF9:
-                    handle_opcode_0xF9_LD_SP_HL();
-                    break;
-                case 0xFA:
-                    handle_opcode_0xFA_JP_M_nn();
-                    break;
-                case 0xFB:
-                    handle_opcode_0xFB_EI();
-                    break;
-                case 0xFC:
-                    handle_opcode_0xFC_CALL_M_nn();
-                    break;
-                case 0xFE:
-                    handle_opcode_0xFE_CP_n();
-                    break;
-                case 0xFF:
-                    handle_opcode_0xFF_RST_38H();
+    // Dispatch tables
+    using OpcodeHandler = void (CPU::*)();
+    using IndexedCBHandler = void (CPU::*)(uint16_t, int8_t);
+    using OpcodeTable = std::array<OpcodeHandler, 256>;
+    using IndexedCBTable = std::array<IndexedCBHandler, 256>;
+    template <IndexMode TIndex> static constexpr OpcodeTable make_main_table() {
+        OpcodeTable table{};
+        table[0x00] = &CPU::handle_opcode_0x00_NOP;
+        table[0x01] = &CPU::handle_opcode_0x01_LD_BC_nn;
+        table[0x02] = &CPU::handle_opcode_0x02_LD_BC_ptr_A;
+        table[0x03] = &CPU::handle_opcode_0x03_INC_BC;
+        table[0x04] = &CPU::handle_opcode_0x04_INC_B;
+        table[0x05] = &CPU::handle_opcode_0x05_DEC_B;
+        table[0x06] = &CPU::handle_opcode_0x06_LD_B_n;
+        table[0x07] = &CPU::handle_opcode_0x07_RLCA;
+        table[0x08] = &CPU::handle_opcode_0x08_EX_AF_AFp;
+        table[0x09] = &CPU::handle_opcode_0x09_ADD_HL_BC<TIndex>;
+        table[0x0A] = &CPU::handle_opcode_0x0A_LD_A_BC_ptr;
+        table[0x0B] = &CPU::handle_opcode_0x0B_DEC_BC;
+        table[0x0C] = &CPU::handle_opcode_0x0C_INC_C;
+        table[0x0D] = &CPU::handle_opcode_0x0D_DEC_C;
+        table[0x0E] = &CPU::handle_opcode_0x0E_LD_C_n;
+        table[0x0F] = &CPU::handle_opcode_0x0F_RRCA;
+        table[0x10] = &CPU::handle_opcode_0x10_DJNZ_d;
+        table[0x11] = &CPU::handle_opcode_0x11_LD_DE_nn;
+        table[0x12] = &CPU::handle_opcode_0x12_LD_DE_ptr_A;
+        table[0x13] = &CPU::handle_opcode_0x13_INC_DE;
+        table[0x14] = &CPU::handle_opcode_0x14_INC_D;
+        table[0x15] = &CPU::handle_opcode_0x15_DEC_D;
+        table[0x16] = &CPU::handle_opcode_0x16_LD_D_n;
+        table[0x17] = &CPU::handle_opcode_0x17_RLA;
+        table[0x18] = &CPU::handle_opcode_0x18_JR_d;
+        table[0x19] = &CPU::handle_opcode_0x19_ADD_HL_DE<TIndex>;
+        table[0x1A] = &CPU::handle_opcode_0x1A_LD_A_DE_ptr;
+        table[0x1B] = &CPU::handle_opcode_0x1B_DEC_DE;
+        table[0x1C] = &CPU::handle_opcode_0x1C_INC_E;
+        table[0x1D] = &CPU::handle_opcode_0x1D_DEC_E;
+        table[0x1E] = &CPU::handle_opcode_0x1E_LD_E_n;
+        table[0x1F] = &CPU::handle_opcode_0x1F_RRA;
+        table[0x20] = &CPU::handle_opcode_0x20_JR_NZ_d;
+        table[0x21] = &CPU::handle_opcode_0x21_LD_HL_nn<TIndex>;
+        table[0x22] = &CPU::handle_opcode_0x22_LD_nn_ptr_HL<TIndex>;
+        table[0x23] = &CPU::handle_opcode_0x23_INC_HL<TIndex>;
+        table[0x24] = &CPU::handle_opcode_0x24_INC_H<TIndex>;
+        table[0x25] = &CPU::handle_opcode_0x25_DEC_H<TIndex>;
+        table[0x26] = &CPU::handle_opcode_0x26_LD_H_n<TIndex>;
+        table[0x27] = &CPU::handle_opcode_0x27_DAA;
+        table[0x28] = &CPU::handle_opcode_0x28_JR_Z_d;
+        table[0x29] = &CPU::handle_opcode_0x29_ADD_HL_HL<TIndex>;
+        table[0x2A] = &CPU::handle_opcode_0x2A_LD_HL_nn_ptr<TIndex>;
+        table[0x2B] = &CPU::handle_opcode_0x2B_DEC_HL<TIndex>;
+        table[0x2C] = &CPU::handle_opcode_0x2C_INC_L<TIndex>;
+        table[0x2D] = &CPU::handle_opcode_0x2D_DEC_L<TIndex>;
+        table[0x2E] = &CPU::handle_opcode_0x2E_LD_L_n<TIndex>;
+        table[0x2F] = &CPU::handle_opcode_0x2F_CPL;
+        table[0x30] = &CPU::handle_opcode_0x30_JR_NC_d;
+        table[0x31] = &CPU::handle_opcode_0x31_LD_SP_nn;
+        table[0x32] = &CPU::handle_opcode_0x32_LD_nn_ptr_A;
+        table[0x33] = &CPU::handle_opcode_0x33_INC_SP;
+        table[0x34] = &CPU::handle_opcode_0x34_INC_HL_ptr<TIndex>;
+        table[0x35] = &CPU::handle_opcode_0x35_DEC_HL_ptr<TIndex>;
+        table[0x36] = &CPU::handle_opcode_0x36_LD_HL_ptr_n<TIndex>;
+        table[0x37] = &CPU::handle_opcode_0x37_SCF;
+        table[0x38] = &CPU::handle_opcode_0x38_JR_C_d;
+        table[0x39] = &CPU::handle_opcode_0x39_ADD_HL_SP<TIndex>;
+        table[0x3A] = &CPU::handle_opcode_0x3A_LD_A_nn_ptr;
+        table[0x3B] = &CPU::handle_opcode_0x3B_DEC_SP;
+        table[0x3C] = &CPU::handle_opcode_0x3C_INC_A;
+        table[0x3D] = &CPU::handle_opcode_0x3D_DEC_A;
+        table[0x3E] = &CPU::handle_opcode_0x3E_LD_A_n;
+        table[0x3F] = &CPU::handle_opcode_0x3F_CCF;
+        table[0x40] = &CPU::handle_opcode_0x40_LD_B_B;
+        table[0x41] = &CPU::handle_opcode_0x41_LD_B_C;
+        table[0x42] = &CPU::handle_opcode_0x42_LD_B_D;
+        table[0x43] = &CPU::handle_opcode_0x43_LD_B_E;
+        table[0x44] = &CPU::handle_opcode_0x44_LD_B_H<TIndex>;
+        table[0x45] = &CPU::handle_opcode_0x45_LD_B_L<TIndex>;
+        table[0x46] = &CPU::handle_opcode_0x46_LD_B_HL_ptr<TIndex>;
+        table[0x47] = &CPU::handle_opcode_0x47_LD_B_A;
+        table[0x48] = &CPU::handle_opcode_0x48_LD_C_B;
+        table[0x49] = &CPU::handle_opcode_0x49_LD_C_C;
+        table[0x4A] = &CPU::handle_opcode_0x4A_LD_C_D;
+        table[0x4B] = &CPU::handle_opcode_0x4B_LD_C_E;
+        table[0x4C] = &CPU::handle_opcode_0x4C_LD_C_H<TIndex>;
+        table[0x4D] = &CPU::handle_opcode_0x4D_LD_C_L<TIndex>;
+        table[0x4E] = &CPU::handle_opcode_0x4E_LD_C_HL_ptr<TIndex>;
+        table[0x4F] = &CPU::handle_opcode_0x4F_LD_C_A;
+        table[0x50] = &CPU::handle_opcode_0x50_LD_D_B;
+        table[0x51] = &CPU::handle_opcode_0x51_LD_D_C;
+        table[0x52] = &CPU::handle_opcode_0x52_LD_D_D;
+        table[0x53] = &CPU::handle_opcode_0x53_LD_D_E;
+        table[0x54] = &CPU::handle_opcode_0x54_LD_D_H<TIndex>;
+        table[0x55] = &CPU::handle_opcode_0x55_LD_D_L<TIndex>;
+        table[0x56] = &CPU::handle_opcode_0x56_LD_D_HL_ptr<TIndex>;
+        table[0x57] = &CPU::handle_opcode_0x57_LD_D_A;
+        table[0x58] = &CPU::handle_opcode_0x58_LD_E_B;
+        table[0x59] = &CPU::handle_opcode_0x59_LD_E_C;
+        table[0x5A] = &CPU::handle_opcode_0x5A_LD_E_D;
+        table[0x5B] = &CPU::handle_opcode_0x5B_LD_E_E;
+        table[0x5C] = &CPU::handle_opcode_0x5C_LD_E_H<TIndex>;
+        table[0x5D] = &CPU::handle_opcode_0x5D_LD_E_L<TIndex>;
+        table[0x5E] = &CPU::handle_opcode_0x5E_LD_E_HL_ptr<TIndex>;
+        table[0x5F] = &CPU::handle_opcode_0x5F_LD_E_A;
+        table[0x60] = &CPU::handle_opcode_0x60_LD_H_B<TIndex>;
+        table[0x61] = &CPU::handle_opcode_0x61_LD_H_C<TIndex>;
+        table[0x62] = &CPU::handle_opcode_0x62_LD_H_D<TIndex>;
+        table[0x63] = &CPU::handle_opcode_0x63_LD_H_E<TIndex>;
+        table[0x64] = &CPU::handle_opcode_0x64_LD_H_H;
+        table[0x65] = &CPU::handle_opcode_0x65_LD_H_L<TIndex>;
+        table[0x66] = &CPU::handle_opcode_0x66_LD_H_HL_ptr<TIndex>;
+        table[0x67] = &CPU::handle_opcode_0x67_LD_H_A<TIndex>;
+        table[0x68] = &CPU::handle_opcode_0x68_LD_L_B<TIndex>;
+        table[0x69] = &CPU::handle_opcode_0x69_LD_L_C<TIndex>;
+        table[0x6A] = &CPU::handle_opcode_0x6A_LD_L_D<TIndex>;
+        table[0x6B] = &CPU::handle_opcode_0x6B_LD_L_E<TIndex>;
+        table[0x6C] = &CPU::handle_opcode_0x6C_LD_L_H<TIndex>;
+        table[0x6D] = &CPU::handle_opcode_0x6D_LD_L_L;
+        table[0x6E] = &CPU::handle_opcode_0x6E_LD_L_HL_ptr<TIndex>;
+        table[0x6F] = &CPU::handle_opcode_0x6F_LD_L_A<TIndex>;
+        table[0x70] = &CPU::handle_opcode_0x70_LD_HL_ptr_B<TIndex>;
+        table[0x71] = &CPU::handle_opcode_0x71_LD_HL_ptr_C<TIndex>;
+        table[0x72] = &CPU::handle_opcode_0x72_LD_HL_ptr_D<TIndex>;
+        table[0x73] = &CPU::handle_opcode_0x73_LD_HL_ptr_E<TIndex>;
+        table[0x74] = &CPU::handle_opcode_0x74_LD_HL_ptr_H<TIndex>;
+        table[0x75] = &CPU::handle_opcode_0x75_LD_HL_ptr_L<TIndex>;
+        table[0x76] = &CPU::handle_opcode_0x76_HALT;
+        table[0x77] = &CPU::handle_opcode_0x77_LD_HL_ptr_A<TIndex>;
+        table[0x78] = &CPU::handle_opcode_0x78_LD_A_B;
+        table[0x79] = &CPU::handle_opcode_0x79_LD_A_C;
+        table[0x7A] = &CPU::handle_opcode_0x7A_LD_A_D;
+        table[0x7B] = &CPU::handle_opcode_0x7B_LD_A_E;
+        table[0x7C] = &CPU::handle_opcode_0x7C_LD_A_H<TIndex>;
+        table[0x7D] = &CPU::handle_opcode_0x7D_LD_A_L<TIndex>;
+        table[0x7E] = &CPU::handle_opcode_0x7E_LD_A_HL_ptr<TIndex>;
+        table[0x7F] = &CPU::handle_opcode_0x7F_LD_A_A;
+        table[0x80] = &CPU::handle_opcode_0x80_ADD_A_B;
+        table[0x81] = &CPU::handle_opcode_0x81_ADD_A_C;
+        table[0x82] = &CPU::handle_opcode_0x82_ADD_A_D;
+        table[0x83] = &CPU::handle_opcode_0x83_ADD_A_E;
+        table[0x84] = &CPU::handle_opcode_0x84_ADD_A_H<TIndex>;
+        table[0x85] = &CPU::handle_opcode_0x85_ADD_A_L<TIndex>;
+        table[0x86] = &CPU::handle_opcode_0x86_ADD_A_HL_ptr<TIndex>;
+        table[0x87] = &CPU::handle_opcode_0x87_ADD_A_A;
+        table[0x88] = &CPU::handle_opcode_0x88_ADC_A_B;
+        table[0x89] = &CPU::handle_opcode_0x89_ADC_A_C;
+        table[0x8A] = &CPU::handle_opcode_0x8A_ADC_A_D;
+        table[0x8B] = &CPU::handle_opcode_0x8B_ADC_A_E;
+        table[0x8C] = &CPU::handle_opcode_0x8C_ADC_A_H<TIndex>;
+        table[0x8D] = &CPU::handle_opcode_0x8D_ADC_A_L<TIndex>;
+        table[0x8E] = &CPU::handle_opcode_0x8E_ADC_A_HL_ptr<TIndex>;
+        table[0x8F] = &CPU::handle_opcode_0x8F_ADC_A_A;
+        table[0x90] = &CPU::handle_opcode_0x90_SUB_B;
+        table[0x91] = &CPU::handle_opcode_0x91_SUB_C;
+        table[0x92] = &CPU::handle_opcode_0x92_SUB_D;
+        table[0x93] = &CPU::handle_opcode_0x93_SUB_E;
+        table[0x94] = &CPU::handle_opcode_0x94_SUB_H<TIndex>;
+        table[0x95] = &CPU::handle_opcode_0x95_SUB_L<TIndex>;
+        table[0x96] = &CPU::handle_opcode_0x96_SUB_HL_ptr<TIndex>;
+        table[0x97] = &CPU::handle_opcode_0x97_SUB_A;
+        table[0x98] = &CPU::handle_opcode_0x98_SBC_A_B;
+        table[0x99] = &CPU::handle_opcode_0x99_SBC_A_C;
+        table[0x9A] = &CPU::handle_opcode_0x9A_SBC_A_D;
+        table[0x9B] = &CPU::handle_opcode_0x9B_SBC_A_E;
+        table[0x9C] = &CPU::handle_opcode_0x9C_SBC_A_H<TIndex>;
+        table[0x9D] = &CPU::handle_opcode_0x9D_SBC_A_L<TIndex>;
+        table[0x9E] = &CPU::handle_opcode_0x9E_SBC_A_HL_ptr<TIndex>;
+        table[0x9F] = &CPU::handle_opcode_0x9F_SBC_A_A;
+        table[0xA0] = &CPU::handle_opcode_0xA0_AND_B;
+        table[0xA1] = &CPU::handle_opcode_0xA1_AND_C;
+        table[0xA2] = &CPU::handle_opcode_0xA2_AND_D;
+        table[0xA3] = &CPU::handle_opcode_0xA3_AND_E;
+        table[0xA4] = &CPU::handle_opcode_0xA4_AND_H<TIndex>;
+        table[0xA5] = &CPU::handle_opcode_0xA5_AND_L<TIndex>;
+        table[0xA6] = &CPU::handle_opcode_0xA6_AND_HL_ptr<TIndex>;
+        table[0xA7] = &CPU::handle_opcode_0xA7_AND_A;
+        table[0xA8] = &CPU::handle_opcode_0xA8_XOR_B;
+        table[0xA9] = &CPU::handle_opcode_0xA9_XOR_C;
+        table[0xAA] = &CPU::handle_opcode_0xAA_XOR_D;
+        table[0xAB] = &CPU::handle_opcode_0xAB_XOR_E;
+        table[0xAC] = &CPU::handle_opcode_0xAC_XOR_H<TIndex>;
+        table[0xAD] = &CPU::handle_opcode_0xAD_XOR_L<TIndex>;
+        table[0xAE] = &CPU::handle_opcode_0xAE_XOR_HL_ptr<TIndex>;
+        table[0xAF] = &CPU::handle_opcode_0xAF_XOR_A;
+        table[0xB0] = &CPU::handle_opcode_0xB0_OR_B;
+        table[0xB1] = &CPU::handle_opcode_0xB1_OR_C;
+        table[0xB2] = &CPU::handle_opcode_0xB2_OR_D;
+        table[0xB3] = &CPU::handle_opcode_0xB3_OR_E;
+        table[0xB4] = &CPU::handle_opcode_0xB4_OR_H<TIndex>;
+        table[0xB5] = &CPU::handle_opcode_0xB5_OR_L<TIndex>;
+        table[0xB6] = &CPU::handle_opcode_0xB6_OR_HL_ptr<TIndex>;
+        table[0xB7] = &CPU::handle_opcode_0xB7_OR_A;
+        table[0xB8] = &CPU::handle_opcode_0xB8_CP_B;
+        table[0xB9] = &CPU::handle_opcode_0xB9_CP_C;
+        table[0xBA] = &CPU::handle_opcode_0xBA_CP_D;
+        table[0xBB] = &CPU::handle_opcode_0xBB_CP_E;
+        table[0xBC] = &CPU::handle_opcode_0xBC_CP_H<TIndex>;
+        table[0xBD] = &CPU::handle_opcode_0xBD_CP_L<TIndex>;
+        table[0xBE] = &CPU::handle_opcode_0xBE_CP_HL_ptr<TIndex>;
+        table[0xBF] = &CPU::handle_opcode_0xBF_CP_A;
+        table[0xC0] = &CPU::handle_opcode_0xC0_RET_NZ;
+        table[0xC1] = &CPU::handle_opcode_0xC1_POP_BC;
+        table[0xC2] = &CPU::handle_opcode_0xC2_JP_NZ_nn;
+        table[0xC3] = &CPU::handle_opcode_0xC3_JP_nn;
+        table[0xC4] = &CPU::handle_opcode_0xC4_CALL_NZ_nn;
+        table[0xC5] = &CPU::handle_opcode_0xC5_PUSH_BC;
+        table[0xC6] = &CPU::handle_opcode_0xC6_ADD_A_n;
+        table[0xC7] = &CPU::handle_opcode_0xC7_RST_00H;
+        table[0xC8] = &CPU::handle_opcode_0xC8_RET_Z;
+        table[0xC9] = &CPU::handle_opcode_0xC9_RET;
+        table[0xCA] = &CPU::handle_opcode_0xCA_JP_Z_nn;
+        table[0xCB] = &CPU::handle_opcode_0xCB_prefix<TIndex>;
+        table[0xCC] = &CPU::handle_opcode_0xCC_CALL_Z_nn;
+        table[0xCD] = &CPU::handle_opcode_0xCD_CALL_nn;
+        table[0xCE] = &CPU::handle_opcode_0xCE_ADC_A_n;
+        table[0xCF] = &CPU::handle_opcode_0xCF_RST_08H;
+        table[0xD0] = &CPU::handle_opcode_0xD0_RET_NC;
+        table[0xD1] = &CPU::handle_opcode_0xD1_POP_DE;
+        table[0xD2] = &CPU::handle_opcode_0xD2_JP_NC_nn;
+        table[0xD3] = &CPU::handle_opcode_0xD3_OUT_n_ptr_A;
+        table[0xD4] = &CPU::handle_opcode_0xD4_CALL_NC_nn;
+        table[0xD5] = &CPU::handle_opcode_0xD5_PUSH_DE;
+        table[0xD6] = &CPU::handle_opcode_0xD6_SUB_n;
+        table[0xD7] = &CPU::handle_opcode_0xD7_RST_10H;
+        table[0xD8] = &CPU::handle_opcode_0xD8_RET_C;
+        table[0xD9] = &CPU::handle_opcode_0xD9_EXX;
+        table[0xDA] = &CPU::handle_opcode_0xDA_JP_C_nn;
+        table[0xDB] = &CPU::handle_opcode_0xDB_IN_A_n_ptr;
+        table[0xDC] = &CPU::handle_opcode_0xDC_CALL_C_nn;
+        table[0xDD] = &CPU::handle_opcode_0xDD_prefix;
+        table[0xDE] = &CPU::handle_opcode_0xDE_SBC_A_n;
+        table[0xDF] = &CPU::handle_opcode_0xDF_RST_18H;
+        table[0xE0] = &CPU::handle_opcode_0xE0_RET_PO;
+        table[0xE1] = &CPU::handle_opcode_0xE1_POP_HL<TIndex>;
+        table[0xE2] = &CPU::handle_opcode_0xE2_JP_PO_nn;
+        table[0xE3] = &CPU::handle_opcode_0xE3_EX_SP_ptr_HL<TIndex>;
+        table[0xE4] = &CPU::handle_opcode_0xE4_CALL_PO_nn;
+        table[0xE5] = &CPU::handle_opcode_0xE5_PUSH_HL<TIndex>;
+        table[0xE6] = &CPU::handle_opcode_0xE6_AND_n;
+        table[0xE7] = &CPU::handle_opcode_0xE7_RST_20H;
+        table[0xE8] = &CPU::handle_opcode_0xE8_RET_PE;
+        table[0xE9] = &CPU::handle_opcode_0xE9_JP_HL_ptr<TIndex>;
+        table[0xEA] = &CPU::handle_opcode_0xEA_JP_PE_nn;
+        table[0xEB] = &CPU::handle_opcode_0xEB_EX_DE_HL;
+        table[0xEC] = &CPU::handle_opcode_0xEC_CALL_PE_nn;
+        table[0xED] = &CPU::handle_opcode_0xED_prefix;
+        table[0xEE] = &CPU::handle_opcode_0xEE_XOR_n;
+        table[0xEF] = &CPU::handle_opcode_0xEF_RST_28H;
+        table[0xF0] = &CPU::handle_opcode_0xF0_RET_P;
+        table[0xF1] = &CPU::handle_opcode_0xF1_POP_AF;
+        table[0xF2] = &CPU::handle_opcode_0xF2_JP_P_nn;
+        table[0xF3] = &CPU::handle_opcode_0xF3_DI;
+        table[0xF4] = &CPU::handle_opcode_0xF4_CALL_P_nn;
+        table[0xF5] = &CPU::handle_opcode_0xF5_PUSH_AF;
+        table[0xF6] = &CPU::handle_opcode_0xF6_OR_n;
+        table[0xF7] = &CPU::handle_opcode_0xF7_RST_30H;
+        table[0xF8] = &CPU::handle_opcode_0xF8_RET_M;
+        table[0xF9] = &CPU::handle_opcode_0xF9_LD_SP_HL<TIndex>;
+        table[0xFA] = &CPU::handle_opcode_0xFA_JP_M_nn;
+        table[0xFB] = &CPU::handle_opcode_0xFB_EI;
+        table[0xFC] = &CPU::handle_opcode_0xFC_CALL_M_nn;
+        table[0xFD] = &CPU::handle_opcode_0xFD_prefix;
+        table[0xFE] = &CPU::handle_opcode_0xFE_CP_n;
+        table[0xFF] = &CPU::handle_opcode_0xFF_RST_38H;
+        return table;
+    }
+    static constexpr OpcodeTable make_ED_table() {
+        OpcodeTable table{};
+        for (auto& handler : table)
+            handler = &CPU::handle_opcode_0x00_NOP;
+        table[0x40] = &CPU::handle_opcode_0xED_0x40_IN_B_C_ptr;
+        table[0x41] = &CPU::handle_opcode_0xED_0x41_OUT_C_ptr_B;
+        table[0x42] = &CPU::handle_opcode_0xED_0x42_SBC_HL_BC;
+        table[0x43] = &CPU::handle_opcode_0xED_0x43_LD_nn_ptr_BC;
+        table[0x44] = &CPU::handle_opcode_0xED_0x44_NEG;
+        table[0x45] = &CPU::handle_opcode_0xED_0x45_RETN;
+        table[0x46] = &CPU::handle_opcode_0xED_0x46_IM_0;
+        table[0x47] = &CPU::handle_opcode_0xED_0x47_LD_I_A;
+        table[0x48] = &CPU::handle_opcode_0xED_0x48_IN_C_C_ptr;
+        table[0x49] = &CPU::handle_opcode_0xED_0x49_OUT_C_ptr_C;
+        table[0x4A] = &CPU::handle_opcode_0xED_0x4A_ADC_HL_BC;
+        table[0x4B] = &CPU::handle_opcode_0xED_0x4B_LD_BC_nn_ptr;
+        table[0x4C] = &CPU::handle_opcode_0xED_0x4C_NEG;
+        table[0x4D] = &CPU::handle_opcode_0xED_0x4D_RETI;
+        table[0x4E] = &CPU::handle_opcode_0xED_0x4E_IM_0;
+        table[0x4F] = &CPU::handle_opcode_0xED_0x4F_LD_R_A;
+        table[0x50] = &CPU::handle_opcode_0xED_0x50_IN_D_C_ptr;
+        table[0x51] = &CPU::handle_opcode_0xED_0x51_OUT_C_ptr_D;
+        table[0x52] = &CPU::handle_opcode_0xED_0x52_SBC_HL_DE;
+        table[0x53] = &CPU::handle_opcode_0xED_0x53_LD_nn_ptr_DE;
+        table[0x54] = &CPU::handle_opcode_0xED_0x54_NEG;
+        table[0x55] = &CPU::handle_opcode_0xED_0x55_RETN;
+        table[0x56] = &CPU::handle_opcode_0xED_0x56_IM_1;
+        table[0x57] = &CPU::handle_opcode_0xED_0x57_LD_A_I;
+        table[0x58] = &CPU::handle_opcode_0xED_0x58_IN_E_C_ptr;
+        table[0x59] = &CPU::handle_opcode_0xED_0x59_OUT_C_ptr_E;
+        table[0x5A] = &CPU::handle_opcode_0xED_0x5A_ADC_HL_DE;
+        table[0x5B] = &CPU::handle_opcode_0xED_0x5B_LD_DE_nn_ptr;
+        table[0x5C] = &CPU::handle_opcode_0xED_0x5C_NEG;
+        table[0x5D] = &CPU::handle_opcode_0xED_0x5D_RETN;
+        table[0x5E] = &CPU::handle_opcode_0xED_0x5E_IM_2;
+        table[0x5F] = &CPU::handle_opcode_0xED_0x5F_LD_A_R;
+        table[0x60] = &CPU::handle_opcode_0xED_0x60_IN_H_C_ptr;
+        table[0x61] = &CPU::handle_opcode_0xED_0x61_OUT_C_ptr_H;
+        table[0x62] = &CPU::handle_opcode_0xED_0x62_SBC_HL_HL;
+        table[0x63] = &CPU::handle_opcode_0xED_0x63_LD_nn_ptr_HL_ED;
+        table[0x64] = &CPU::handle_opcode_0xED_0x64_NEG;
+        table[0x65] = &CPU::handle_opcode_0xED_0x65_RETN;
+        table[0x66] = &CPU::handle_opcode_0xED_0x66_IM_0;
+        table[0x67] = &CPU::handle_opcode_0xED_0x67_RRD;
+        table[0x68] = &CPU::handle_opcode_0xED_0x68_IN_L_C_ptr;
+        table[0x69] = &CPU::handle_opcode_0xED_0x69_OUT_C_ptr_L;
+        table[0x6A] = &CPU::handle_opcode_0xED_0x6A_ADC_HL_HL;
+        table[0x6B] = &CPU::handle_opcode_0xED_0x6B_LD_HL_nn_ptr_ED;
+        table[0x6C] = &CPU::handle_opcode_0xED_0x6C_NEG;
+        table[0x6D] = &CPU::handle_opcode_0xED_0x6D_RETN;
+        table[0x6E] = &CPU::handle_opcode_0xED_0x6E_IM_0;
+        table[0x6F] = &CPU::handle_opcode_0xED_0x6F_RLD;
+        table[0x70] = &CPU::handle_opcode_0xED_0x70_IN_C_ptr;
+        table[0x71] = &CPU::handle_opcode_0xED_0x71_OUT_C_ptr_0;
+        table[0x72] = &CPU::handle_opcode_0xED_0x72_SBC_HL_SP;
+        table[0x73] = &CPU::handle_opcode_0xED_0x73_LD_nn_ptr_SP;
+        table[0x74] = &CPU::handle_opcode_0xED_0x74_NEG;
+        table[0x75] = &CPU::handle_opcode_0xED_0x75_RETN;
+        table[0x76] = &CPU::handle_opcode_0xED_0x76_IM_1;
+        table[0x78] = &CPU::handle_opcode_0xED_0x78_IN_A_C_ptr;
+        table[0x79] = &CPU::handle_opcode_0xED_0x79_OUT_C_ptr_A;
+        table[0x7A] = &CPU::handle_opcode_0xED_0x7A_ADC_HL_SP;
+        table[0x7B] = &CPU::handle_opcode_0xED_0x7B_LD_SP_nn_ptr;
+        table[0x7C] = &CPU::handle_opcode_0xED_0x7C_NEG;
+        table[0x7D] = &CPU::handle_opcode_0xED_0x7D_RETN;
+        table[0x7E] = &CPU::handle_opcode_0xED_0x7E_IM_2;
+        table[0xA0] = &CPU::handle_opcode_0xED_0xA0_LDI;
+        table[0xA1] = &CPU::handle_opcode_0xED_0xA1_CPI;
+        table[0xA2] = &CPU::handle_opcode_0xED_0xA2_INI;
+        table[0xA3] = &CPU::handle_opcode_0xED_0xA3_OUTI;
+        table[0xA8] = &CPU::handle_opcode_0xED_0xA8_LDD;
+        table[0xA9] = &CPU::handle_opcode_0xED_0xA9_CPD;
+        table[0xAA] = &CPU::handle_opcode_0xED_0xAA_IND;
+        table[0xAB] = &CPU::handle_opcode_0xED_0xAB_OUTD;
+        table[0xB0] = &CPU::handle_opcode_0xED_0xB0_LDIR;
+        table[0xB1] = &CPU::handle_opcode_0xED_0xB1_CPIR;
+        table[0xB2] = &CPU::handle_opcode_0xED_0xB2_INIR;
+        table[0xB3] = &CPU::handle_opcode_0xED_0xB3_OTIR;
+        table[0xB8] = &CPU::handle_opcode_0xED_0xB8_LDDR;
+        table[0xB9] = &CPU::handle_opcode_0xED_0xB9_CPDR;
+        table[0xBA] = &CPU::handle_opcode_0xED_0xBA_INDR;
+        table[0xBB] = &CPU::handle_opcode_0xED_0xBB_OTDR;
+        if constexpr (EnableNext) {
+            table[0x23] = &CPU::handle_opcode_0xED_0x23_SWAPNIB;
+            table[0x24] = &CPU::handle_opcode_0xED_0x24_MIRROR;
+            table[0x27] = &CPU::handle_opcode_0xED_0x27_TEST_n;
+            table[0x28] = &CPU::handle_opcode_0xED_0x28_BSLA_DE_B;
+            table[0x29] = &CPU::handle_opcode_0xED_0x29_BSRA_DE_B;
+            table[0x2A] = &CPU::handle_opcode_0xED_0x2A_BSRL_DE_B;
+            table[0x2B] = &CPU::handle_opcode_0xED_0x2B_BSRF_DE_B;
+            table[0x2C] = &CPU::handle_opcode_0xED_0x2C_BRLC_DE_B;
+            table[0x30] = &CPU::handle_opcode_0xED_0x30_MUL_D_E;
+            table[0x31] = &CPU::handle_opcode_0xED_0x31_ADD_HL_A;
+            table[0x32] = &CPU::handle_opcode_0xED_0x32_ADD_DE_A;
+            table[0x33] = &CPU::handle_opcode_0xED_0x33_ADD_BC_A;
+            table[0x34] = &CPU::handle_opcode_0xED_0x34_ADD_HL_nn;
+            table[0x35] = &CPU::handle_opcode_0xED_0x35_ADD_DE_nn;
+            table[0x36] = &CPU::handle_opcode_0xED_0x36_ADD_BC_nn;
+            table[0x8A] = &CPU::handle_opcode_0xED_0x8A_PUSH_nn;
+            table[0x90] = &CPU::handle_opcode_0xED_0x90_OUTINB;
+            table[0x91] = &CPU::handle_opcode_0xED_0x91_NEXTREG_n_n;
+            table[0x92] = &CPU::handle_opcode_0xED_0x92_NEXTREG_n_A;
+            table[0x93] = &CPU::handle_opcode_0xED_0x93_PIXELAD;
+            table[0x94] = &CPU::handle_opcode_0xED_0x94_PIXELDN;
+            table[0x95] = &CPU::handle_opcode_0xED_0x95_SETAE;
+            table[0x98] = &CPU::handle_opcode_0xED_0x98_JP_C;
+            table[0xA4] = &CPU::handle_opcode_0xED_0xA4_LDIX;
+            table[0xA5] = &CPU::handle_opcode_0xED_0xA5_LDWS;
+            table[0xAC] = &CPU::handle_opcode_0xED_0xAC_LDDX;
+            table[0xB4] = &CPU::handle_opcode_0xED_0xB4_LDIRX;
+            table[0xB6] = &CPU::handle_opcode_0xED_0xB6_LDIRSCALE;
+            table[0xB7] = &CPU::handle_opcode_0xED_0xB7_LDPIRX;
+            table[0xBC] = &CPU::handle_opcode_0xED_0xBC_LDDRX;
+        }
+        return table;
+    }
+    template <std::size_t... Opcodes> static constexpr OpcodeTable make_CB_table(std::index_sequence<Opcodes...>) {
+        return {{&CPU::handle_CB_opcode<Opcodes>...}};
+    }
+    template <std::size_t... Opcodes>
+    static constexpr IndexedCBTable make_CB_indexed_table(std::index_sequence<Opcodes...>) {
+        return {{&CPU::handle_CB_indexed_opcode<Opcodes>...}};
+    }
+
+    // Prefix handlers used by the table dispatcher
+    template <IndexMode TIndex> void handle_opcode_0xCB_prefix() {
+        if constexpr (TIndex == IndexMode::HL) {
+            if (!execute_decoded_prefix(0xCB))
+                handle_CB_opcodes(fetch_next_opcode());
+        } else { // DDCB d xx or FDCB d xx
+            uint16_t index_reg = get_indexed_HL<TIndex>();
+            int8_t offset = (int8_t)fetch_next_byte();
+            uint8_t cb_opcode = fetch_next_byte();
+            handle_CB_indexed_opcodes(index_reg, offset, cb_opcode);
+        }
+    }
+    void handle_opcode_0xED_prefix() {
+        static constexpr OpcodeTable s_ED_table = make_ED_table();
+        if (execute_decoded_prefix(0xED))
+            return;
+        uint8_t opcodeED = fetch_next_opcode();
+        set_index_mode(IndexMode::HL);
+        (this->*s_ED_table[opcodeED])();
+    }
+    // DD/FD prefix: a following prefix only replaces the index register, then the opcode runs through
+    // the IX or IY instantiation of its handler. m_index_mode is only bookkeeping for save_state().
+    void handle_opcode_0xDD_prefix() {
+        if (!execute_decoded_prefix(0xDD))
+            handle_index_prefix(IndexMode::IX);
+    }
+    void handle_opcode_0xFD_prefix() {
+        if (!execute_decoded_prefix(0xFD))
+            handle_index_prefix(IndexMode::IY);
+    }
+    void handle_index_prefix(IndexMode mode) {
+        uint8_t opcode = fetch_next_opcode();
+        while (opcode == 0xDD || opcode == 0xFD) {
+            mode = (opcode == 0xDD) ? IndexMode::IX : IndexMode::IY;
+            opcode = fetch_next_opcode();
+        }
+        set_index_mode(mode);
+        if (mode == IndexMode::IX)
+            execute_opcode<IndexMode::IX>(opcode);
+        else
+            execute_opcode<IndexMode::IY>(opcode);
+    }
+#ifdef Z80_OPCODE_FUSION
+    // Opcode fusion: the head of a common pair (DEC r / JR NZ, CP n / JP Z, PUSH / PUSH, ...) goes on to the
+    // next instruction without a trip through the instruction boundary or the dispatcher when the follower
+    // is one it expects. The pair keeps the architectural effects of two separate instructions: each one
+    // fetches its own opcode (R, ticks, bus) and the boundary checks of the threaded tail run between them,
+    // so a pending interrupt, HALT or the run limit stops the sequence after the head, and events fire on
+    // their exact T-state. Nothing fuses outside run() (step() leaves no run limit) or with a custom debugger.
+    template <uint8_t TOpcode> void execute_fixed_opcode() {
+        constexpr OpcodeHandler handler = make_main_table<IndexMode::HL>()[TOpcode];
+        (this->*handler)();
+    }
+    // The boundary between the instructions of a fused sequence: fetches the next opcode when nothing needs
+    // the full boundary, NO_OPCODE leaves it to operate()
+    static constexpr int NO_OPCODE = -1;
+    int enter_fused_opcode() {
+        update_Q();
+        if (m_ticks >= m_run_ticks_limit || m_pending_events || has_mail())
+            return NO_OPCODE;
+        update_event_horizon();
+        m_index_mode = IndexMode::HL;
+        uint8_t opcode = fetch_next_opcode();
+        if constexpr (TConfig::TRACK_Q)
+            m_flags_modified = false;
+        return opcode;
+    }
+    // Runs the head and, past the boundary, a follower. Any other opcode fetched there is returned for the
+    // dispatcher, which then runs it without another boundary.
+    template <uint8_t THead, uint8_t... TFollowers> int execute_fused() {
+        execute_fixed_opcode<THead>();
+        int opcode = enter_fused_opcode();
+        if (((opcode == TFollowers && (execute_fixed_opcode<TFollowers>(), true)) || ...))
+            return NO_OPCODE;
+        return opcode;
+    }
+    // Fused sequences, picked with tools/Z80Fuse
+    template <uint8_t TOpcode> int execute_fusion_head() {
+        constexpr bool fusable = std::is_same_v<TDebugger, StandardDebugger>;
+        if constexpr (fusable && (TOpcode == 0x05 || TOpcode == 0x0D || TOpcode == 0x15 || TOpcode == 0x1D ||
+                                  TOpcode == 0x3D)) {
+            // DEC r / JR NZ,d | JP NZ,nn
+            return execute_fused<TOpcode, 0x20, 0xC2>();
+        } else if constexpr (fusable && (TOpcode == 0xB7 || TOpcode == 0xA7 || TOpcode == 0xFE)) {
+            // OR A | AND A | CP n / JR cc,d | JP cc,nn
+            return execute_fused<TOpcode, 0x20, 0x28, 0xC2, 0xCA, 0x30, 0x38>();
+        } else if constexpr (fusable && (TOpcode == 0x7E || TOpcode == 0x77)) {
+            // LD A,(HL) | LD (HL),A / INC HL
+            return execute_fused<TOpcode, 0x23>();
+        } else if constexpr (fusable && TOpcode == 0x1A) {
+            // LD A,(DE) / INC DE
+            return execute_fused<TOpcode, 0x13>();
+        } else if constexpr (fusable && TOpcode == 0x21) {
+            // LD HL,nn / LD A,(HL)
+            return execute_fused<TOpcode, 0x7E>();
+        } else if constexpr (fusable && TOpcode == 0xEB) {
+            // EX DE,HL / ADD HL,DE | PUSH HL | EX DE,HL
+            return execute_fused<TOpcode, 0x19, 0xE5, 0xEB>();
+        } else if constexpr (fusable && (TOpcode & 0xCF) == 0xC5) {
+            // PUSH rr / PUSH rr | POP rr
+            return execute_fused<TOpcode, 0xC5, 0xD5, 0xE5, 0xF5, 0xC1, 0xD1, 0xE1, 0xF1>();
+        } else if constexpr (fusable && (TOpcode & 0xCF) == 0xC1) {
+            // POP rr / POP rr
+            return execute_fused<TOpcode, 0xC1, 0xD1, 0xE1, 0xF1>();
+        } else {
+            execute_fixed_opcode<TOpcode>();
+            return NO_OPCODE;
+        }
+    }
+#endif // Z80_OPCODE_FUSION
+#ifdef Z80_DECODE_CACHE
+    // Decode cache for prefixed instructions (CB, ED, DD, FD): per prefix address, the handler the prefix and
+    // the opcode after it resolve to, so a revisit skips the second fetch's read and the prefix dispatch.
+    // Unprefixed opcodes are a single table index already and never go through it. An entry keeps both bytes
+    // it was decoded from and is used only while memory still holds them, which keeps self-modifying code,
+    // bank switches and host writes correct without watching writes. Only plain memory is cached (StandardBus,
+    // mapped pages of a paged bus); unmapped pages may be devices and are fetched as usual.
+    static constexpr bool DECODE_CACHE = IDLE_LOOP_FAST_FORWARD;
+    struct DecodedOpcode {
+        OpcodeHandler handler;
+        uint8_t prefix, opcode;
+        IndexMode index_mode;
+        bool valid;
+    };
+    std::vector<DecodedOpcode> m_decode_cache; // Indexed by prefix address, allocated on first use
+    static DecodedOpcode decode_prefixed_opcode(uint8_t prefix, uint8_t opcode) {
+        static constexpr OpcodeTable s_IX_table = make_main_table<IndexMode::IX>();
+        static constexpr OpcodeTable s_IY_table = make_main_table<IndexMode::IY>();
+        static constexpr OpcodeTable s_CB_table = make_CB_table(std::make_index_sequence<256>{});
+        static constexpr OpcodeTable s_ED_table = make_ED_table();
+        if (prefix == 0xCB)
+            return {s_CB_table[opcode], prefix, opcode, IndexMode::HL, true};
+        if (prefix == 0xED)
+            return {s_ED_table[opcode], prefix, opcode, IndexMode::HL, true};
+        // A further prefix (DD DD, DD ED, ...) is left to the regular chain
+        if (opcode == 0xDD || opcode == 0xED || opcode == 0xFD)
+            return {nullptr, prefix, opcode, IndexMode::HL, false};
+        if (prefix == 0xDD)
+            return {s_IX_table[opcode], prefix, opcode, IndexMode::IX, true};
+        return {s_IY_table[opcode], prefix, opcode, IndexMode::IY, true};
+    }
+    // Called with the prefix just fetched: runs the rest of the instruction from its cache entry, charging
+    // the second opcode fetch as it would be made (ticks, R, bus mirrors). False leaves it to the regular
+    // path, also when an event falls inside that fetch.
+    bool execute_decoded_prefix(uint8_t prefix) {
+        if constexpr (DECODE_CACHE) {
+            uint16_t pc = get_PC();
+            uint8_t opcode;
+            if (!peek_idle_code(pc, opcode) || !is_event_free(4))
+                return false;
+            if (m_decode_cache.empty())
+                m_decode_cache.resize(0x10000, DecodedOpcode{nullptr, 0, 0, IndexMode::HL, false});
+            DecodedOpcode& entry = m_decode_cache[(uint16_t)(pc - 1)];
+            if (entry.prefix != prefix || entry.opcode != opcode) // Also true for an empty entry
+                entry = decode_prefixed_opcode(prefix, opcode);
+            if (!entry.valid)
+                return false;
+            update_address_bus(pc);
+            update_data_bus(opcode);
+            m_ticks += 4;
+            if constexpr (TConfig::TRACK_R)
+                ++m_R_fetches;
+            set_PC(pc + 1);
+            set_index_mode(entry.index_mode);
+            (this->*entry.handler)();
+            return true;
+        } else
+            return false;
+    }
+#else
+    bool execute_decoded_prefix(uint8_t prefix) {
+        return false;
+    }
+#endif // Z80_DECODE_CACHE
+    // Runs one opcode, prefixes already consumed, through the handlers instantiated for TIndex
+#ifdef Z80_TABLE_DISPATCH
+#ifdef Z80_OPCODE_FUSION
+    using FusionHandler = int (CPU::*)();
+    template <size_t... TOpcodes>
+    static constexpr std::array<FusionHandler, 256> make_fusion_table(std::index_sequence<TOpcodes...>) {
+        return {&CPU::execute_fusion_head<TOpcodes>...};
+    }
+#endif // Z80_OPCODE_FUSION
+    template <IndexMode TIndex> void execute_opcode(uint8_t opcode) {
+#ifdef Z80_OPCODE_FUSION
+        if constexpr (TIndex == IndexMode::HL) {
+            static constexpr std::array<FusionHandler, 256> s_fusion_table =
+                make_fusion_table(std::make_index_sequence<256>());
+            int next = opcode;
+            while ((next = (this->*s_fusion_table[next])()) != NO_OPCODE) {
+            }
+            return;
+        }
+#endif // Z80_OPCODE_FUSION
+        static constexpr OpcodeTable s_table = make_main_table<TIndex>();
+        (this->*s_table[opcode])();
+    }
+#else
+#ifdef Z80_OPCODE_FUSION
+    // A fusion head case runs the head (and its follower) and re-enters the switch with any other opcode it fetched
+#define Z80_FUSION_HEAD(n)                                                                                  \
+    if constexpr (TIndex == IndexMode::HL) {                                                                \
+        int next = execute_fusion_head<0x##n>();                                                            \
+        if (next == NO_OPCODE)                                                                              \
+            break;                                                                                          \
+        opcode = next;                                                                                      \
+        goto dispatch;                                                                                      \
+    }
+#else
+#define Z80_FUSION_HEAD(n)
+#endif // Z80_OPCODE_FUSION
+    template <IndexMode TIndex> void execute_opcode(uint8_t opcode) {
+#ifdef Z80_OPCODE_FUSION
+    dispatch:
+#endif // Z80_OPCODE_FUSION
+        switch (opcode) {
+
+        case 0x00:
+            handle_opcode_0x00_NOP();
+            break;
+        case 0x01:
+            handle_opcode_0x01_LD_BC_nn();
+            break;
+        case 0x02:
+            handle_opcode_0x02_LD_BC_ptr_A();
+            break;
+        case 0x03:
+            handle_opcode_0x03_INC_BC();
+            break;
+        case 0x04:
+            handle_opcode_0x04_INC_B();
+            break;
+        case 0x05:
+            Z80_FUSION_HEAD(05)
+            handle_opcode_0x05_DEC_B();
+            break;
+        case 0x06:
+            handle_opcode_0x06_LD_B_n();
+            break;
+        case 0x07:
+            handle_opcode_0x07_RLCA();
+            break;
+        case 0x08:
+            handle_opcode_0x08_EX_AF_AFp();
+            break;
+        case 0x09:
+            handle_opcode_0x09_ADD_HL_BC<TIndex>();
+            break;
+        case 0x0A:
+            handle_opcode_0x0A_LD_A_BC_ptr();
+            break;
+        case 0x0B:
+            handle_opcode_0x0B_DEC_BC();
+            break;
+        case 0x0C:
+            handle_opcode_0x0C_INC_C();
+            break;
+        case 0x0D:
+            Z80_FUSION_HEAD(0D)
+            handle_opcode_0x0D_DEC_C();
+            break;
+        case 0x0E:
+            handle_opcode_0x0E_LD_C_n();
+            break;
+        case 0x0F:
+            handle_opcode_0x0F_RRCA();
+            break;
+        case 0x10:
+            handle_opcode_0x10_DJNZ_d();
+            break;
+        case 0x11:
+            handle_opcode_0x11_LD_DE_nn();
+            break;
+        case 0x12:
+            handle_opcode_0x12_LD_DE_ptr_A();
+            break;
+        case 0x13:
+            handle_opcode_0x13_INC_DE();
+            break;
+        case 0x14:
+            handle_opcode_0x14_INC_D();
+            break;
+        case 0x15:
+            Z80_FUSION_HEAD(15)
+            handle_opcode_0x15_DEC_D();
+            break;
+        case 0x16:
+            handle_opcode_0x16_LD_D_n();
+            break;
+        case 0x17:
+            handle_opcode_0x17_RLA();
+            break;
+        case 0x18:
+            handle_opcode_0x18_JR_d();
+            break;
+        case 0x19:
+            handle_opcode_0x19_ADD_HL_DE<TIndex>();
+            break;
+        case 0x1A:
+            Z80_FUSION_HEAD(1A)
+            handle_opcode_0x1A_LD_A_DE_ptr();
+            break;
+        case 0x1B:
+            handle_opcode_0x1B_DEC_DE();
+            break;
+        case 0x1C:
+            handle_opcode_0x1C_INC_E();
+            break;
+        case 0x1D:
+            Z80_FUSION_HEAD(1D)
+            handle_opcode_0x1D_DEC_E();
+            break;
+        case 0x1E:
+            handle_opcode_0x1E_LD_E_n();
+            break;
+        case 0x1F:
+            handle_opcode_0x1F_RRA();
+            break;
+        case 0x20:
+            handle_opcode_0x20_JR_NZ_d();
+            break;
+        case 0x21:
+            Z80_FUSION_HEAD(21)
+            handle_opcode_0x21_LD_HL_nn<TIndex>();
+            break;
+        case 0x22:
+            handle_opcode_0x22_LD_nn_ptr_HL<TIndex>();
+            break;
+        case 0x23:
+            handle_opcode_0x23_INC_HL<TIndex>();
+            break;
+        case 0x24:
+            handle_opcode_0x24_INC_H<TIndex>();
+            break;
+        case 0x25:
+            handle_opcode_0x25_DEC_H<TIndex>();
+            break;
+        case 0x26:
+            handle_opcode_0x26_LD_H_n<TIndex>();
+            break;
+        case 0x27:
+            handle_opcode_0x27_DAA();
+            break;
+        case 0x28:
+            handle_opcode_0x28_JR_Z_d();
+            break;
+        case 0x29:
+            handle_opcode_0x29_ADD_HL_HL<TIndex>();
+            break;
+        case 0x2A:
+            handle_opcode_0x2A_LD_HL_nn_ptr<TIndex>();
+            break;
+        case 0x2B:
+            handle_opcode_0x2B_DEC_HL<TIndex>();
+            break;
+        case 0x2C:
+            handle_opcode_0x2C_INC_L<TIndex>();
+            break;
+        case 0x2D:
+            handle_opcode_0x2D_DEC_L<TIndex>();
+            break;
+        case 0x2E:
+            handle_opcode_0x2E_LD_L_n<TIndex>();
+            break;
+        case 0x2F:
+            handle_opcode_0x2F_CPL();
+            break;
+        case 0x30:
+            handle_opcode_0x30_JR_NC_d();
+            break;
+        case 0x31:
+            handle_opcode_0x31_LD_SP_nn();
+            break;
+        case 0x32:
+            handle_opcode_0x32_LD_nn_ptr_A();
+            break;
+        case 0x33:
+            handle_opcode_0x33_INC_SP();
+            break;
+        case 0x34:
+            handle_opcode_0x34_INC_HL_ptr<TIndex>();
+            break;
+        case 0x35:
+            handle_opcode_0x35_DEC_HL_ptr<TIndex>();
+            break;
+        case 0x36:
+            handle_opcode_0x36_LD_HL_ptr_n<TIndex>();
+            break;
+        case 0x37:
+            handle_opcode_0x37_SCF();
+            break;
+        case 0x38:
+            handle_opcode_0x38_JR_C_d();
+            break;
+        case 0x39:
+            handle_opcode_0x39_ADD_HL_SP<TIndex>();
+            break;
+        case 0x3A:
+            handle_opcode_0x3A_LD_A_nn_ptr();
+            break;
+        case 0x3B:
+            handle_opcode_0x3B_DEC_SP();
+            break;
+        case 0x3C:
+            handle_opcode_0x3C_INC_A();
+            break;
+        case 0x3D:
+            Z80_FUSION_HEAD(3D)
+            handle_opcode_0x3D_DEC_A();
+            break;
+        case 0x3E:
+            handle_opcode_0x3E_LD_A_n();
+            break;
+        case 0x3F:
+            handle_opcode_0x3F_CCF();
+            break;
+        case 0x40:
+            handle_opcode_0x40_LD_B_B();
+            break;
+        case 0x41:
+            handle_opcode_0x41_LD_B_C();
+            break;
+        case 0x42:
+            handle_opcode_0x42_LD_B_D();
+            break;
+        case 0x43:
+            handle_opcode_0x43_LD_B_E();
+            break;
+        case 0x44:
+            handle_opcode_0x44_LD_B_H<TIndex>();
+            break;
+        case 0x45:
+            handle_opcode_0x45_LD_B_L<TIndex>();
+            break;
+        case 0x46:
+            handle_opcode_0x46_LD_B_HL_ptr<TIndex>();
+            break;
+        case 0x47:
+            handle_opcode_0x47_LD_B_A();
+            break;
+        case 0x48:
+            handle_opcode_0x48_LD_C_B();
+            break;
+        case 0x49:
+            handle_opcode_0x49_LD_C_C();
+            break;
+        case 0x4A:
+            handle_opcode_0x4A_LD_C_D();
+            break;
+        case 0x4B:
+            handle_opcode_0x4B_LD_C_E();
+            break;
+        case 0x4C:
+            handle_opcode_0x4C_LD_C_H<TIndex>();
+            break;
+        case 0x4D:
+            handle_opcode_0x4D_LD_C_L<TIndex>();
+            break;
+        case 0x4E:
+            handle_opcode_0x4E_LD_C_HL_ptr<TIndex>();
+            break;
+        case 0x4F:
+            handle_opcode_0x4F_LD_C_A();
+            break;
+        case 0x50:
+            handle_opcode_0x50_LD_D_B();
+            break;
+        case 0x51:
+            handle_opcode_0x51_LD_D_C();
+            break;
+        case 0x52:
+            handle_opcode_0x52_LD_D_D();
+            break;
+        case 0x53:
+            handle_opcode_0x53_LD_D_E();
+            break;
+        case 0x54:
+            handle_opcode_0x54_LD_D_H<TIndex>();
+            break;
+        case 0x55:
+            handle_opcode_0x55_LD_D_L<TIndex>();
+            break;
+        case 0x56:
+            handle_opcode_0x56_LD_D_HL_ptr<TIndex>();
+            break;
+        case 0x57:
+            handle_opcode_0x57_LD_D_A();
+            break;
+        case 0x58:
+            handle_opcode_0x58_LD_E_B();
+            break;
+        case 0x59:
+            handle_opcode_0x59_LD_E_C();
+            break;
+        case 0x5A:
+            handle_opcode_0x5A_LD_E_D();
+            break;
+        case 0x5B:
+            handle_opcode_0x5B_LD_E_E();
+            break;
+        case 0x5C:
+            handle_opcode_0x5C_LD_E_H<TIndex>();
+            break;
+        case 0x5D:
+            handle_opcode_0x5D_LD_E_L<TIndex>();
+            break;
+        case 0x5E:
+            handle_opcode_0x5E_LD_E_HL_ptr<TIndex>();
+            break;
+        case 0x5F:
+            handle_opcode_0x5F_LD_E_A();
+            break;
+        case 0x60:
+            handle_opcode_0x60_LD_H_B<TIndex>();
+            break;
+        case 0x61:
+            handle_opcode_0x61_LD_H_C<TIndex>();
+            break;
+        case 0x62:
+            handle_opcode_0x62_LD_H_D<TIndex>();
+            break;
+        case 0x63:
+            handle_opcode_0x63_LD_H_E<TIndex>();
+            break;
+        case 0x64:
+            handle_opcode_0x64_LD_H_H();
+            break;
+        case 0x65:
+            handle_opcode_0x65_LD_H_L<TIndex>();
+            break;
+        case 0x66:
+            handle_opcode_0x66_LD_H_HL_ptr<TIndex>();
+            break;
+        case 0x67:
+            handle_opcode_0x67_LD_H_A<TIndex>();
+            break;
+        case 0x68:
+            handle_opcode_0x68_LD_L_B<TIndex>();
+            break;
+        case 0x69:
+            handle_opcode_0x69_LD_L_C<TIndex>();
+            break;
+        case 0x6A:
+            handle_opcode_0x6A_LD_L_D<TIndex>();
+            break;
+        case 0x6B:
+            handle_opcode_0x6B_LD_L_E<TIndex>();
+            break;
+        case 0x6C:
+            handle_opcode_0x6C_LD_L_H<TIndex>();
+            break;
+        case 0x6D:
+            handle_opcode_0x6D_LD_L_L();
+            break;
+        case 0x6E:
+            handle_opcode_0x6E_LD_L_HL_ptr<TIndex>();
+            break;
+        case 0x6F:
+            handle_opcode_0x6F_LD_L_A<TIndex>();
+            break;
+        case 0x70:
+            handle_opcode_0x70_LD_HL_ptr_B<TIndex>();
+            break;
+        case 0x71:
+            handle_opcode_0x71_LD_HL_ptr_C<TIndex>();
+            break;
+        case 0x72:
+            handle_opcode_0x72_LD_HL_ptr_D<TIndex>();
+            break;
+        case 0x73:
+            handle_opcode_0x73_LD_HL_ptr_E<TIndex>();
+            break;
+        case 0x74:
+            handle_opcode_0x74_LD_HL_ptr_H<TIndex>();
+            break;
+        case 0x75:
+            handle_opcode_0x75_LD_HL_ptr_L<TIndex>();
+            break;
+        case 0x76:
+            handle_opcode_0x76_HALT();
+            break;
+        case 0x77:
+            Z80_FUSION_HEAD(77)
+            handle_opcode_0x77_LD_HL_ptr_A<TIndex>();
+            break;
+        case 0x78:
+            handle_opcode_0x78_LD_A_B();
+            break;
+        case 0x79:
+            handle_opcode_0x79_LD_A_C();
+            break;
+        case 0x7A:
+            handle_opcode_0x7A_LD_A_D();
+            break;
+        case 0x7B:
+            handle_opcode_0x7B_LD_A_E();
+            break;
+        case 0x7C:
+            handle_opcode_0x7C_LD_A_H<TIndex>();
+            break;
+        case 0x7D:
+            handle_opcode_0x7D_LD_A_L<TIndex>();
+            break;
+        case 0x7E:
+            Z80_FUSION_HEAD(7E)
+            handle_opcode_0x7E_LD_A_HL_ptr<TIndex>();
+            break;
+        case 0x7F:
+            handle_opcode_0x7F_LD_A_A();
+            break;
+        case 0x80:
+            handle_opcode_0x80_ADD_A_B();
+            break;
+        case 0x81:
+            handle_opcode_0x81_ADD_A_C();
+            break;
+        case 0x82:
+            handle_opcode_0x82_ADD_A_D();
+            break;
+        case 0x83:
+            handle_opcode_0x83_ADD_A_E();
+            break;
+        case 0x84:
+            handle_opcode_0x84_ADD_A_H<TIndex>();
+            break;
+        case 0x85:
+            handle_opcode_0x85_ADD_A_L<TIndex>();
+            break;
+        case 0x86:
+            handle_opcode_0x86_ADD_A_HL_ptr<TIndex>();
+            break;
+        case 0x87:
+            handle_opcode_0x87_ADD_A_A();
+            break;
+        case 0x88:
+            handle_opcode_0x88_ADC_A_B();
+            break;
+        case 0x89:
+            handle_opcode_0x89_ADC_A_C();
+            break;
+        case 0x8A:
+            handle_opcode_0x8A_ADC_A_D();
+            break;
+        case 0x8B:
+            handle_opcode_0x8B_ADC_A_E();
+            break;
+        case 0x8C:
+            handle_opcode_0x8C_ADC_A_H<TIndex>();
+            break;
+        case 0x8D:
+            handle_opcode_0x8D_ADC_A_L<TIndex>();
+            break;
+        case 0x8E:
+            handle_opcode_0x8E_ADC_A_HL_ptr<TIndex>();
+            break;
+        case 0x8F:
+            handle_opcode_0x8F_ADC_A_A();
+            break;
+        case 0x90:
+            handle_opcode_0x90_SUB_B();
+            break;
+        case 0x91:
+            handle_opcode_0x91_SUB_C();
+            break;
+        case 0x92:
+            handle_opcode_0x92_SUB_D();
+            break;
+        case 0x93:
+            handle_opcode_0x93_SUB_E();
+            break;
+        case 0x94:
+            handle_opcode_0x94_SUB_H<TIndex>();
+            break;
+        case 0x95:
+            handle_opcode_0x95_SUB_L<TIndex>();
+            break;
+        case 0x96:
+            handle_opcode_0x96_SUB_HL_ptr<TIndex>();
+            break;
+        case 0x97:
+            handle_opcode_0x97_SUB_A();
+            break;
+        case 0x98:
+            handle_opcode_0x98_SBC_A_B();
+            break;
+        case 0x99:
+            handle_opcode_0x99_SBC_A_C();
+            break;
+        case 0x9A:
+            handle_opcode_0x9A_SBC_A_D();
+            break;
+        case 0x9B:
+            handle_opcode_0x9B_SBC_A_E();
+            break;
+        case 0x9C:
+            handle_opcode_0x9C_SBC_A_H<TIndex>();
+            break;
+        case 0x9D:
+            handle_opcode_0x9D_SBC_A_L<TIndex>();
+            break;
+        case 0x9E:
+            handle_opcode_0x9E_SBC_A_HL_ptr<TIndex>();
+            break;
+        case 0x9F:
+            handle_opcode_0x9F_SBC_A_A();
+            break;
+        case 0xA0:
+            handle_opcode_0xA0_AND_B();
+            break;
+        case 0xA1:
+            handle_opcode_0xA1_AND_C();
+            break;
+        case 0xA2:
+            handle_opcode_0xA2_AND_D();
+            break;
+        case 0xA3:
+            handle_opcode_0xA3_AND_E();
+            break;
+        case 0xA4:
+            handle_opcode_0xA4_AND_H<TIndex>();
+            break;
+        case 0xA5:
+            handle_opcode_0xA5_AND_L<TIndex>();
+            break;
+        case 0xA6:
+            handle_opcode_0xA6_AND_HL_ptr<TIndex>();
+            break;
+        case 0xA7:
+            Z80_FUSION_HEAD(A7)
+            handle_opcode_0xA7_AND_A();
+            break;
+        case 0xA8:
+            handle_opcode_0xA8_XOR_B();
+            break;
+        case 0xA9:
+            handle_opcode_0xA9_XOR_C();
+            break;
+        case 0xAA:
+            handle_opcode_0xAA_XOR_D();
+            break;
+        case 0xAB:
+            handle_opcode_0xAB_XOR_E();
+            break;
+        case 0xAC:
+            handle_opcode_0xAC_XOR_H<TIndex>();
+            break;
+        case 0xAD:
+            handle_opcode_0xAD_XOR_L<TIndex>();
+            break;
+        case 0xAE:
+            handle_opcode_0xAE_XOR_HL_ptr<TIndex>();
+            break;
+        case 0xAF:
+            handle_opcode_0xAF_XOR_A();
+            break;
+        case 0xB0:
+            handle_opcode_0xB0_OR_B();
+            break;
+        case 0xB1:
+            handle_opcode_0xB1_OR_C();
+            break;
+        case 0xB2:
+            handle_opcode_0xB2_OR_D();
+            break;
+        case 0xB3:
+            handle_opcode_0xB3_OR_E();
+            break;
+        case 0xB4:
+            handle_opcode_0xB4_OR_H<TIndex>();
+            break;
+        case 0xB5:
+            handle_opcode_0xB5_OR_L<TIndex>();
+            break;
+        case 0xB6:
+            handle_opcode_0xB6_OR_HL_ptr<TIndex>();
+            break;
+        case 0xB7:
+            Z80_FUSION_HEAD(B7)
+            handle_opcode_0xB7_OR_A();
+            break;
+        case 0xB8:
+            handle_opcode_0xB8_CP_B();
+            break;
+        case 0xB9:
+            handle_opcode_0xB9_CP_C();
+            break;
+        case 0xBA:
+            handle_opcode_0xBA_CP_D();
+            break;
+        case 0xBB:
+            handle_opcode_0xBB_CP_E();
+            break;
+        case 0xBC:
+            handle_opcode_0xBC_CP_H<TIndex>();
+            break;
+        case 0xBD:
+            handle_opcode_0xBD_CP_L<TIndex>();
+            break;
+        case 0xBE:
+            handle_opcode_0xBE_CP_HL_ptr<TIndex>();
+            break;
+        case 0xBF:
+            handle_opcode_0xBF_CP_A();
+            break;
+        case 0xC0:
+            handle_opcode_0xC0_RET_NZ();
+            break;
+        case 0xC1:
+            Z80_FUSION_HEAD(C1)
+            handle_opcode_0xC1_POP_BC();
+            break;
+        case 0xC2:
+            handle_opcode_0xC2_JP_NZ_nn();
+            break;
+        case 0xC3:
+            handle_opcode_0xC3_JP_nn();
+            break;
+        case 0xC4:
+            handle_opcode_0xC4_CALL_NZ_nn();
+            break;
+        case 0xC5:
+            Z80_FUSION_HEAD(C5)
+            handle_opcode_0xC5_PUSH_BC();
+            break;
+        case 0xC6:
+            handle_opcode_0xC6_ADD_A_n();
+            break;
+        case 0xC7:
+            handle_opcode_0xC7_RST_00H();
+            break;
+        case 0xC8:
+            handle_opcode_0xC8_RET_Z();
+            break;
+        case 0xC9:
+            handle_opcode_0xC9_RET();
+            break;
+        case 0xCA:
+            handle_opcode_0xCA_JP_Z_nn();
+            break;
+        case 0xCB:
+            if constexpr (TIndex == IndexMode::HL) {
+                if (execute_decoded_prefix(0xCB))
+                    break;
+                uint8_t cb_opcode = fetch_next_opcode();
+                handle_CB_opcodes(cb_opcode);
+            } else { // DDCB d xx or FDCB d xx
+                uint16_t index_reg = get_indexed_HL<TIndex>();
+                int8_t offset = (int8_t)fetch_next_byte();
+                uint8_t cb_opcode = fetch_next_byte();
+                handle_CB_indexed_opcodes(index_reg, offset, cb_opcode);
+            }
+            break;
+        case 0xCC:
+            handle_opcode_0xCC_CALL_Z_nn();
+            break;
+        case 0xCD:
+            handle_opcode_0xCD_CALL_nn();
+            break;
+        case 0xCE:
+            handle_opcode_0xCE_ADC_A_n();
+            break;
+        case 0xCF:
+            handle_opcode_0xCF_RST_08H();
+            break;
+        case 0xD0:
+            handle_opcode_0xD0_RET_NC();
+            break;
+        case 0xD1:
+            Z80_FUSION_HEAD(D1)
+            handle_opcode_0xD1_POP_DE();
+            break;
+        case 0xD2:
+            handle_opcode_0xD2_JP_NC_nn();
+            break;
+        case 0xD3:
+            handle_opcode_0xD3_OUT_n_ptr_A();
+            break;
+        case 0xD4:
+            handle_opcode_0xD4_CALL_NC_nn();
+            break;
+        case 0xD5:
+            Z80_FUSION_HEAD(D5)
+            handle_opcode_0xD5_PUSH_DE();
+            break;
+        case 0xD6:
+            handle_opcode_0xD6_SUB_n();
+            break;
+        case 0xD7:
+            handle_opcode_0xD7_RST_10H();
+            break;
+        case 0xD8:
+            handle_opcode_0xD8_RET_C();
+            break;
+        case 0xD9:
+            handle_opcode_0xD9_EXX();
+            break;
+        case 0xDA:
+            handle_opcode_0xDA_JP_C_nn();
+            break;
+        case 0xDB:
+            handle_opcode_0xDB_IN_A_n_ptr();
+            break;
+        case 0xDC:
+            handle_opcode_0xDC_CALL_C_nn();
+            break;
+        case 0xDD:
+            handle_opcode_0xDD_prefix();
+            break;
+        case 0xDE:
+            handle_opcode_0xDE_SBC_A_n();
+            break;
+        case 0xDF:
+            handle_opcode_0xDF_RST_18H();
+            break;
+        case 0xE0:
+            handle_opcode_0xE0_RET_PO();
+            break;
+        case 0xE1:
+            Z80_FUSION_HEAD(E1)
+            handle_opcode_0xE1_POP_HL<TIndex>();
+            break;
+        case 0xE2:
+            handle_opcode_0xE2_JP_PO_nn();
+            break;
+        case 0xE3:
+            handle_opcode_0xE3_EX_SP_ptr_HL<TIndex>();
+            break;
+        case 0xE4:
+            handle_opcode_0xE4_CALL_PO_nn();
+            break;
+        case 0xE5:
+            Z80_FUSION_HEAD(E5)
+            handle_opcode_0xE5_PUSH_HL<TIndex>();
+            break;
+        case 0xE6:
+            handle_opcode_0xE6_AND_n();
+            break;
+        case 0xE7:
+            handle_opcode_0xE7_RST_20H();
+            break;
+        case 0xE8:
+            handle_opcode_0xE8_RET_PE();
+            break;
+        case 0xE9:
+            handle_opcode_0xE9_JP_HL_ptr<TIndex>();
+            break;
+        case 0xEA:
+            handle_opcode_0xEA_JP_PE_nn();
+            break;
+        case 0xEB:
+            Z80_FUSION_HEAD(EB)
+            handle_opcode_0xEB_EX_DE_HL();
+            break;
+        case 0xEC:
+            handle_opcode_0xEC_CALL_PE_nn();
+            break;
+        case 0xED: {
+            if (execute_decoded_prefix(0xED))
+                break;
+            uint8_t opcodeED = fetch_next_opcode();
+            set_index_mode(IndexMode::HL);
+            switch (opcodeED) {
+            case 0x40:
+                handle_opcode_0xED_0x40_IN_B_C_ptr();
+                break;
+            case 0x41:
+                handle_opcode_0xED_0x41_OUT_C_ptr_B();
+                break;
+            case 0x42:
+                handle_opcode_0xED_0x42_SBC_HL_BC();
+                break;
+            case 0x43:
+                handle_opcode_0xED_0x43_LD_nn_ptr_BC();
+                break;
+            case 0x23: if constexpr (EnableNext) handle_opcode_0xED_0x23_SWAPNIB(); break;
+            case 0x24: if constexpr (EnableNext) handle_opcode_0xED_0x24_MIRROR(); break;
+            case 0x27: if constexpr (EnableNext) handle_opcode_0xED_0x27_TEST_n(); break;
+            case 0x28: if constexpr (EnableNext) handle_opcode_0xED_0x28_BSLA_DE_B(); break;
+            case 0x29: if constexpr (EnableNext) handle_opcode_0xED_0x29_BSRA_DE_B(); break;
+            case 0x2A: if constexpr (EnableNext) handle_opcode_0xED_0x2A_BSRL_DE_B(); break;
+            case 0x2B: if constexpr (EnableNext) handle_opcode_0xED_0x2B_BSRF_DE_B(); break;
+            case 0x2C: if constexpr (EnableNext) handle_opcode_0xED_0x2C_BRLC_DE_B(); break;
+            case 0x30: if constexpr (EnableNext) handle_opcode_0xED_0x30_MUL_D_E(); break;
+            case 0x31: if constexpr (EnableNext) handle_opcode_0xED_0x31_ADD_HL_A(); break;
+            case 0x32: if constexpr (EnableNext) handle_opcode_0xED_0x32_ADD_DE_A(); break;
+            case 0x33: if constexpr (EnableNext) handle_opcode_0xED_0x33_ADD_BC_A(); break;
+            case 0x34: if constexpr (EnableNext) handle_opcode_0xED_0x34_ADD_HL_nn(); break;
+            case 0x35: if constexpr (EnableNext) handle_opcode_0xED_0x35_ADD_DE_nn(); break;
+            case 0x36: if constexpr (EnableNext) handle_opcode_0xED_0x36_ADD_BC_nn(); break;
+            case 0x8A: if constexpr (EnableNext) handle_opcode_0xED_0x8A_PUSH_nn(); break;
+            case 0x90: if constexpr (EnableNext) handle_opcode_0xED_0x90_OUTINB(); break;
+            case 0x91: if constexpr (EnableNext) handle_opcode_0xED_0x91_NEXTREG_n_n(); break;
+            case 0x92: if constexpr (EnableNext) handle_opcode_0xED_0x92_NEXTREG_n_A(); break;
+            case 0x93: if constexpr (EnableNext) handle_opcode_0xED_0x93_PIXELAD(); break;
+            case 0x94: if constexpr (EnableNext) handle_opcode_0xED_0x94_PIXELDN(); break;
+            case 0x95: if constexpr (EnableNext) handle_opcode_0xED_0x95_SETAE(); break;
+            case 0x98: if constexpr (EnableNext) handle_opcode_0xED_0x98_JP_C(); break;
+            case 0xA4: if constexpr (EnableNext) handle_opcode_0xED_0xA4_LDIX(); break;
+            case 0xA5: if constexpr (EnableNext) handle_opcode_0xED_0xA5_LDWS(); break;
+            case 0xAC: if constexpr (EnableNext) handle_opcode_0xED_0xAC_LDDX(); break;
+            case 0xB4: if constexpr (EnableNext) handle_opcode_0xED_0xB4_LDIRX(); break;
+            case 0xB6: if constexpr (EnableNext) handle_opcode_0xED_0xB6_LDIRSCALE(); break;
+            case 0xB7: if constexpr (EnableNext) handle_opcode_0xED_0xB7_LDPIRX(); break;
+            case 0xBC: if constexpr (EnableNext) handle_opcode_0xED_0xBC_LDDRX(); break;
+            case 0x44:
+                handle_opcode_0xED_0x44_NEG();
+                break;
+            case 0x45:
+                handle_opcode_0xED_0x45_RETN();
+                break;
+            case 0x46:
+                handle_opcode_0xED_0x46_IM_0();
+                break;
+            case 0x47:
+                handle_opcode_0xED_0x47_LD_I_A();
+                break;
+            case 0x48:
+                handle_opcode_0xED_0x48_IN_C_C_ptr();
+                break;
+            case 0x49:
+                handle_opcode_0xED_0x49_OUT_C_ptr_C();
+                break;
+            case 0x4A:
+                handle_opcode_0xED_0x4A_ADC_HL_BC();
+                break;
+            case 0x4B:
+                handle_opcode_0xED_0x4B_LD_BC_nn_ptr();
+                break;
+            case 0x4C:
+                handle_opcode_0xED_0x4C_NEG();
+                break;
+            case 0x4D:
+                handle_opcode_0xED_0x4D_RETI();
+                break;
+            case 0x4E:
+                handle_opcode_0xED_0x4E_IM_0();
+                break;
+            case 0x4F:
+                handle_opcode_0xED_0x4F_LD_R_A();
+                break;
+            case 0x50:
+                handle_opcode_0xED_0x50_IN_D_C_ptr();
+                break;
+            case 0x51:
+                handle_opcode_0xED_0x51_OUT_C_ptr_D();
+                break;
+            case 0x52:
+                handle_opcode_0xED_0x52_SBC_HL_DE();
+                break;
+            case 0x53:
+                handle_opcode_0xED_0x53_LD_nn_ptr_DE();
+                break;
+            case 0x54:
+                handle_opcode_0xED_0x54_NEG();
+                break;
+            case 0x55:
+                handle_opcode_0xED_0x55_RETN();
+                break;
+            case 0x56:
+                handle_opcode_0xED_0x56_IM_1();
+                break;
+            case 0x57:
+                handle_opcode_0xED_0x57_LD_A_I();
+                break;
+            case 0x58:
+                handle_opcode_0xED_0x58_IN_E_C_ptr();
+                break;
+            case 0x59:
+                handle_opcode_0xED_0x59_OUT_C_ptr_E();
+                break;
+            case 0x5A:
+                handle_opcode_0xED_0x5A_ADC_HL_DE();
+                break;
+            case 0x5B:
+                handle_opcode_0xED_0x5B_LD_DE_nn_ptr();
+                break;
+            case 0x5C:
+                handle_opcode_0xED_0x5C_NEG();
+                break;
+            case 0x5D:
+                handle_opcode_0xED_0x5D_RETN();
+                break;
+            case 0x5E:
+                handle_opcode_0xED_0x5E_IM_2();
+                break;
+            case 0x5F:
+                handle_opcode_0xED_0x5F_LD_A_R();
+                break;
+            case 0x60:
+                handle_opcode_0xED_0x60_IN_H_C_ptr();
+                break;
+            case 0x61:
+                handle_opcode_0xED_0x61_OUT_C_ptr_H();
+                break;
+            case 0x62:
+                handle_opcode_0xED_0x62_SBC_HL_HL();
+                break;
+            case 0x63:
+                handle_opcode_0xED_0x63_LD_nn_ptr_HL_ED();
+                break;
+            case 0x64:
+                handle_opcode_0xED_0x64_NEG();
+                break;
+            case 0x65:
+                handle_opcode_0xED_0x65_RETN();
+                break;
+            case 0x66:
+                handle_opcode_0xED_0x66_IM_0();
+                break;
+            case 0x67:
+                handle_opcode_0xED_0x67_RRD();
+                break;
+            case 0x68:
+                handle_opcode_0xED_0x68_IN_L_C_ptr();
+                break;
+            case 0x69:
+                handle_opcode_0xED_0x69_OUT_C_ptr_L();
+                break;
+            case 0x6A:
+                handle_opcode_0xED_0x6A_ADC_HL_HL();
+                break;
+            case 0x6B:
+                handle_opcode_0xED_0x6B_LD_HL_nn_ptr_ED();
+                break;
+            case 0x6C:
+                handle_opcode_0xED_0x6C_NEG();
+                break;
+            case 0x6D:
+                handle_opcode_0xED_0x6D_RETN();
+                break;
+            case 0x6E:
+                handle_opcode_0xED_0x6E_IM_0();
+                break;
+            case 0x6F:
+                handle_opcode_0xED_0x6F_RLD();
+                break;
+            case 0x70:
+                handle_opcode_0xED_0x70_IN_C_ptr();
+                break;
+            case 0x71:
+                handle_opcode_0xED_0x71_OUT_C_ptr_0();
+                break;
+            case 0x72:
+                handle_opcode_0xED_0x72_SBC_HL_SP();
+                break;
+            case 0x73:
+                handle_opcode_0xED_0x73_LD_nn_ptr_SP();
+                break;
+            case 0x74:
+                handle_opcode_0xED_0x74_NEG();
+                break;
+            case 0x75:
+                handle_opcode_0xED_0x75_RETN();
+                break;
+            case 0x76:
+                handle_opcode_0xED_0x76_IM_1();
+                break;
+            case 0x78:
+                handle_opcode_0xED_0x78_IN_A_C_ptr();
+                break;
+            case 0x79:
+                handle_opcode_0xED_0x79_OUT_C_ptr_A();
+                break;
+            case 0x7A:
+                handle_opcode_0xED_0x7A_ADC_HL_SP();
+                break;
+            case 0x7B:
+                handle_opcode_0xED_0x7B_LD_SP_nn_ptr();
+                break;
+            case 0x7C:
+                handle_opcode_0xED_0x7C_NEG();
+                break;
+            case 0x7D:
+                handle_opcode_0xED_0x7D_RETN();
+                break;
+            case 0x7E:
+                handle_opcode_0xED_0x7E_IM_2();
+                break;
+            case 0xA0:
+                handle_opcode_0xED_0xA0_LDI();
+                break;
+            case 0xA1:
+                handle_opcode_0xED_0xA1_CPI();
+                break;
+            case 0xA2:
+                handle_opcode_0xED_0xA2_INI();
+                break;
+            case 0xA3:
+                handle_opcode_0xED_0xA3_OUTI();
+                break;
+            case 0xA8:
+                handle_opcode_0xED_0xA8_LDD();
+                break;
+            case 0xA9:
+                handle_opcode_0xED_0xA9_CPD();
+                break;
+            case 0xAA:
+                handle_opcode_0xED_0xAA_IND();
+                break;
+            case 0xAB:
+                handle_opcode_0xED_0xAB_OUTD();
+                break;
+            case 0xB0:
+                handle_opcode_0xED_0xB0_LDIR();
+                break;
+            case 0xB1:
+                handle_opcode_0xED_0xB1_CPIR();
+                break;
+            case 0xB2:
+                handle_opcode_0xED_0xB2_INIR();
+                break;
+            case 0xB3:
+                handle_opcode_0xED_0xB3_OTIR();
+                break;
+            case 0xB8:
+                handle_opcode_0xED_0xB8_LDDR();
+                break;
+            case 0xB9:
+                handle_opcode_0xED_0xB9_CPDR();
+                break;
+            case 0xBA:
+                handle_opcode_0xED_0xBA_INDR();
+                break;
+            case 0xBB:
+                handle_opcode_0xED_0xBB_OTDR();
+                break;
+            }
+            break;
+        }
+        case 0xEE:
+            handle_opcode_0xEE_XOR_n();
+            break;
+        case 0xEF:
+            handle_opcode_0xEF_RST_28H();
+            break;
+        case 0xF0:
+            handle_opcode_0xF0_RET_P();
+            break;
+        case 0xF1:
+            Z80_FUSION_HEAD(F1)
+            handle_opcode_0xF1_POP_AF();
+            break;
+        case 0xF2:
+            handle_opcode_0xF2_JP_P_nn();
+            break;
+        case 0xF3:
+            handle_opcode_0xF3_DI();
+            break;
+        case 0xF4:
+            handle_opcode_0xF4_CALL_P_nn();
+            break;
+        case 0xF5:
+            Z80_FUSION_HEAD(F5)
+            handle_opcode_0xF5_PUSH_AF();
+            break;
+        case 0xF6:
+            handle_opcode_0xF6_OR_n();
+            break;
+        case 0xF7:
+            handle_opcode_0xF7_RST_30H();
+            break;
+        case 0xF8:
+            handle_opcode_0xF8_RET_M();
+            break;
+        case 0xF9:
+            handle_opcode_0xF9_LD_SP_HL<TIndex>();
+            break;
+        case 0xFA:
+            handle_opcode_0xFA_JP_M_nn();
+            break;
+        case 0xFB:
+            handle_opcode_0xFB_EI();
+            break;
+        case 0xFC:
+            handle_opcode_0xFC_CALL_M_nn();
+            break;
+        case 0xFD:
+            handle_opcode_0xFD_prefix();
+            break;
+        case 0xFE:
+            Z80_FUSION_HEAD(FE)
+            handle_opcode_0xFE_CP_n();
+            break;
+        case 0xFF:
+            handle_opcode_0xFF_RST_38H();
+            break;
+        }
+    }
+#undef Z80_FUSION_HEAD
+#endif // Z80_TABLE_DISPATCH
+
+    // Opcodes processing
+    enum class OperateMode { ToLimit, SingleStep };
+#ifdef Z80_THREADED_DISPATCH
+    // Threaded dispatch: every opcode label runs its handler and jumps straight to the next one,
+    // so each opcode gets its own indirect branch. The full instruction boundary (interrupts, HALT,
+    // debugger hooks, tick limit) is only taken when one of its conditions is pending.
+#define Z80_THREADED_LABEL(n) &&opcode_##n,
+#ifdef Z80_OPCODE_FUSION
+#define Z80_THREADED_EXECUTE(n)                                                                             \
+    if (int next = execute_fusion_head<0x##n>(); next != NO_OPCODE)                                         \
+        goto* s_labels[opcode = next]
+#else
+#define Z80_THREADED_EXECUTE(n) (this->*s_main_table[0x##n])()
+#endif // Z80_OPCODE_FUSION
+#define Z80_THREADED_HANDLER(n)                                                                             \
+    opcode_##n:                                                                                             \
+    Z80_THREADED_EXECUTE(n);                                                                                \
+    update_Q();                                                                                             \
+    if constexpr (TMode == OperateMode::SingleStep || !std::is_same_v<TDebugger, StandardDebugger>)         \
+        goto instruction_done;                                                                              \
+    if (m_ticks >= ticks_limit || m_pending_events || has_mail())                                           \
+        goto instruction_done;                                                                              \
+    update_event_horizon();                                                                                 \
+    m_index_mode = IndexMode::HL;                                                                           \
+    opcode = fetch_next_opcode();                                                                           \
+    if constexpr (TConfig::TRACK_Q)                                                                         \
+        m_flags_modified = false;                                                                           \
+    goto* s_labels[opcode];
+    template <OperateMode TMode> long long operate(long long ticks_limit) {
+        static constexpr OpcodeTable s_main_table = make_main_table<IndexMode::HL>();
+        static void* const s_labels[256] = {Z80_THREADED_OPCODES(Z80_THREADED_LABEL)};
+        long long initial_ticks = get_ticks();
+        uint8_t opcode;
+        if constexpr (TMode == OperateMode::ToLimit)
+            m_run_ticks_limit = ticks_limit;
+        m_idle_loop.armed = false;
+    instruction_boundary:
+        if constexpr (TConfig::THREAD_MAILBOX) {
+            if (has_mail() && drain_mailbox<TMode == OperateMode::SingleStep>()) {
+                m_run_ticks_limit = LLONG_MIN;
+                return get_ticks() - initial_ticks;
+            }
+        }
+        update_event_horizon();
+        if (m_pending_events) {
+            if (is_NMI_pending())
+                handle_NMI();
+            else if (is_EI_executed())
+                set_EI_executed(false);
+            else if (is_IRQ_pending())
+                handle_IRQ();
+        }
+        if (is_halted()) {
+            if constexpr (TMode == OperateMode::SingleStep)
+                add_ticks(4);
+            else
+                add_ticks(halted_ticks_target(ticks_limit) - get_ticks());
+            goto instruction_done;
+        }
+        if constexpr (!std::is_same_v<TDebugger, StandardDebugger>) {
+#ifdef Z80_DEBUGGER_OPCODES
+            m_opcodes.clear();
+#endif // Z80_DEBUGGER_OPCODES
+            m_debugger->before_step();
+        }
+        set_index_mode(IndexMode::HL);
+        opcode = fetch_next_opcode();
+        if constexpr (TConfig::TRACK_Q)
+            set_flags_modified(false);
+        goto* s_labels[opcode];
+        Z80_THREADED_OPCODES(Z80_THREADED_HANDLER)
+    instruction_done:
+        if constexpr (!std::is_same_v<TDebugger, StandardDebugger>)
+#ifdef Z80_DEBUGGER_OPCODES
+            m_debugger->after_step(m_opcodes);
+#else
+            m_debugger->after_step();
+#endif
+        if constexpr (TMode == OperateMode::ToLimit) {
+            if (get_ticks() < ticks_limit)
+                goto instruction_boundary;
+            m_run_ticks_limit = LLONG_MIN;
+        }
+        return get_ticks() - initial_ticks;
+    }
+#undef Z80_THREADED_LABEL
+#undef Z80_THREADED_EXECUTE
+#undef Z80_THREADED_HANDLER
+#else
+    template <OperateMode TMode> long long operate(long long ticks_limit) {
+        long long initial_ticks = get_ticks();
+        if constexpr (TMode == OperateMode::ToLimit)
+            m_run_ticks_limit = ticks_limit;
+        m_idle_loop.armed = false;
+        while (true) {
+            if constexpr (TConfig::THREAD_MAILBOX) {
+                if (has_mail() && drain_mailbox<TMode == OperateMode::SingleStep>())
                     break;
-                }
-                if (get_flags_modified())
-                    set_Q(get_F());
+            }
+            update_event_horizon();
+            if (m_pending_events) {
+                if (is_NMI_pending())
+                    handle_NMI();
+                else if (is_EI_executed())
+                    set_EI_executed(false);
+                else if (is_IRQ_pending())
+                    handle_IRQ();
+            }
+            if (is_halted()) {
+                if constexpr (TMode == OperateMode::SingleStep)
+                    add_ticks(4);
                 else
-                    set_Q(0);
+                    add_ticks(halted_ticks_target(ticks_limit) - get_ticks());
+            } else {
+                if constexpr (!std::is_same_v<TDebugger, StandardDebugger>) {
+#ifdef Z80_DEBUGGER_OPCODES
+                    m_opcodes.clear();
+#endif // Z80_DEBUGGER_OPCODES
+                    m_debugger->before_step();
+                }
+                set_index_mode(IndexMode::HL);
+                uint8_t opcode = fetch_next_opcode();
+                if constexpr (TConfig::TRACK_Q)
+                    set_flags_modified(false);
+                execute_opcode<IndexMode::HL>(opcode);
+                update_Q();
             }
             if constexpr (!std::is_same_v<TDebugger, StandardDebugger>)
 #ifdef Z80_DEBUGGER_OPCODES
@@ -4576,8 +5877,11 @@ private:
                     break;
             }
         }
+        if constexpr (TMode == OperateMode::ToLimit)
+            m_run_ticks_limit = LLONG_MIN;
         return get_ticks() - initial_ticks;
     }
+#endif // Z80_THREADED_DISPATCH
 
 // Public execution API
 #ifndef Z80_DISABLE_EXEC_API
@@ -4589,18 +5893,12 @@ private:
 
     template <auto HandleFunc> void exec_DD_helper() {
         add_ticks(8);
-        IndexMode old_index_mode = get_index_mode();
-        set_index_mode(IndexMode::IX);
         (this->*HandleFunc)();
-        set_index_mode(old_index_mode);
     }
 
     template <auto HandleFunc> void exec_FD_helper() {
         add_ticks(8);
-        IndexMode old_index_mode = get_index_mode();
-        set_index_mode(IndexMode::IY);
         (this->*HandleFunc)();
-        set_index_mode(old_index_mode);
     }
 
     template <auto HandleFunc> void exec_ED_helper() {
@@ -4615,18 +5913,12 @@ private:
 
     void exec_DDCB_helper(int8_t offset, uint8_t opcode) {
         add_ticks(12);
-        IndexMode old_index_mode = get_index_mode();
-        set_index_mode(IndexMode::IX);
         handle_CB_indexed_opcodes(get_IX(), offset, opcode);
-        set_index_mode(old_index_mode);
     }
 
     void exec_FDCB_helper(int8_t offset, uint8_t opcode) {
         add_ticks(12);
-        IndexMode old_index_mode = get_index_mode();
-        set_index_mode(IndexMode::IY);
         handle_CB_indexed_opcodes(get_IY(), offset, opcode);
-        set_index_mode(old_index_mode);
     }
 
 public:
@@ -4658,7 +5950,7 @@ public:
         exec_helper<&CPU::handle_opcode_0x08_EX_AF_AFp>();
     }
     void exec_ADD_HL_BC() {
-        exec_helper<&CPU::handle_opcode_0x09_ADD_HL_BC>();
+        exec_helper<&CPU::handle_opcode_0x09_ADD_HL_BC<IndexMode::HL>>();
     }
     void exec_LD_A_BC_ptr() {
         exec_helper<&CPU::handle_opcode_0x0A_LD_A_BC_ptr>();
@@ -4706,7 +5998,7 @@ public:
         exec_helper<&CPU::handle_opcode_0x18_JR_d>();
     }
     void exec_ADD_HL_DE() {
-        exec_helper<&CPU::handle_opcode_0x19_ADD_HL_DE>();
+        exec_helper<&CPU::handle_opcode_0x19_ADD_HL_DE<IndexMode::HL>>();
     }
     void exec_LD_A_DE_ptr() {
         exec_helper<&CPU::handle_opcode_0x1A_LD_A_DE_ptr>();
@@ -4730,22 +6022,22 @@ public:
         exec_helper<&CPU::handle_opcode_0x20_JR_NZ_d>();
     }
     void exec_LD_HL_nn() {
-        exec_helper<&CPU::handle_opcode_0x21_LD_HL_nn>();
+        exec_helper<&CPU::handle_opcode_0x21_LD_HL_nn<IndexMode::HL>>();
     }
     void exec_LD_nn_ptr_HL() {
-        exec_helper<&CPU::handle_opcode_0x22_LD_nn_ptr_HL>();
+        exec_helper<&CPU::handle_opcode_0x22_LD_nn_ptr_HL<IndexMode::HL>>();
     }
     void exec_INC_HL() {
-        exec_helper<&CPU::handle_opcode_0x23_INC_HL>();
+        exec_helper<&CPU::handle_opcode_0x23_INC_HL<IndexMode::HL>>();
     }
     void exec_INC_H() {
-        exec_helper<&CPU::handle_opcode_0x24_INC_H>();
+        exec_helper<&CPU::handle_opcode_0x24_INC_H<IndexMode::HL>>();
     }
     void exec_DEC_H() {
-        exec_helper<&CPU::handle_opcode_0x25_DEC_H>();
+        exec_helper<&CPU::handle_opcode_0x25_DEC_H<IndexMode::HL>>();
     }
     void exec_LD_H_n() {
-        exec_helper<&CPU::handle_opcode_0x26_LD_H_n>();
+        exec_helper<&CPU::handle_opcode_0x26_LD_H_n<IndexMode::HL>>();
     }
     void exec_DAA() {
         exec_helper<&CPU::handle_opcode_0x27_DAA>();
@@ -4754,22 +6046,22 @@ public:
         exec_helper<&CPU::handle_opcode_0x28_JR_Z_d>();
     }
     void exec_ADD_HL_HL() {
-        exec_helper<&CPU::handle_opcode_0x29_ADD_HL_HL>();
+        exec_helper<&CPU::handle_opcode_0x29_ADD_HL_HL<IndexMode::HL>>();
     }
     void exec_LD_HL_nn_ptr() {
-        exec_helper<&CPU::handle_opcode_0x2A_LD_HL_nn_ptr>();
+        exec_helper<&CPU::handle_opcode_0x2A_LD_HL_nn_ptr<IndexMode::HL>>();
     }
     void exec_DEC_HL() {
-        exec_helper<&CPU::handle_opcode_0x2B_DEC_HL>();
+        exec_helper<&CPU::handle_opcode_0x2B_DEC_HL<IndexMode::HL>>();
     }
     void exec_INC_L() {
-        exec_helper<&CPU::handle_opcode_0x2C_INC_L>();
+        exec_helper<&CPU::handle_opcode_0x2C_INC_L<IndexMode::HL>>();
     }
     void exec_DEC_L() {
-        exec_helper<&CPU::handle_opcode_0x2D_DEC_L>();
+        exec_helper<&CPU::handle_opcode_0x2D_DEC_L<IndexMode::HL>>();
     }
     void exec_LD_L_n() {
-        exec_helper<&CPU::handle_opcode_0x2E_LD_L_n>();
+        exec_helper<&CPU::handle_opcode_0x2E_LD_L_n<IndexMode::HL>>();
     }
     void exec_CPL() {
         exec_helper<&CPU::handle_opcode_0x2F_CPL>();
@@ -4787,13 +6079,13 @@ public:
         exec_helper<&CPU::handle_opcode_0x33_INC_SP>();
     }
     void exec_INC_HL_ptr() {
-        exec_helper<&CPU::handle_opcode_0x34_INC_HL_ptr>();
+        exec_helper<&CPU::handle_opcode_0x34_INC_HL_ptr<IndexMode::HL>>();
     }
     void exec_DEC_HL_ptr() {
-        exec_helper<&CPU::handle_opcode_0x35_DEC_HL_ptr>();
+        exec_helper<&CPU::handle_opcode_0x35_DEC_HL_ptr<IndexMode::HL>>();
     }
     void exec_LD_HL_ptr_n() {
-        exec_helper<&CPU::handle_opcode_0x36_LD_HL_ptr_n>();
+        exec_helper<&CPU::handle_opcode_0x36_LD_HL_ptr_n<IndexMode::HL>>();
     }
     void exec_SCF() {
         exec_helper<&CPU::handle_opcode_0x37_SCF>();
@@ -4802,7 +6094,7 @@ public:
         exec_helper<&CPU::handle_opcode_0x38_JR_C_d>();
     }
     void exec_ADD_HL_SP() {
-        exec_helper<&CPU::handle_opcode_0x39_ADD_HL_SP>();
+        exec_helper<&CPU::handle_opcode_0x39_ADD_HL_SP<IndexMode::HL>>();
     }
     void exec_LD_A_nn_ptr() {
         exec_helper<&CPU::handle_opcode_0x3A_LD_A_nn_ptr>();
@@ -4835,13 +6127,13 @@ public:
         exec_helper<&CPU::handle_opcode_0x43_LD_B_E>();
     }
     void exec_LD_B_H() {
-        exec_helper<&CPU::handle_opcode_0x44_LD_B_H>();
+        exec_helper<&CPU::handle_opcode_0x44_LD_B_H<IndexMode::HL>>();
     }
     void exec_LD_B_L() {
-        exec_helper<&CPU::handle_opcode_0x45_LD_B_L>();
+        exec_helper<&CPU::handle_opcode_0x45_LD_B_L<IndexMode::HL>>();
     }
     void exec_LD_B_HL_ptr() {
-        exec_helper<&CPU::handle_opcode_0x46_LD_B_HL_ptr>();
+        exec_helper<&CPU::handle_opcode_0x46_LD_B_HL_ptr<IndexMode::HL>>();
     }
     void exec_LD_B_A() {
         exec_helper<&CPU::handle_opcode_0x47_LD_B_A>();
@@ -4859,13 +6151,13 @@ public:
         exec_helper<&CPU::handle_opcode_0x4B_LD_C_E>();
     }
     void exec_LD_C_H() {
-        exec_helper<&CPU::handle_opcode_0x4C_LD_C_H>();
+        exec_helper<&CPU::handle_opcode_0x4C_LD_C_H<IndexMode::HL>>();
     }
     void exec_LD_C_L() {
-        exec_helper<&CPU::handle_opcode_0x4D_LD_C_L>();
+        exec_helper<&CPU::handle_opcode_0x4D_LD_C_L<IndexMode::HL>>();
     }
     void exec_LD_C_HL_ptr() {
-        exec_helper<&CPU::handle_opcode_0x4E_LD_C_HL_ptr>();
+        exec_helper<&CPU::handle_opcode_0x4E_LD_C_HL_ptr<IndexMode::HL>>();
     }
     void exec_LD_C_A() {
         exec_helper<&CPU::handle_opcode_0x4F_LD_C_A>();
@@ -4883,13 +6175,13 @@ public:
         exec_helper<&CPU::handle_opcode_0x53_LD_D_E>();
     }
     void exec_LD_D_H() {
-        exec_helper<&CPU::handle_opcode_0x54_LD_D_H>();
+        exec_helper<&CPU::handle_opcode_0x54_LD_D_H<IndexMode::HL>>();
     }
     void exec_LD_D_L() {
-        exec_helper<&CPU::handle_opcode_0x55_LD_D_L>();
+        exec_helper<&CPU::handle_opcode_0x55_LD_D_L<IndexMode::HL>>();
     }
     void exec_LD_D_HL_ptr() {
-        exec_helper<&CPU::handle_opcode_0x56_LD_D_HL_ptr>();
+        exec_helper<&CPU::handle_opcode_0x56_LD_D_HL_ptr<IndexMode::HL>>();
     }
     void exec_LD_D_A() {
         exec_helper<&CPU::handle_opcode_0x57_LD_D_A>();
@@ -4907,88 +6199,88 @@ public:
         exec_helper<&CPU::handle_opcode_0x5B_LD_E_E>();
     }
     void exec_LD_E_H() {
-        exec_helper<&CPU::handle_opcode_0x5C_LD_E_H>();
+        exec_helper<&CPU::handle_opcode_0x5C_LD_E_H<IndexMode::HL>>();
     }
     void exec_LD_E_L() {
-        exec_helper<&CPU::handle_opcode_0x5D_LD_E_L>();
+        exec_helper<&CPU::handle_opcode_0x5D_LD_E_L<IndexMode::HL>>();
     }
     void exec_LD_E_HL_ptr() {
-        exec_helper<&CPU::handle_opcode_0x5E_LD_E_HL_ptr>();
+        exec_helper<&CPU::handle_opcode_0x5E_LD_E_HL_ptr<IndexMode::HL>>();
     }
     void exec_LD_E_A() {
         exec_helper<&CPU::handle_opcode_0x5F_LD_E_A>();
     }
     void exec_LD_H_B() {
-        exec_helper<&CPU::handle_opcode_0x60_LD_H_B>();
+        exec_helper<&CPU::handle_opcode_0x60_LD_H_B<IndexMode::HL>>();
     }
     void exec_LD_H_C() {
-        exec_helper<&CPU::handle_opcode_0x61_LD_H_C>();
+        exec_helper<&CPU::handle_opcode_0x61_LD_H_C<IndexMode::HL>>();
     }
     void exec_LD_H_D() {
-        exec_helper<&CPU::handle_opcode_0x62_LD_H_D>();
+        exec_helper<&CPU::handle_opcode_0x62_LD_H_D<IndexMode::HL>>();
     }
     void exec_LD_H_E() {
-        exec_helper<&CPU::handle_opcode_0x63_LD_H_E>();
+        exec_helper<&CPU::handle_opcode_0x63_LD_H_E<IndexMode::HL>>();
     }
     void exec_LD_H_H() {
         exec_helper<&CPU::handle_opcode_0x64_LD_H_H>();
     }
     void exec_LD_H_L() {
-        exec_helper<&CPU::handle_opcode_0x65_LD_H_L>();
+        exec_helper<&CPU::handle_opcode_0x65_LD_H_L<IndexMode::HL>>();
     }
     void exec_LD_H_HL_ptr() {
-        exec_helper<&CPU::handle_opcode_0x66_LD_H_HL_ptr>();
+        exec_helper<&CPU::handle_opcode_0x66_LD_H_HL_ptr<IndexMode::HL>>();
     }
     void exec_LD_H_A() {
-        exec_helper<&CPU::handle_opcode_0x67_LD_H_A>();
+        exec_helper<&CPU::handle_opcode_0x67_LD_H_A<IndexMode::HL>>();
     }
     void exec_LD_L_B() {
-        exec_helper<&CPU::handle_opcode_0x68_LD_L_B>();
+        exec_helper<&CPU::handle_opcode_0x68_LD_L_B<IndexMode::HL>>();
     }
     void exec_LD_L_C() {
-        exec_helper<&CPU::handle_opcode_0x69_LD_L_C>();
+        exec_helper<&CPU::handle_opcode_0x69_LD_L_C<IndexMode::HL>>();
     }
     void exec_LD_L_D() {
-        exec_helper<&CPU::handle_opcode_0x6A_LD_L_D>();
+        exec_helper<&CPU::handle_opcode_0x6A_LD_L_D<IndexMode::HL>>();
     }
     void exec_LD_L_E() {
-        exec_helper<&CPU::handle_opcode_0x6B_LD_L_E>();
+        exec_helper<&CPU::handle_opcode_0x6B_LD_L_E<IndexMode::HL>>();
     }
     void exec_LD_L_H() {
-        exec_helper<&CPU::handle_opcode_0x6C_LD_L_H>();
+        exec_helper<&CPU::handle_opcode_0x6C_LD_L_H<IndexMode::HL>>();
     }
     void exec_LD_L_L() {
         exec_helper<&CPU::handle_opcode_0x6D_LD_L_L>();
     }
     void exec_LD_L_HL_ptr() {
-        exec_helper<&CPU::handle_opcode_0x6E_LD_L_HL_ptr>();
+        exec_helper<&CPU::handle_opcode_0x6E_LD_L_HL_ptr<IndexMode::HL>>();
     }
     void exec_LD_L_A() {
-        exec_helper<&CPU::handle_opcode_0x6F_LD_L_A>();
+        exec_helper<&CPU::handle_opcode_0x6F_LD_L_A<IndexMode::HL>>();
     }
     void exec_LD_HL_ptr_B() {
-        exec_helper<&CPU::handle_opcode_0x70_LD_HL_ptr_B>();
+        exec_helper<&CPU::handle_opcode_0x70_LD_HL_ptr_B<IndexMode::HL>>();
     }
     void exec_LD_HL_ptr_C() {
-        exec_helper<&CPU::handle_opcode_0x71_LD_HL_ptr_C>();
+        exec_helper<&CPU::handle_opcode_0x71_LD_HL_ptr_C<IndexMode::HL>>();
     }
     void exec_LD_HL_ptr_D() {
-        exec_helper<&CPU::handle_opcode_0x72_LD_HL_ptr_D>();
+        exec_helper<&CPU::handle_opcode_0x72_LD_HL_ptr_D<IndexMode::HL>>();
     }
     void exec_LD_HL_ptr_E() {
-        exec_helper<&CPU::handle_opcode_0x73_LD_HL_ptr_E>();
+        exec_helper<&CPU::handle_opcode_0x73_LD_HL_ptr_E<IndexMode::HL>>();
     }
     void exec_LD_HL_ptr_H() {
-        exec_helper<&CPU::handle_opcode_0x74_LD_HL_ptr_H>();
+        exec_helper<&CPU::handle_opcode_0x74_LD_HL_ptr_H<IndexMode::HL>>();
     }
     void exec_LD_HL_ptr_L() {
-        exec_helper<&CPU::handle_opcode_0x75_LD_HL_ptr_L>();
+        exec_helper<&CPU::handle_opcode_0x75_LD_HL_ptr_L<IndexMode::HL>>();
     }
     void exec_HALT() {
         exec_helper<&CPU::handle_opcode_0x76_HALT>();
     }
     void exec_LD_HL_ptr_A() {
-        exec_helper<&CPU::handle_opcode_0x77_LD_HL_ptr_A>();
+        exec_helper<&CPU::handle_opcode_0x77_LD_HL_ptr_A<IndexMode::HL>>();
     }
     void exec_LD_A_B() {
         exec_helper<&CPU::handle_opcode_0x78_LD_A_B>();
@@ -5003,13 +6295,13 @@ public:
         exec_helper<&CPU::handle_opcode_0x7B_LD_A_E>();
     }
     void exec_LD_A_H() {
-        exec_helper<&CPU::handle_opcode_0x7C_LD_A_H>();
+        exec_helper<&CPU::handle_opcode_0x7C_LD_A_H<IndexMode::HL>>();
     }
     void exec_LD_A_L() {
-        exec_helper<&CPU::handle_opcode_0x7D_LD_A_L>();
+        exec_helper<&CPU::handle_opcode_0x7D_LD_A_L<IndexMode::HL>>();
     }
     void exec_LD_A_HL_ptr() {
-        exec_helper<&CPU::handle_opcode_0x7E_LD_A_HL_ptr>();
+        exec_helper<&CPU::handle_opcode_0x7E_LD_A_HL_ptr<IndexMode::HL>>();
     }
     void exec_LD_A_A() {
         exec_helper<&CPU::handle_opcode_0x7F_LD_A_A>();
@@ -5027,13 +6319,13 @@ public:
         exec_helper<&CPU::handle_opcode_0x83_ADD_A_E>();
     }
     void exec_ADD_A_H() {
-        exec_helper<&CPU::handle_opcode_0x84_ADD_A_H>();
+        exec_helper<&CPU::handle_opcode_0x84_ADD_A_H<IndexMode::HL>>();
     }
     void exec_ADD_A_L() {
-        exec_helper<&CPU::handle_opcode_0x85_ADD_A_L>();
+        exec_helper<&CPU::handle_opcode_0x85_ADD_A_L<IndexMode::HL>>();
     }
     void exec_ADD_A_HL_ptr() {
-        exec_helper<&CPU::handle_opcode_0x86_ADD_A_HL_ptr>();
+        exec_helper<&CPU::handle_opcode_0x86_ADD_A_HL_ptr<IndexMode::HL>>();
     }
     void exec_ADD_A_A() {
         exec_helper<&CPU::handle_opcode_0x87_ADD_A_A>();
@@ -5051,13 +6343,13 @@ public:
         exec_helper<&CPU::handle_opcode_0x8B_ADC_A_E>();
     }
     void exec_ADC_A_H() {
-        exec_helper<&CPU::handle_opcode_0x8C_ADC_A_H>();
+        exec_helper<&CPU::handle_opcode_0x8C_ADC_A_H<IndexMode::HL>>();
     }
     void exec_ADC_A_L() {
-        exec_helper<&CPU::handle_opcode_0x8D_ADC_A_L>();
+        exec_helper<&CPU::handle_opcode_0x8D_ADC_A_L<IndexMode::HL>>();
     }
     void exec_ADC_A_HL_ptr() {
-        exec_helper<&CPU::handle_opcode_0x8E_ADC_A_HL_ptr>();
+        exec_helper<&CPU::handle_opcode_0x8E_ADC_A_HL_ptr<IndexMode::HL>>();
     }
     void exec_ADC_A_A() {
         exec_helper<&CPU::handle_opcode_0x8F_ADC_A_A>();
@@ -5075,13 +6367,13 @@ public:
         exec_helper<&CPU::handle_opcode_0x93_SUB_E>();
     }
     void exec_SUB_H() {
-        exec_helper<&CPU::handle_opcode_0x94_SUB_H>();
+        exec_helper<&CPU::handle_opcode_0x94_SUB_H<IndexMode::HL>>();
     }
     void exec_SUB_L() {
-        exec_helper<&CPU::handle_opcode_0x95_SUB_L>();
+        exec_helper<&CPU::handle_opcode_0x95_SUB_L<IndexMode::HL>>();
     }
     void exec_SUB_HL_ptr() {
-        exec_helper<&CPU::handle_opcode_0x96_SUB_HL_ptr>();
+        exec_helper<&CPU::handle_opcode_0x96_SUB_HL_ptr<IndexMode::HL>>();
     }
     void exec_SUB_A() {
         exec_helper<&CPU::handle_opcode_0x97_SUB_A>();
@@ -5099,13 +6391,13 @@ public:
         exec_helper<&CPU::handle_opcode_0x9B_SBC_A_E>();
     }
     void exec_SBC_A_H() {
-        exec_helper<&CPU::handle_opcode_0x9C_SBC_A_H>();
+        exec_helper<&CPU::handle_opcode_0x9C_SBC_A_H<IndexMode::HL>>();
     }
     void exec_SBC_A_L() {
-        exec_helper<&CPU::handle_opcode_0x9D_SBC_A_L>();
+        exec_helper<&CPU::handle_opcode_0x9D_SBC_A_L<IndexMode::HL>>();
     }
     void exec_SBC_A_HL_ptr() {
-        exec_helper<&CPU::handle_opcode_0x9E_SBC_A_HL_ptr>();
+        exec_helper<&CPU::handle_opcode_0x9E_SBC_A_HL_ptr<IndexMode::HL>>();
     }
     void exec_SBC_A_A() {
         exec_helper<&CPU::handle_opcode_0x9F_SBC_A_A>();
@@ -5123,13 +6415,13 @@ public:
         exec_helper<&CPU::handle_opcode_0xA3_AND_E>();
     }
     void exec_AND_H() {
-        exec_helper<&CPU::handle_opcode_0xA4_AND_H>();
+        exec_helper<&CPU::handle_opcode_0xA4_AND_H<IndexMode::HL>>();
     }
     void exec_AND_L() {
-        exec_helper<&CPU::handle_opcode_0xA5_AND_L>();
+        exec_helper<&CPU::handle_opcode_0xA5_AND_L<IndexMode::HL>>();
     }
     void exec_AND_HL_ptr() {
-        exec_helper<&CPU::handle_opcode_0xA6_AND_HL_ptr>();
+        exec_helper<&CPU::handle_opcode_0xA6_AND_HL_ptr<IndexMode::HL>>();
     }
     void exec_AND_A() {
         exec_helper<&CPU::handle_opcode_0xA7_AND_A>();
@@ -5147,13 +6439,13 @@ public:
         exec_helper<&CPU::handle_opcode_0xAB_XOR_E>();
     }
     void exec_XOR_H() {
-        exec_helper<&CPU::handle_opcode_0xAC_XOR_H>();
+        exec_helper<&CPU::handle_opcode_0xAC_XOR_H<IndexMode::HL>>();
     }
     void exec_XOR_L() {
-        exec_helper<&CPU::handle_opcode_0xAD_XOR_L>();
+        exec_helper<&CPU::handle_opcode_0xAD_XOR_L<IndexMode::HL>>();
     }
     void exec_XOR_HL_ptr() {
-        exec_helper<&CPU::handle_opcode_0xAE_XOR_HL_ptr>();
+        exec_helper<&CPU::handle_opcode_0xAE_XOR_HL_ptr<IndexMode::HL>>();
     }
     void exec_XOR_A() {
         exec_helper<&CPU::handle_opcode_0xAF_XOR_A>();
@@ -5171,13 +6463,13 @@ public:
         exec_helper<&CPU::handle_opcode_0xB3_OR_E>();
     }
     void exec_OR_H() {
-        exec_helper<&CPU::handle_opcode_0xB4_OR_H>();
+        exec_helper<&CPU::handle_opcode_0xB4_OR_H<IndexMode::HL>>();
     }
     void exec_OR_L() {
-        exec_helper<&CPU::handle_opcode_0xB5_OR_L>();
+        exec_helper<&CPU::handle_opcode_0xB5_OR_L<IndexMode::HL>>();
     }
     void exec_OR_HL_ptr() {
-        exec_helper<&CPU::handle_opcode_0xB6_OR_HL_ptr>();
+        exec_helper<&CPU::handle_opcode_0xB6_OR_HL_ptr<IndexMode::HL>>();
     }
     void exec_OR_A() {
         exec_helper<&CPU::handle_opcode_0xB7_OR_A>();
@@ -5195,13 +6487,13 @@ public:
         exec_helper<&CPU::handle_opcode_0xBB_CP_E>();
     }
     void exec_CP_H() {
-        exec_helper<&CPU::handle_opcode_0xBC_CP_H>();
+        exec_helper<&CPU::handle_opcode_0xBC_CP_H<IndexMode::HL>>();
     }
     void exec_CP_L() {
-        exec_helper<&CPU::handle_opcode_0xBD_CP_L>();
+        exec_helper<&CPU::handle_opcode_0xBD_CP_L<IndexMode::HL>>();
     }
     void exec_CP_HL_ptr() {
-        exec_helper<&CPU::handle_opcode_0xBE_CP_HL_ptr>();
+        exec_helper<&CPU::handle_opcode_0xBE_CP_HL_ptr<IndexMode::HL>>();
     }
     void exec_CP_A() {
         exec_helper<&CPU::handle_opcode_0xBF_CP_A>();
@@ -5300,19 +6592,19 @@ public:
         exec_helper<&CPU::handle_opcode_0xE0_RET_PO>();
     }
     void exec_POP_HL() {
-        exec_helper<&CPU::handle_opcode_0xE1_POP_HL>();
+        exec_helper<&CPU::handle_opcode_0xE1_POP_HL<IndexMode::HL>>();
     }
     void exec_JP_PO_nn() {
         exec_helper<&CPU::handle_opcode_0xE2_JP_PO_nn>();
     }
     void exec_EX_SP_ptr_HL() {
-        exec_helper<&CPU::handle_opcode_0xE3_EX_SP_ptr_HL>();
+        exec_helper<&CPU::handle_opcode_0xE3_EX_SP_ptr_HL<IndexMode::HL>>();
     }
     void exec_CALL_PO_nn() {
         exec_helper<&CPU::handle_opcode_0xE4_CALL_PO_nn>();
     }
     void exec_PUSH_HL() {
-        exec_helper<&CPU::handle_opcode_0xE5_PUSH_HL>();
+        exec_helper<&CPU::handle_opcode_0xE5_PUSH_HL<IndexMode::HL>>();
     }
     void exec_AND_n() {
         exec_helper<&CPU::handle_opcode_0xE6_AND_n>();
@@ -5324,7 +6616,7 @@ public:
         exec_helper<&CPU::handle_opcode_0xE8_RET_PE>();
     }
     void exec_JP_HL_ptr() {
-        exec_helper<&CPU::handle_opcode_0xE9_JP_HL_ptr>();
+        exec_helper<&CPU::handle_opcode_0xE9_JP_HL_ptr<IndexMode::HL>>();
     }
     void exec_JP_PE_nn() {
         exec_helper<&CPU::handle_opcode_0xEA_JP_PE_nn>();
@@ -5369,7 +6661,7 @@ public:
         exec_helper<&CPU::handle_opcode_0xF8_RET_M>();
     }
     void exec_LD_SP_HL() {
-        exec_helper<&CPU::handle_opcode_0xF9_LD_SP_HL>();
+        exec_helper<&CPU::handle_opcode_0xF9_LD_SP_HL<IndexMode::HL>>();
     }
     void exec_JP_M_nn() {
         exec_helper<&CPU::handle_opcode_0xFA_JP_M_nn>();
@@ -5388,516 +6680,516 @@ public:
     }
     // --- DD Prefixed Opcodes (IX) ---
     void exec_ADD_IX_BC() {
-        exec_DD_helper<&CPU::handle_opcode_0x09_ADD_HL_BC>();
+        exec_DD_helper<&CPU::handle_opcode_0x09_ADD_HL_BC<IndexMode::IX>>();
     }
     void exec_ADD_IX_DE() {
-        exec_DD_helper<&CPU::handle_opcode_0x19_ADD_HL_DE>();
+        exec_DD_helper<&CPU::handle_opcode_0x19_ADD_HL_DE<IndexMode::IX>>();
     }
     void exec_LD_IX_nn() {
-        exec_DD_helper<&CPU::handle_opcode_0x21_LD_HL_nn>();
+        exec_DD_helper<&CPU::handle_opcode_0x21_LD_HL_nn<IndexMode::IX>>();
     }
     void exec_LD_nn_ptr_IX() {
-        exec_DD_helper<&CPU::handle_opcode_0x22_LD_nn_ptr_HL>();
+        exec_DD_helper<&CPU::handle_opcode_0x22_LD_nn_ptr_HL<IndexMode::IX>>();
     }
     void exec_INC_IX() {
-        exec_DD_helper<&CPU::handle_opcode_0x23_INC_HL>();
+        exec_DD_helper<&CPU::handle_opcode_0x23_INC_HL<IndexMode::IX>>();
     }
     void exec_INC_IXH() {
-        exec_DD_helper<&CPU::handle_opcode_0x24_INC_H>();
+        exec_DD_helper<&CPU::handle_opcode_0x24_INC_H<IndexMode::IX>>();
     }
     void exec_DEC_IXH() {
-        exec_DD_helper<&CPU::handle_opcode_0x25_DEC_H>();
+        exec_DD_helper<&CPU::handle_opcode_0x25_DEC_H<IndexMode::IX>>();
     }
     void exec_LD_IXH_n() {
-        exec_DD_helper<&CPU::handle_opcode_0x26_LD_H_n>();
+        exec_DD_helper<&CPU::handle_opcode_0x26_LD_H_n<IndexMode::IX>>();
     }
     void exec_ADD_IX_IX() {
-        exec_DD_helper<&CPU::handle_opcode_0x29_ADD_HL_HL>();
+        exec_DD_helper<&CPU::handle_opcode_0x29_ADD_HL_HL<IndexMode::IX>>();
     }
     void exec_LD_IX_nn_ptr() {
-        exec_DD_helper<&CPU::handle_opcode_0x2A_LD_HL_nn_ptr>();
+        exec_DD_helper<&CPU::handle_opcode_0x2A_LD_HL_nn_ptr<IndexMode::IX>>();
     }
     void exec_DEC_IX() {
-        exec_DD_helper<&CPU::handle_opcode_0x2B_DEC_HL>();
+        exec_DD_helper<&CPU::handle_opcode_0x2B_DEC_HL<IndexMode::IX>>();
     }
     void exec_INC_IXL() {
-        exec_DD_helper<&CPU::handle_opcode_0x2C_INC_L>();
+        exec_DD_helper<&CPU::handle_opcode_0x2C_INC_L<IndexMode::IX>>();
     }
     void exec_DEC_IXL() {
-        exec_DD_helper<&CPU::handle_opcode_0x2D_DEC_L>();
+        exec_DD_helper<&CPU::handle_opcode_0x2D_DEC_L<IndexMode::IX>>();
     }
     void exec_LD_IXL_n() {
-        exec_DD_helper<&CPU::handle_opcode_0x2E_LD_L_n>();
+        exec_DD_helper<&CPU::handle_opcode_0x2E_LD_L_n<IndexMode::IX>>();
     }
     void exec_INC_IX_d_ptr() {
-        exec_DD_helper<&CPU::handle_opcode_0x34_INC_HL_ptr>();
+        exec_DD_helper<&CPU::handle_opcode_0x34_INC_HL_ptr<IndexMode::IX>>();
     }
     void exec_DEC_IX_d_ptr() {
-        exec_DD_helper<&CPU::handle_opcode_0x35_DEC_HL_ptr>();
+        exec_DD_helper<&CPU::handle_opcode_0x35_DEC_HL_ptr<IndexMode::IX>>();
     }
     void exec_LD_IX_d_ptr_n() {
-        exec_DD_helper<&CPU::handle_opcode_0x36_LD_HL_ptr_n>();
+        exec_DD_helper<&CPU::handle_opcode_0x36_LD_HL_ptr_n<IndexMode::IX>>();
     }
     void exec_ADD_IX_SP() {
-        exec_DD_helper<&CPU::handle_opcode_0x39_ADD_HL_SP>();
+        exec_DD_helper<&CPU::handle_opcode_0x39_ADD_HL_SP<IndexMode::IX>>();
     }
     void exec_LD_B_IXH() {
-        exec_DD_helper<&CPU::handle_opcode_0x44_LD_B_H>();
+        exec_DD_helper<&CPU::handle_opcode_0x44_LD_B_H<IndexMode::IX>>();
     }
     void exec_LD_B_IXL() {
-        exec_DD_helper<&CPU::handle_opcode_0x45_LD_B_L>();
+        exec_DD_helper<&CPU::handle_opcode_0x45_LD_B_L<IndexMode::IX>>();
     }
     void exec_LD_B_IX_d_ptr() {
-        exec_DD_helper<&CPU::handle_opcode_0x46_LD_B_HL_ptr>();
+        exec_DD_helper<&CPU::handle_opcode_0x46_LD_B_HL_ptr<IndexMode::IX>>();
     }
     void exec_LD_C_IXH() {
-        exec_DD_helper<&CPU::handle_opcode_0x4C_LD_C_H>();
+        exec_DD_helper<&CPU::handle_opcode_0x4C_LD_C_H<IndexMode::IX>>();
     }
     void exec_LD_C_IXL() {
-        exec_DD_helper<&CPU::handle_opcode_0x4D_LD_C_L>();
+        exec_DD_helper<&CPU::handle_opcode_0x4D_LD_C_L<IndexMode::IX>>();
     }
     void exec_LD_C_IX_d_ptr() {
-        exec_DD_helper<&CPU::handle_opcode_0x4E_LD_C_HL_ptr>();
+        exec_DD_helper<&CPU::handle_opcode_0x4E_LD_C_HL_ptr<IndexMode::IX>>();
     }
     void exec_LD_D_IXH() {
-        exec_DD_helper<&CPU::handle_opcode_0x54_LD_D_H>();
+        exec_DD_helper<&CPU::handle_opcode_0x54_LD_D_H<IndexMode::IX>>();
     }
     void exec_LD_D_IXL() {
-        exec_DD_helper<&CPU::handle_opcode_0x55_LD_D_L>();
+        exec_DD_helper<&CPU::handle_opcode_0x55_LD_D_L<IndexMode::IX>>();
     }
     void exec_LD_D_IX_d_ptr() {
-        exec_DD_helper<&CPU::handle_opcode_0x56_LD_D_HL_ptr>();
+        exec_DD_helper<&CPU::handle_opcode_0x56_LD_D_HL_ptr<IndexMode::IX>>();
     }
     void exec_LD_E_IXH() {
-        exec_DD_helper<&CPU::handle_opcode_0x5C_LD_E_H>();
+        exec_DD_helper<&CPU::handle_opcode_0x5C_LD_E_H<IndexMode::IX>>();
     }
     void exec_LD_E_IXL() {
-        exec_DD_helper<&CPU::handle_opcode_0x5D_LD_E_L>();
+        exec_DD_helper<&CPU::handle_opcode_0x5D_LD_E_L<IndexMode::IX>>();
     }
     void exec_LD_E_IX_d_ptr() {
-        exec_DD_helper<&CPU::handle_opcode_0x5E_LD_E_HL_ptr>();
+        exec_DD_helper<&CPU::handle_opcode_0x5E_LD_E_HL_ptr<IndexMode::IX>>();
     }
     void exec_LD_IXH_B() {
-        exec_DD_helper<&CPU::handle_opcode_0x60_LD_H_B>();
+        exec_DD_helper<&CPU::handle_opcode_0x60_LD_H_B<IndexMode::IX>>();
     }
     void exec_LD_IXH_C() {
-        exec_DD_helper<&CPU::handle_opcode_0x61_LD_H_C>();
+        exec_DD_helper<&CPU::handle_opcode_0x61_LD_H_C<IndexMode::IX>>();
     }
     void exec_LD_IXH_D() {
-        exec_DD_helper<&CPU::handle_opcode_0x62_LD_H_D>();
+        exec_DD_helper<&CPU::handle_opcode_0x62_LD_H_D<IndexMode::IX>>();
     }
     void exec_LD_IXH_E() {
-        exec_DD_helper<&CPU::handle_opcode_0x63_LD_H_E>();
+        exec_DD_helper<&CPU::handle_opcode_0x63_LD_H_E<IndexMode::IX>>();
     }
     void exec_LD_IXH_IXH() {
         exec_DD_helper<&CPU::handle_opcode_0x64_LD_H_H>();
     }
     void exec_LD_IXH_IXL() {
-        exec_DD_helper<&CPU::handle_opcode_0x65_LD_H_L>();
+        exec_DD_helper<&CPU::handle_opcode_0x65_LD_H_L<IndexMode::IX>>();
     }
     void exec_LD_H_IX_d_ptr() {
-        exec_DD_helper<&CPU::handle_opcode_0x66_LD_H_HL_ptr>();
+        exec_DD_helper<&CPU::handle_opcode_0x66_LD_H_HL_ptr<IndexMode::IX>>();
     }
     void exec_LD_IXH_A() {
-        exec_DD_helper<&CPU::handle_opcode_0x67_LD_H_A>();
+        exec_DD_helper<&CPU::handle_opcode_0x67_LD_H_A<IndexMode::IX>>();
     }
     void exec_LD_IXL_B() {
-        exec_DD_helper<&CPU::handle_opcode_0x68_LD_L_B>();
+        exec_DD_helper<&CPU::handle_opcode_0x68_LD_L_B<IndexMode::IX>>();
     }
     void exec_LD_IXL_C() {
-        exec_DD_helper<&CPU::handle_opcode_0x69_LD_L_C>();
+        exec_DD_helper<&CPU::handle_opcode_0x69_LD_L_C<IndexMode::IX>>();
     }
     void exec_LD_IXL_D() {
-        exec_DD_helper<&CPU::handle_opcode_0x6A_LD_L_D>();
+        exec_DD_helper<&CPU::handle_opcode_0x6A_LD_L_D<IndexMode::IX>>();
     }
     void exec_LD_IXL_E() {
-        exec_DD_helper<&CPU::handle_opcode_0x6B_LD_L_E>();
+        exec_DD_helper<&CPU::handle_opcode_0x6B_LD_L_E<IndexMode::IX>>();
     }
     void exec_LD_IXL_IXH() {
-        exec_DD_helper<&CPU::handle_opcode_0x6C_LD_L_H>();
+        exec_DD_helper<&CPU::handle_opcode_0x6C_LD_L_H<IndexMode::IX>>();
     }
     void exec_LD_IXL_IXL() {
         exec_DD_helper<&CPU::handle_opcode_0x6D_LD_L_L>();
     }
     void exec_LD_L_IX_d_ptr() {
-        exec_DD_helper<&CPU::handle_opcode_0x6E_LD_L_HL_ptr>();
+        exec_DD_helper<&CPU::handle_opcode_0x6E_LD_L_HL_ptr<IndexMode::IX>>();
     }
     void exec_LD_IXL_A() {
-        exec_DD_helper<&CPU::handle_opcode_0x6F_LD_L_A>();
+        exec_DD_helper<&CPU::handle_opcode_0x6F_LD_L_A<IndexMode::IX>>();
     }
     void exec_LD_IX_d_ptr_B() {
-        exec_DD_helper<&CPU::handle_opcode_0x70_LD_HL_ptr_B>();
+        exec_DD_helper<&CPU::handle_opcode_0x70_LD_HL_ptr_B<IndexMode::IX>>();
     }
     void exec_LD_IX_d_ptr_C() {
-        exec_DD_helper<&CPU::handle_opcode_0x71_LD_HL_ptr_C>();
+        exec_DD_helper<&CPU::handle_opcode_0x71_LD_HL_ptr_C<IndexMode::IX>>();
     }
     void exec_LD_IX_d_ptr_D() {
-        exec_DD_helper<&CPU::handle_opcode_0x72_LD_HL_ptr_D>();
+        exec_DD_helper<&CPU::handle_opcode_0x72_LD_HL_ptr_D<IndexMode::IX>>();
     }
     void exec_LD_IX_d_ptr_E() {
-        exec_DD_helper<&CPU::handle_opcode_0x73_LD_HL_ptr_E>();
+        exec_DD_helper<&CPU::handle_opcode_0x73_LD_HL_ptr_E<IndexMode::IX>>();
     }
     void exec_LD_IX_d_ptr_H() {
-        exec_DD_helper<&CPU::handle_opcode_0x74_LD_HL_ptr_H>();
+        exec_DD_helper<&CPU::handle_opcode_0x74_LD_HL_ptr_H<IndexMode::IX>>();
     }
     void exec_LD_IX_d_ptr_L() {
-        exec_DD_helper<&CPU::handle_opcode_0x75_LD_HL_ptr_L>();
+        exec_DD_helper<&CPU::handle_opcode_0x75_LD_HL_ptr_L<IndexMode::IX>>();
     }
     void exec_LD_IX_d_ptr_A() {
-        exec_DD_helper<&CPU::handle_opcode_0x77_LD_HL_ptr_A>();
+        exec_DD_helper<&CPU::handle_opcode_0x77_LD_HL_ptr_A<IndexMode::IX>>();
     }
     void exec_LD_A_IXH() {
-        exec_DD_helper<&CPU::handle_opcode_0x7C_LD_A_H>();
+        exec_DD_helper<&CPU::handle_opcode_0x7C_LD_A_H<IndexMode::IX>>();
     }
     void exec_LD_A_IXL() {
-        exec_DD_helper<&CPU::handle_opcode_0x7D_LD_A_L>();
+        exec_DD_helper<&CPU::handle_opcode_0x7D_LD_A_L<IndexMode::IX>>();
     }
     void exec_LD_A_IX_d_ptr() {
-        exec_DD_helper<&CPU::handle_opcode_0x7E_LD_A_HL_ptr>();
+        exec_DD_helper<&CPU::handle_opcode_0x7E_LD_A_HL_ptr<IndexMode::IX>>();
     }
     void exec_ADD_A_IXH() {
-        exec_DD_helper<&CPU::handle_opcode_0x84_ADD_A_H>();
+        exec_DD_helper<&CPU::handle_opcode_0x84_ADD_A_H<IndexMode::IX>>();
     }
     void exec_ADD_A_IXL() {
-        exec_DD_helper<&CPU::handle_opcode_0x85_ADD_A_L>();
+        exec_DD_helper<&CPU::handle_opcode_0x85_ADD_A_L<IndexMode::IX>>();
     }
     void exec_ADD_A_IX_d_ptr() {
-        exec_DD_helper<&CPU::handle_opcode_0x86_ADD_A_HL_ptr>();
+        exec_DD_helper<&CPU::handle_opcode_0x86_ADD_A_HL_ptr<IndexMode::IX>>();
     }
     void exec_ADC_A_IXH() {
-        exec_DD_helper<&CPU::handle_opcode_0x8C_ADC_A_H>();
+        exec_DD_helper<&CPU::handle_opcode_0x8C_ADC_A_H<IndexMode::IX>>();
     }
     void exec_ADC_A_IXL() {
-        exec_DD_helper<&CPU::handle_opcode_0x8D_ADC_A_L>();
+        exec_DD_helper<&CPU::handle_opcode_0x8D_ADC_A_L<IndexMode::IX>>();
     }
     void exec_ADC_A_IX_d_ptr() {
-        exec_DD_helper<&CPU::handle_opcode_0x8E_ADC_A_HL_ptr>();
+        exec_DD_helper<&CPU::handle_opcode_0x8E_ADC_A_HL_ptr<IndexMode::IX>>();
     }
     void exec_SUB_IXH() {
-        exec_DD_helper<&CPU::handle_opcode_0x94_SUB_H>();
+        exec_DD_helper<&CPU::handle_opcode_0x94_SUB_H<IndexMode::IX>>();
     }
     void exec_SUB_IXL() {
-        exec_DD_helper<&CPU::handle_opcode_0x95_SUB_L>();
+        exec_DD_helper<&CPU::handle_opcode_0x95_SUB_L<IndexMode::IX>>();
     }
     void exec_SUB_IX_d_ptr() {
-        exec_DD_helper<&CPU::handle_opcode_0x96_SUB_HL_ptr>();
+        exec_DD_helper<&CPU::handle_opcode_0x96_SUB_HL_ptr<IndexMode::IX>>();
     }
     void exec_SBC_A_IXH() {
-        exec_DD_helper<&CPU::handle_opcode_0x9C_SBC_A_H>();
+        exec_DD_helper<&CPU::handle_opcode_0x9C_SBC_A_H<IndexMode::IX>>();
     }
     void exec_SBC_A_IXL() {
-        exec_DD_helper<&CPU::handle_opcode_0x9D_SBC_A_L>();
+        exec_DD_helper<&CPU::handle_opcode_0x9D_SBC_A_L<IndexMode::IX>>();
     }
     void exec_SBC_A_IX_d_ptr() {
-        exec_DD_helper<&CPU::handle_opcode_0x9E_SBC_A_HL_ptr>();
+        exec_DD_helper<&CPU::handle_opcode_0x9E_SBC_A_HL_ptr<IndexMode::IX>>();
     }
     void exec_AND_IXH() {
-        exec_DD_helper<&CPU::handle_opcode_0xA4_AND_H>();
+        exec_DD_helper<&CPU::handle_opcode_0xA4_AND_H<IndexMode::IX>>();
     }
     void exec_AND_IXL() {
-        exec_DD_helper<&CPU::handle_opcode_0xA5_AND_L>();
+        exec_DD_helper<&CPU::handle_opcode_0xA5_AND_L<IndexMode::IX>>();
     }
     void exec_AND_IX_d_ptr() {
-        exec_DD_helper<&CPU::handle_opcode_0xA6_AND_HL_ptr>();
+        exec_DD_helper<&CPU::handle_opcode_0xA6_AND_HL_ptr<IndexMode::IX>>();
     }
     void exec_XOR_IXH() {
-        exec_DD_helper<&CPU::handle_opcode_0xAC_XOR_H>();
+        exec_DD_helper<&CPU::handle_opcode_0xAC_XOR_H<IndexMode::IX>>();
     }
     void exec_XOR_IXL() {
-        exec_DD_helper<&CPU::handle_opcode_0xAD_XOR_L>();
+        exec_DD_helper<&CPU::handle_opcode_0xAD_XOR_L<IndexMode::IX>>();
     }
     void exec_XOR_IX_d_ptr() {
-        exec_DD_helper<&CPU::handle_opcode_0xAE_XOR_HL_ptr>();
+        exec_DD_helper<&CPU::handle_opcode_0xAE_XOR_HL_ptr<IndexMode::IX>>();
     }
     void exec_OR_IXH() {
-        exec_DD_helper<&CPU::handle_opcode_0xB4_OR_H>();
+        exec_DD_helper<&CPU::handle_opcode_0xB4_OR_H<IndexMode::IX>>();
     }
     void exec_OR_IXL() {
-        exec_DD_helper<&CPU::handle_opcode_0xB5_OR_L>();
+        exec_DD_helper<&CPU::handle_opcode_0xB5_OR_L<IndexMode::IX>>();
     }
     void exec_OR_IX_d_ptr() {
-        exec_DD_helper<&CPU::handle_opcode_0xB6_OR_HL_ptr>();
+        exec_DD_helper<&CPU::handle_opcode_0xB6_OR_HL_ptr<IndexMode::IX>>();
     }
     void exec_CP_IXH() {
-        exec_DD_helper<&CPU::handle_opcode_0xBC_CP_H>();
+        exec_DD_helper<&CPU::handle_opcode_0xBC_CP_H<IndexMode::IX>>();
     }
     void exec_CP_IXL() {
-        exec_DD_helper<&CPU::handle_opcode_0xBD_CP_L>();
+        exec_DD_helper<&CPU::handle_opcode_0xBD_CP_L<IndexMode::IX>>();
     }
     void exec_CP_IX_d_ptr() {
-        exec_DD_helper<&CPU::handle_opcode_0xBE_CP_HL_ptr>();
+        exec_DD_helper<&CPU::handle_opcode_0xBE_CP_HL_ptr<IndexMode::IX>>();
     }
     void exec_POP_IX() {
-        exec_DD_helper<&CPU::handle_opcode_0xE1_POP_HL>();
+        exec_DD_helper<&CPU::handle_opcode_0xE1_POP_HL<IndexMode::IX>>();
     }
     void exec_EX_SP_ptr_IX() {
-        exec_DD_helper<&CPU::handle_opcode_0xE3_EX_SP_ptr_HL>();
+        exec_DD_helper<&CPU::handle_opcode_0xE3_EX_SP_ptr_HL<IndexMode::IX>>();
     }
     void exec_PUSH_IX() {
-        exec_DD_helper<&CPU::handle_opcode_0xE5_PUSH_HL>();
+        exec_DD_helper<&CPU::handle_opcode_0xE5_PUSH_HL<IndexMode::IX>>();
     }
     void exec_JP_IX_ptr() {
-        exec_DD_helper<&CPU::handle_opcode_0xE9_JP_HL_ptr>();
+        exec_DD_helper<&CPU::handle_opcode_0xE9_JP_HL_ptr<IndexMode::IX>>();
     }
     void exec_LD_SP_IX() {
-        exec_DD_helper<&CPU::handle_opcode_0xF9_LD_SP_HL>();
+        exec_DD_helper<&CPU::handle_opcode_0xF9_LD_SP_HL<IndexMode::IX>>();
     }
 
     // --- FD Prefixed Opcodes (IY) ---
     void exec_ADD_IY_BC() {
-        exec_FD_helper<&CPU::handle_opcode_0x09_ADD_HL_BC>();
+        exec_FD_helper<&CPU::handle_opcode_0x09_ADD_HL_BC<IndexMode::IY>>();
     }
     void exec_ADD_IY_DE() {
-        exec_FD_helper<&CPU::handle_opcode_0x19_ADD_HL_DE>();
+        exec_FD_helper<&CPU::handle_opcode_0x19_ADD_HL_DE<IndexMode::IY>>();
     }
     void exec_LD_IY_nn() {
-        exec_FD_helper<&CPU::handle_opcode_0x21_LD_HL_nn>();
+        exec_FD_helper<&CPU::handle_opcode_0x21_LD_HL_nn<IndexMode::IY>>();
     }
     void exec_LD_nn_ptr_IY() {
-        exec_FD_helper<&CPU::handle_opcode_0x22_LD_nn_ptr_HL>();
+        exec_FD_helper<&CPU::handle_opcode_0x22_LD_nn_ptr_HL<IndexMode::IY>>();
     }
     void exec_INC_IY() {
-        exec_FD_helper<&CPU::handle_opcode_0x23_INC_HL>();
+        exec_FD_helper<&CPU::handle_opcode_0x23_INC_HL<IndexMode::IY>>();
     }
     void exec_INC_IYH() {
-        exec_FD_helper<&CPU::handle_opcode_0x24_INC_H>();
+        exec_FD_helper<&CPU::handle_opcode_0x24_INC_H<IndexMode::IY>>();
     }
     void exec_DEC_IYH() {
-        exec_FD_helper<&CPU::handle_opcode_0x25_DEC_H>();
+        exec_FD_helper<&CPU::handle_opcode_0x25_DEC_H<IndexMode::IY>>();
     }
     void exec_LD_IYH_n() {
-        exec_FD_helper<&CPU::handle_opcode_0x26_LD_H_n>();
+        exec_FD_helper<&CPU::handle_opcode_0x26_LD_H_n<IndexMode::IY>>();
     }
     void exec_ADD_IY_IY() {
-        exec_FD_helper<&CPU::handle_opcode_0x29_ADD_HL_HL>();
+        exec_FD_helper<&CPU::handle_opcode_0x29_ADD_HL_HL<IndexMode::IY>>();
     }
     void exec_LD_IY_nn_ptr() {
-        exec_FD_helper<&CPU::handle_opcode_0x2A_LD_HL_nn_ptr>();
+        exec_FD_helper<&CPU::handle_opcode_0x2A_LD_HL_nn_ptr<IndexMode::IY>>();
     }
     void exec_DEC_IY() {
-        exec_FD_helper<&CPU::handle_opcode_0x2B_DEC_HL>();
+        exec_FD_helper<&CPU::handle_opcode_0x2B_DEC_HL<IndexMode::IY>>();
     }
     void exec_INC_IYL() {
-        exec_FD_helper<&CPU::handle_opcode_0x2C_INC_L>();
+        exec_FD_helper<&CPU::handle_opcode_0x2C_INC_L<IndexMode::IY>>();
     }
     void exec_DEC_IYL() {
-        exec_FD_helper<&CPU::handle_opcode_0x2D_DEC_L>();
+        exec_FD_helper<&CPU::handle_opcode_0x2D_DEC_L<IndexMode::IY>>();
     }
     void exec_LD_IYL_n() {
-        exec_FD_helper<&CPU::handle_opcode_0x2E_LD_L_n>();
+        exec_FD_helper<&CPU::handle_opcode_0x2E_LD_L_n<IndexMode::IY>>();
     }
     void exec_INC_IY_d_ptr() {
-        exec_FD_helper<&CPU::handle_opcode_0x34_INC_HL_ptr>();
+        exec_FD_helper<&CPU::handle_opcode_0x34_INC_HL_ptr<IndexMode::IY>>();
     }
     void exec_DEC_IY_d_ptr() {
-        exec_FD_helper<&CPU::handle_opcode_0x35_DEC_HL_ptr>();
+        exec_FD_helper<&CPU::handle_opcode_0x35_DEC_HL_ptr<IndexMode::IY>>();
     }
     void exec_LD_IY_d_ptr_n() {
-        exec_FD_helper<&CPU::handle_opcode_0x36_LD_HL_ptr_n>();
+        exec_FD_helper<&CPU::handle_opcode_0x36_LD_HL_ptr_n<IndexMode::IY>>();
     }
     void exec_ADD_IY_SP() {
-        exec_FD_helper<&CPU::handle_opcode_0x39_ADD_HL_SP>();
+        exec_FD_helper<&CPU::handle_opcode_0x39_ADD_HL_SP<IndexMode::IY>>();
     }
     void exec_LD_B_IYH() {
-        exec_FD_helper<&CPU::handle_opcode_0x44_LD_B_H>();
+        exec_FD_helper<&CPU::handle_opcode_0x44_LD_B_H<IndexMode::IY>>();
     }
     void exec_LD_B_IYL() {
-        exec_FD_helper<&CPU::handle_opcode_0x45_LD_B_L>();
+        exec_FD_helper<&CPU::handle_opcode_0x45_LD_B_L<IndexMode::IY>>();
     }
     void exec_LD_B_IY_d_ptr() {
-        exec_FD_helper<&CPU::handle_opcode_0x46_LD_B_HL_ptr>();
+        exec_FD_helper<&CPU::handle_opcode_0x46_LD_B_HL_ptr<IndexMode::IY>>();
     }
     void exec_LD_C_IYH() {
-        exec_FD_helper<&CPU::handle_opcode_0x4C_LD_C_H>();
+        exec_FD_helper<&CPU::handle_opcode_0x4C_LD_C_H<IndexMode::IY>>();
     }
     void exec_LD_C_IYL() {
-        exec_FD_helper<&CPU::handle_opcode_0x4D_LD_C_L>();
+        exec_FD_helper<&CPU::handle_opcode_0x4D_LD_C_L<IndexMode::IY>>();
     }
     void exec_LD_C_IY_d_ptr() {
-        exec_FD_helper<&CPU::handle_opcode_0x4E_LD_C_HL_ptr>();
+        exec_FD_helper<&CPU::handle_opcode_0x4E_LD_C_HL_ptr<IndexMode::IY>>();
     }
     void exec_LD_D_IYH() {
-        exec_FD_helper<&CPU::handle_opcode_0x54_LD_D_H>();
+        exec_FD_helper<&CPU::handle_opcode_0x54_LD_D_H<IndexMode::IY>>();
     }
     void exec_LD_D_IYL() {
-        exec_FD_helper<&CPU::handle_opcode_0x55_LD_D_L>();
+        exec_FD_helper<&CPU::handle_opcode_0x55_LD_D_L<IndexMode::IY>>();
     }
     void exec_LD_D_IY_d_ptr() {
-        exec_FD_helper<&CPU::handle_opcode_0x56_LD_D_HL_ptr>();
+        exec_FD_helper<&CPU::handle_opcode_0x56_LD_D_HL_ptr<IndexMode::IY>>();
     }
     void exec_LD_E_IYH() {
-        exec_FD_helper<&CPU::handle_opcode_0x5C_LD_E_H>();
+        exec_FD_helper<&CPU::handle_opcode_0x5C_LD_E_H<IndexMode::IY>>();
     }
     void exec_LD_E_IYL() {
-        exec_FD_helper<&CPU::handle_opcode_0x5D_LD_E_L>();
+        exec_FD_helper<&CPU::handle_opcode_0x5D_LD_E_L<IndexMode::IY>>();
     }
     void exec_LD_E_IY_d_ptr() {
-        exec_FD_helper<&CPU::handle_opcode_0x5E_LD_E_HL_ptr>();
+        exec_FD_helper<&CPU::handle_opcode_0x5E_LD_E_HL_ptr<IndexMode::IY>>();
     }
     void exec_LD_IYH_B() {
-        exec_FD_helper<&CPU::handle_opcode_0x60_LD_H_B>();
+        exec_FD_helper<&CPU::handle_opcode_0x60_LD_H_B<IndexMode::IY>>();
     }
     void exec_LD_IYH_C() {
-        exec_FD_helper<&CPU::handle_opcode_0x61_LD_H_C>();
+        exec_FD_helper<&CPU::handle_opcode_0x61_LD_H_C<IndexMode::IY>>();
     }
     void exec_LD_IYH_D() {
-        exec_FD_helper<&CPU::handle_opcode_0x62_LD_H_D>();
+        exec_FD_helper<&CPU::handle_opcode_0x62_LD_H_D<IndexMode::IY>>();
     }
     void exec_LD_IYH_E() {
-        exec_FD_helper<&CPU::handle_opcode_0x63_LD_H_E>();
+        exec_FD_helper<&CPU::handle_opcode_0x63_LD_H_E<IndexMode::IY>>();
     }
     void exec_LD_IYH_IYH() {
         exec_FD_helper<&CPU::handle_opcode_0x64_LD_H_H>();
     }
     void exec_LD_IYH_IYL() {
-        exec_FD_helper<&CPU::handle_opcode_0x65_LD_H_L>();
+        exec_FD_helper<&CPU::handle_opcode_0x65_LD_H_L<IndexMode::IY>>();
     }
     void exec_LD_H_IY_d_ptr() {
-        exec_FD_helper<&CPU::handle_opcode_0x66_LD_H_HL_ptr>();
+        exec_FD_helper<&CPU::handle_opcode_0x66_LD_H_HL_ptr<IndexMode::IY>>();
     }
     void exec_LD_IYH_A() {
-        exec_FD_helper<&CPU::handle_opcode_0x67_LD_H_A>();
+        exec_FD_helper<&CPU::handle_opcode_0x67_LD_H_A<IndexMode::IY>>();
     }
     void exec_LD_IYL_B() {
-        exec_FD_helper<&CPU::handle_opcode_0x68_LD_L_B>();
+        exec_FD_helper<&CPU::handle_opcode_0x68_LD_L_B<IndexMode::IY>>();
     }
     void exec_LD_IYL_C() {
-        exec_FD_helper<&CPU::handle_opcode_0x69_LD_L_C>();
+        exec_FD_helper<&CPU::handle_opcode_0x69_LD_L_C<IndexMode::IY>>();
     }
     void exec_LD_IYL_D() {
-        exec_FD_helper<&CPU::handle_opcode_0x6A_LD_L_D>();
+        exec_FD_helper<&CPU::handle_opcode_0x6A_LD_L_D<IndexMode::IY>>();
     }
     void exec_LD_IYL_E() {
-        exec_FD_helper<&CPU::handle_opcode_0x6B_LD_L_E>();
+        exec_FD_helper<&CPU::handle_opcode_0x6B_LD_L_E<IndexMode::IY>>();
     }
     void exec_LD_IYL_IYH() {
-        exec_FD_helper<&CPU::handle_opcode_0x6C_LD_L_H>();
+        exec_FD_helper<&CPU::handle_opcode_0x6C_LD_L_H<IndexMode::IY>>();
     }
     void exec_LD_IYL_IYL() {
         exec_FD_helper<&CPU::handle_opcode_0x6D_LD_L_L>();
     }
     void exec_LD_L_IY_d_ptr() {
-        exec_FD_helper<&CPU::handle_opcode_0x6E_LD_L_HL_ptr>();
+        exec_FD_helper<&CPU::handle_opcode_0x6E_LD_L_HL_ptr<IndexMode::IY>>();
     }
     void exec_LD_IYL_A() {
-        exec_FD_helper<&CPU::handle_opcode_0x6F_LD_L_A>();
+        exec_FD_helper<&CPU::handle_opcode_0x6F_LD_L_A<IndexMode::IY>>();
     }
     void exec_LD_IY_d_ptr_B() {
-        exec_FD_helper<&CPU::handle_opcode_0x70_LD_HL_ptr_B>();
+        exec_FD_helper<&CPU::handle_opcode_0x70_LD_HL_ptr_B<IndexMode::IY>>();
     }
     void exec_LD_IY_d_ptr_C() {
-        exec_FD_helper<&CPU::handle_opcode_0x71_LD_HL_ptr_C>();
+        exec_FD_helper<&CPU::handle_opcode_0x71_LD_HL_ptr_C<IndexMode::IY>>();
     }
     void exec_LD_IY_d_ptr_D() {
-        exec_FD_helper<&CPU::handle_opcode_0x72_LD_HL_ptr_D>();
+        exec_FD_helper<&CPU::handle_opcode_0x72_LD_HL_ptr_D<IndexMode::IY>>();
     }
     void exec_LD_IY_d_ptr_E() {
-        exec_FD_helper<&CPU::handle_opcode_0x73_LD_HL_ptr_E>();
+        exec_FD_helper<&CPU::handle_opcode_0x73_LD_HL_ptr_E<IndexMode::IY>>();
     }
     void exec_LD_IY_d_ptr_H() {
-        exec_FD_helper<&CPU::handle_opcode_0x74_LD_HL_ptr_H>();
+        exec_FD_helper<&CPU::handle_opcode_0x74_LD_HL_ptr_H<IndexMode::IY>>();
     }
     void exec_LD_IY_d_ptr_L() {
-        exec_FD_helper<&CPU::handle_opcode_0x75_LD_HL_ptr_L>();
+        exec_FD_helper<&CPU::handle_opcode_0x75_LD_HL_ptr_L<IndexMode::IY>>();
     }
     void exec_LD_IY_d_ptr_A() {
-        exec_FD_helper<&CPU::handle_opcode_0x77_LD_HL_ptr_A>();
+        exec_FD_helper<&CPU::handle_opcode_0x77_LD_HL_ptr_A<IndexMode::IY>>();
     }
     void exec_LD_A_IYH() {
-        exec_FD_helper<&CPU::handle_opcode_0x7C_LD_A_H>();
+        exec_FD_helper<&CPU::handle_opcode_0x7C_LD_A_H<IndexMode::IY>>();
     }
     void exec_LD_A_IYL() {
-        exec_FD_helper<&CPU::handle_opcode_0x7D_LD_A_L>();
+        exec_FD_helper<&CPU::handle_opcode_0x7D_LD_A_L<IndexMode::IY>>();
     }
     void exec_LD_A_IY_d_ptr() {
-        exec_FD_helper<&CPU::handle_opcode_0x7E_LD_A_HL_ptr>();
+        exec_FD_helper<&CPU::handle_opcode_0x7E_LD_A_HL_ptr<IndexMode::IY>>();
     }
     void exec_ADD_A_IYH() {
-        exec_FD_helper<&CPU::handle_opcode_0x84_ADD_A_H>();
+        exec_FD_helper<&CPU::handle_opcode_0x84_ADD_A_H<IndexMode::IY>>();
     }
     void exec_ADD_A_IYL() {
-        exec_FD_helper<&CPU::handle_opcode_0x85_ADD_A_L>();
+        exec_FD_helper<&CPU::handle_opcode_0x85_ADD_A_L<IndexMode::IY>>();
     }
     void exec_ADD_A_IY_d_ptr() {
-        exec_FD_helper<&CPU::handle_opcode_0x86_ADD_A_HL_ptr>();
+        exec_FD_helper<&CPU::handle_opcode_0x86_ADD_A_HL_ptr<IndexMode::IY>>();
     }
     void exec_ADC_A_IYH() {
-        exec_FD_helper<&CPU::handle_opcode_0x8C_ADC_A_H>();
+        exec_FD_helper<&CPU::handle_opcode_0x8C_ADC_A_H<IndexMode::IY>>();
     }
     void exec_ADC_A_IYL() {
-        exec_FD_helper<&CPU::handle_opcode_0x8D_ADC_A_L>();
+        exec_FD_helper<&CPU::handle_opcode_0x8D_ADC_A_L<IndexMode::IY>>();
     }
     void exec_ADC_A_IY_d_ptr() {
-        exec_FD_helper<&CPU::handle_opcode_0x8E_ADC_A_HL_ptr>();
+        exec_FD_helper<&CPU::handle_opcode_0x8E_ADC_A_HL_ptr<IndexMode::IY>>();
     }
     void exec_SUB_IYH() {
-        exec_FD_helper<&CPU::handle_opcode_0x94_SUB_H>();
+        exec_FD_helper<&CPU::handle_opcode_0x94_SUB_H<IndexMode::IY>>();
     }
     void exec_SUB_IYL() {
-        exec_FD_helper<&CPU::handle_opcode_0x95_SUB_L>();
+        exec_FD_helper<&CPU::handle_opcode_0x95_SUB_L<IndexMode::IY>>();
     }
     void exec_SUB_IY_d_ptr() {
-        exec_FD_helper<&CPU::handle_opcode_0x96_SUB_HL_ptr>();
+        exec_FD_helper<&CPU::handle_opcode_0x96_SUB_HL_ptr<IndexMode::IY>>();
     }
     void exec_SBC_A_IYH() {
-        exec_FD_helper<&CPU::handle_opcode_0x9C_SBC_A_H>();
+        exec_FD_helper<&CPU::handle_opcode_0x9C_SBC_A_H<IndexMode::IY>>();
     }
     void exec_SBC_A_IYL() {
-        exec_FD_helper<&CPU::handle_opcode_0x9D_SBC_A_L>();
+        exec_FD_helper<&CPU::handle_opcode_0x9D_SBC_A_L<IndexMode::IY>>();
     }
     void exec_SBC_A_IY_d_ptr() {
-        exec_FD_helper<&CPU::handle_opcode_0x9E_SBC_A_HL_ptr>();
+        exec_FD_helper<&CPU::handle_opcode_0x9E_SBC_A_HL_ptr<IndexMode::IY>>();
     }
     void exec_AND_IYH() {
-        exec_FD_helper<&CPU::handle_opcode_0xA4_AND_H>();
+        exec_FD_helper<&CPU::handle_opcode_0xA4_AND_H<IndexMode::IY>>();
     }
     void exec_AND_IYL() {
-        exec_FD_helper<&CPU::handle_opcode_0xA5_AND_L>();
+        exec_FD_helper<&CPU::handle_opcode_0xA5_AND_L<IndexMode::IY>>();
     }
     void exec_AND_IY_d_ptr() {
-        exec_FD_helper<&CPU::handle_opcode_0xA6_AND_HL_ptr>();
+        exec_FD_helper<&CPU::handle_opcode_0xA6_AND_HL_ptr<IndexMode::IY>>();
     }
     void exec_XOR_IYH() {
-        exec_FD_helper<&CPU::handle_opcode_0xAC_XOR_H>();
+        exec_FD_helper<&CPU::handle_opcode_0xAC_XOR_H<IndexMode::IY>>();
     }
     void exec_XOR_IYL() {
-        exec_FD_helper<&CPU::handle_opcode_0xAD_XOR_L>();
+        exec_FD_helper<&CPU::handle_opcode_0xAD_XOR_L<IndexMode::IY>>();
     }
     void exec_XOR_IY_d_ptr() {
-        exec_FD_helper<&CPU::handle_opcode_0xAE_XOR_HL_ptr>();
+        exec_FD_helper<&CPU::handle_opcode_0xAE_XOR_HL_ptr<IndexMode::IY>>();
     }
     void exec_OR_IYH() {
-        exec_FD_helper<&CPU::handle_opcode_0xB4_OR_H>();
+        exec_FD_helper<&CPU::handle_opcode_0xB4_OR_H<IndexMode::IY>>();
     }
     void exec_OR_IYL() {
-        exec_FD_helper<&CPU::handle_opcode_0xB5_OR_L>();
+        exec_FD_helper<&CPU::handle_opcode_0xB5_OR_L<IndexMode::IY>>();
     }
     void exec_OR_IY_d_ptr() {
-        exec_FD_helper<&CPU::handle_opcode_0xB6_OR_HL_ptr>();
+        exec_FD_helper<&CPU::handle_opcode_0xB6_OR_HL_ptr<IndexMode::IY>>();
     }
     void exec_CP_IYH() {
-        exec_FD_helper<&CPU::handle_opcode_0xBC_CP_H>();
+        exec_FD_helper<&CPU::handle_opcode_0xBC_CP_H<IndexMode::IY>>();
     }
     void exec_CP_IYL() {
-        exec_FD_helper<&CPU::handle_opcode_0xBD_CP_L>();
+        exec_FD_helper<&CPU::handle_opcode_0xBD_CP_L<IndexMode::IY>>();
     }
     void exec_CP_IY_d_ptr() {
-        exec_FD_helper<&CPU::handle_opcode_0xBE_CP_HL_ptr>();
+        exec_FD_helper<&CPU::handle_opcode_0xBE_CP_HL_ptr<IndexMode::IY>>();
     }
     void exec_POP_IY() {
-        exec_FD_helper<&CPU::handle_opcode_0xE1_POP_HL>();
+        exec_FD_helper<&CPU::handle_opcode_0xE1_POP_HL<IndexMode::IY>>();
     }
     void exec_EX_SP_ptr_IY() {
-        exec_FD_helper<&CPU::handle_opcode_0xE3_EX_SP_ptr_HL>();
+        exec_FD_helper<&CPU::handle_opcode_0xE3_EX_SP_ptr_HL<IndexMode::IY>>();
     }
     void exec_PUSH_IY() {
-        exec_FD_helper<&CPU::handle_opcode_0xE5_PUSH_HL>();
+        exec_FD_helper<&CPU::handle_opcode_0xE5_PUSH_HL<IndexMode::IY>>();
     }
     void exec_JP_IY_ptr() {
-        exec_FD_helper<&CPU::handle_opcode_0xE9_JP_HL_ptr>();
+        exec_FD_helper<&CPU::handle_opcode_0xE9_JP_HL_ptr<IndexMode::IY>>();
     }
     void exec_LD_SP_IY() {
-        exec_FD_helper<&CPU::handle_opcode_0xF9_LD_SP_HL>();
+        exec_FD_helper<&CPU::handle_opcode_0xF9_LD_SP_HL<IndexMode::IY>>();
     }
 
     // --- ED Prefixed Opcodes ---
@@ -8094,7 +9386,8 @@ public:
     StandardBus() {
         m_ram.resize(0x10000, 0);
     }
-    template <typename TBus, typename TEvents, typename TDebugger, bool EnableNext> void connect(CPU<TBus, TEvents, TDebugger, EnableNext>* cpu) {
+    template <typename TBus, typename TEvents, typename TDebugger, bool EnableNext, typename TConfig>
+    void connect(CPU<TBus, TEvents, TDebugger, EnableNext, TConfig>* cpu) {
     }
     void reset() {
         std::fill(m_ram.begin(), m_ram.end(), 0);
@@ -8120,10 +9413,207 @@ public:
 private:
     std::vector<uint8_t> m_ram;
 };
+class PagedBus {
+public:
+    static constexpr int PAGE_BITS = 10;
+    static constexpr uint32_t PAGE_SIZE = 1u << PAGE_BITS;
+    static constexpr uint32_t PAGE_COUNT = 0x10000 >> PAGE_BITS;
+
+    PagedBus() {
+        m_ram.resize(0x10000, 0);
+        map(0x0000, 0x10000, m_ram.data());
+    }
+    PagedBus(const PagedBus& other) : m_ram(other.m_ram) {
+        copy_pages(other);
+    }
+    PagedBus& operator=(const PagedBus& other) {
+        if (this != &other) {
+            m_ram = other.m_ram;
+            copy_pages(other);
+        }
+        return *this;
+    }
+    template <typename TBus, typename TEvents, typename TDebugger, bool EnableNext, typename TConfig>
+    void connect(CPU<TBus, TEvents, TDebugger, EnableNext, TConfig>* cpu) {
+    }
+    void reset() {
+        std::fill(m_ram.begin(), m_ram.end(), 0);
+    }
+    // Maps host memory at a page-aligned address range. Read-only pages (ROM) drop CPU writes.
+    void map(uint16_t address, uint32_t size, uint8_t* memory, bool writable = true) {
+        for (uint32_t offset = 0; offset < size; offset += PAGE_SIZE) {
+            uint32_t page = ((address + offset) & 0xFFFF) >> PAGE_BITS;
+            m_read_pages[page] = memory + offset;
+            m_write_pages[page] = writable ? memory + offset : nullptr;
+        }
+    }
+    // Unmapped pages are routed through read()/write(), which a derived bus can shadow for
+    // memory-mapped devices.
+    void unmap(uint16_t address, uint32_t size) {
+        for (uint32_t offset = 0; offset < size; offset += PAGE_SIZE) {
+            uint32_t page = ((address + offset) & 0xFFFF) >> PAGE_BITS;
+            m_read_pages[page] = nullptr;
+            m_write_pages[page] = nullptr;
+        }
+    }
+    uint8_t* get_ram() {
+        return m_ram.data();
+    }
+    uint8_t* const* get_read_pages() const {
+        return m_read_pages;
+    }
+    uint8_t* const* get_write_pages() const {
+        return m_write_pages;
+    }
+    uint8_t read(uint16_t address) {
+        return peek(address);
+    }
+    void write(uint16_t address, uint8_t value) {
+        uint8_t* page = m_write_pages[address >> PAGE_BITS];
+        if (page)
+            page[address & (PAGE_SIZE - 1)] = value;
+    }
+    uint8_t peek(uint16_t address) const {
+        const uint8_t* page = m_read_pages[address >> PAGE_BITS];
+        return page ? page[address & (PAGE_SIZE - 1)] : 0xFF;
+    }
+    void poke(uint16_t address, uint8_t value) {
+        uint8_t* page = m_write_pages[address >> PAGE_BITS];
+        if (!page)
+            page = m_read_pages[address >> PAGE_BITS];
+        if (page)
+            page[address & (PAGE_SIZE - 1)] = value;
+    }
+    uint8_t in(uint16_t port) {
+        return 0xFF;
+    }
+    void out(uint16_t port, uint8_t value) {
+    }
+
+private:
+    void copy_pages(const PagedBus& other) {
+        const uint8_t* other_ram = other.m_ram.data();
+        auto rebase = [&](uint8_t* page) -> uint8_t* {
+            if (page >= other_ram && page < other_ram + other.m_ram.size())
+                return m_ram.data() + (page - other_ram);
+            return page;
+        };
+        for (uint32_t page = 0; page < PAGE_COUNT; ++page) {
+            m_read_pages[page] = rebase(other.m_read_pages[page]);
+            m_write_pages[page] = rebase(other.m_write_pages[page]);
+        }
+    }
+
+    std::vector<uint8_t> m_ram;
+    uint8_t* m_read_pages[PAGE_COUNT];
+    uint8_t* m_write_pages[PAGE_COUNT];
+};
+// Paged bus over a shared 64 KB base image, for running many CPUs on the same program. Every instance reads
+// the image in place and takes a private copy of a 256-byte page on its first write there, so it holds only
+// the pages it wrote; reset() returns those pages to the image in time proportional to their number (the
+// copies are kept for reuse). The image is not copied and must outlive the bus.
+class CopyOnWriteBus {
+public:
+    static constexpr int PAGE_BITS = 8;
+    static constexpr uint32_t PAGE_SIZE = 1u << PAGE_BITS;
+    static constexpr uint32_t PAGE_COUNT = 0x10000 >> PAGE_BITS;
+
+    // A null image reads as zeros
+    explicit CopyOnWriteBus(const uint8_t* image = nullptr) {
+        set_image(image);
+    }
+    CopyOnWriteBus(const CopyOnWriteBus& other) {
+        copy_pages(other);
+    }
+    CopyOnWriteBus& operator=(const CopyOnWriteBus& other) {
+        if (this != &other)
+            copy_pages(other);
+        return *this;
+    }
+    template <typename TBus, typename TEvents, typename TDebugger, bool EnableNext, typename TConfig>
+    void connect(CPU<TBus, TEvents, TDebugger, EnableNext, TConfig>* cpu) {
+    }
+    void reset() {
+        for (uint8_t page : m_touched) {
+            m_read_pages[page] = const_cast<uint8_t*>(m_image) + (page << PAGE_BITS); // CPU writes use write pages
+            m_write_pages[page] = nullptr;
+        }
+        m_touched.clear();
+    }
+    // Switches to another base image, dropping all private pages
+    void set_image(const uint8_t* image) {
+        m_image = image ? image : zero_image();
+        for (uint32_t page = 0; page < PAGE_COUNT; ++page) {
+            m_read_pages[page] = const_cast<uint8_t*>(m_image) + (page << PAGE_BITS);
+            m_write_pages[page] = nullptr;
+        }
+        m_touched.clear();
+    }
+    const uint8_t* get_image() const {
+        return m_image;
+    }
+    // Number of pages this instance has written since the last reset
+    size_t get_private_pages() const {
+        return m_touched.size();
+    }
+    uint8_t* const* get_read_pages() const {
+        return m_read_pages;
+    }
+    uint8_t* const* get_write_pages() const {
+        return m_write_pages;
+    }
+    // Reached only for the first write to a shared page; later writes go straight to the private copy
+    uint8_t read(uint16_t address) {
+        return peek(address);
+    }
+    void write(uint16_t address, uint8_t value) {
+        uint32_t page = address >> PAGE_BITS;
+        uint8_t* data = m_write_pages[page] ? m_write_pages[page] : make_private(page);
+        data[address & (PAGE_SIZE - 1)] = value;
+    }
+    uint8_t peek(uint16_t address) const {
+        return m_read_pages[address >> PAGE_BITS][address & (PAGE_SIZE - 1)];
+    }
+    void poke(uint16_t address, uint8_t value) {
+        write(address, value);
+    }
+    uint8_t in(uint16_t port) {
+        return 0xFF;
+    }
+    void out(uint16_t port, uint8_t value) {
+    }
+
+private:
+    static const uint8_t* zero_image() {
+        static const std::vector<uint8_t> s_zeros(0x10000, 0);
+        return s_zeros.data();
+    }
+    uint8_t* make_private(uint32_t page) {
+        if (!m_private[page])
+            m_private[page].reset(new uint8_t[PAGE_SIZE]);
+        uint8_t* data = m_private[page].get();
+        std::memcpy(data, m_read_pages[page], PAGE_SIZE);
+        m_read_pages[page] = m_write_pages[page] = data;
+        m_touched.push_back((uint8_t)page);
+        return data;
+    }
+    void copy_pages(const CopyOnWriteBus& other) {
+        set_image(other.m_image);
+        for (uint8_t page : other.m_touched)
+            std::memcpy(make_private(page), other.m_read_pages[page], PAGE_SIZE);
+    }
+
+    const uint8_t* m_image;
+    uint8_t* m_read_pages[PAGE_COUNT];
+    uint8_t* m_write_pages[PAGE_COUNT];
+    std::unique_ptr<uint8_t[]> m_private[PAGE_COUNT];
+    std::vector<uint8_t> m_touched;
+};
 class StandardEvents {
 public:
     static constexpr long long CYCLES_PER_EVENT = LLONG_MAX;
-    template <typename TBus, typename TEvents, typename TDebugger, bool EnableNext> void connect(const CPU<TBus, TEvents, TDebugger, EnableNext>* cpu) {
+    template <typename TBus, typename TEvents, typename TDebugger, bool EnableNext, typename TConfig>
+    void connect(const CPU<TBus, TEvents, TDebugger, EnableNext, TConfig>* cpu) {
     }
     void reset() {
     }
@@ -8135,7 +9625,8 @@ public:
 };
 class StandardDebugger {
 public:
-    template <typename TBus, typename TEvents, typename TDebugger, bool EnableNext> void connect(const CPU<TBus, TEvents, TDebugger, EnableNext>* cpu) {
+    template <typename TBus, typename TEvents, typename TDebugger, bool EnableNext, typename TConfig>
+    void connect(const CPU<TBus, TEvents, TDebugger, EnableNext, TConfig>* cpu) {
     }
     void reset() {
     }
@@ -0,0 +1,194 @@
+//  ▄▄▄▄▄▄▄▄    ▄▄▄▄      ▄▄▄▄
+//  ▀▀▀▀▀███  ▄██▀▀██▄   ██▀▀██
+//      ██▀   ██▄  ▄██  ██    ██
+//    ▄██▀     ██████   ██ ██ ██
+//   ▄██      ██▀  ▀██  ██    ██
+//  ███▄▄▄▄▄  ▀██▄▄██▀   ██▄▄██
+//  ▀▀▀▀▀▀▀▀    ▀▀▀▀      ▀▀▀▀   Farm.h
+// Version: 1.0.0
+//
+// This file contains the Farm class, which runs many independent machines
+// to completion on a work-stealing pool of threads.
+//
+// Copyright (c) 2025-2026 Adam Szulc
+// MIT License
+
+#ifndef __Z80_FARM_H__
+#define __Z80_FARM_H__
+
+#include <Z80/CPU.h>
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+namespace Z80 {
+
+// Runs batches of independent machines (test binaries, boot tests), each a CPU with its own bus, events and
+// debugger. Every job runs in slices of `slice` T-states to absolute tick targets (start + k * slice) and
+// checks its completion predicate after each slice, so the ticks it ends at and its final state do not
+// depend on the thread count or on which thread ran which slice. Each worker takes the slices of its own
+// queue, most recent job first to stay cache-warm, and steals the oldest job of another worker when its own
+// queue is empty. Jobs must not share mutable state; the stateless StandardEvents/StandardDebugger
+// instances and CopyOnWriteBus images are safe to share.
+class Farm {
+public:
+    struct Result {
+        long long ticks = 0;  // T-states run by the farm
+        double seconds = 0;   // Host time spent in the job's slices
+        long long slices = 0; // Number of slices run
+        bool finished = false; // The predicate held (false: stopped at max_ticks)
+    };
+
+    // `threads` 0 uses one per hardware thread; `pin_threads` binds worker i to core i (Linux only)
+    explicit Farm(unsigned threads = 0, bool pin_threads = false) : m_pin_threads(pin_threads) {
+        m_threads = threads ? threads : std::thread::hardware_concurrency();
+        if (m_threads == 0)
+            m_threads = 1;
+    }
+    Farm(const Farm&) = delete;
+    Farm& operator=(const Farm&) = delete;
+
+    // Adds a job: `cpu` runs until `finished()` holds after a slice or until it has run `max_ticks`
+    size_t add(ICPU& cpu, std::function<bool()> finished, long long max_ticks = LLONG_MAX) {
+        m_jobs.push_back({&cpu, std::move(finished), max_ticks});
+        m_results.emplace_back();
+        return m_jobs.size() - 1;
+    }
+    void set_slice(long long ticks) {
+        m_slice = ticks;
+    }
+    // Runs every job added since the last run() to completion; returns when all are done
+    void run() {
+        std::vector<Worker> workers(m_threads);
+        size_t pending = 0;
+        for (size_t job = m_next_job; job < m_jobs.size(); ++job, ++pending) {
+            m_jobs[job].start_ticks = m_jobs[job].cpu->get_ticks();
+            workers[pending % m_threads].queue.push_back(job);
+        }
+        m_next_job = m_jobs.size();
+        m_pending = pending;
+        std::vector<std::thread> threads;
+        for (unsigned index = 1; index < m_threads; ++index)
+            threads.emplace_back([this, &workers, index] { work(workers, index); });
+        work(workers, 0);
+        for (std::thread& thread : threads)
+            thread.join();
+        for (const Worker& worker : workers)
+            m_steals += worker.steals;
+    }
+    const Result& get_result(size_t job) const {
+        return m_results[job];
+    }
+    size_t get_job_count() const {
+        return m_jobs.size();
+    }
+    unsigned get_thread_count() const {
+        return m_threads;
+    }
+    // Slices taken from another worker's queue so far
+    long long get_steals() const {
+        return m_steals;
+    }
+
+private:
+    struct Job {
+        ICPU* cpu;
+        std::function<bool()> finished;
+        long long max_ticks;
+        long long start_ticks = 0;
+    };
+    struct Worker {
+        std::mutex mutex;
+        std::deque<size_t> queue;
+        long long steals = 0;
+    };
+
+    void work(std::vector<Worker>& workers, unsigned index) {
+        if (m_pin_threads)
+            pin(index);
+        Worker& self = workers[index];
+        size_t job;
+        while (m_pending.load(std::memory_order_acquire) != 0) {
+            if (!take(self, job) && !steal(workers, index, job)) {
+                std::this_thread::yield();
+                continue;
+            }
+            if (run_slice(job)) {
+                m_pending.fetch_sub(1, std::memory_order_acq_rel);
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(self.mutex);
+            self.queue.push_back(job);
+        }
+    }
+    bool take(Worker& worker, size_t& job) {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.queue.empty())
+            return false;
+        job = worker.queue.back();
+        worker.queue.pop_back();
+        return true;
+    }
+    bool steal(std::vector<Worker>& workers, unsigned thief, size_t& job) {
+        for (unsigned offset = 1; offset < workers.size(); ++offset) {
+            Worker& victim = workers[(thief + offset) % workers.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.queue.empty()) {
+                job = victim.queue.front();
+                victim.queue.pop_front();
+                ++workers[thief].steals;
+                return true;
+            }
+        }
+        return false;
+    }
+    // Runs one slice of a job; true when the job is done
+    bool run_slice(size_t index) {
+        Job& job = m_jobs[index];
+        Result& result = m_results[index];
+        long long target = (result.slices + 1) * m_slice;
+        if (target > job.max_ticks)
+            target = job.max_ticks;
+        auto start = std::chrono::steady_clock::now();
+        job.cpu->run(job.start_ticks + target);
+        result.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.ticks = job.cpu->get_ticks() - job.start_ticks;
+        ++result.slices;
+        result.finished = job.finished();
+        return result.finished || result.ticks >= job.max_ticks;
+    }
+    static void pin(unsigned index) {
+#if defined(__linux__)
+        unsigned cores = std::thread::hardware_concurrency();
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cores ? index % cores : 0, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+    }
+
+    unsigned m_threads;
+    bool m_pin_threads;
+    long long m_slice = 1000000;
+    std::deque<Job> m_jobs;
+    std::deque<Result> m_results;
+    size_t m_next_job = 0;
+    std::atomic<size_t> m_pending{0};
+    long long m_steals = 0;
+};
+
+} // namespace Z80
+
+#endif //__Z80_FARM_H__
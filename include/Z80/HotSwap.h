@@ -0,0 +1,120 @@
+//  ▄▄▄▄▄▄▄▄    ▄▄▄▄      ▄▄▄▄
+//  ▀▀▀▀▀███  ▄██▀▀██▄   ██▀▀██
+//      ██▀   ██▄  ▄██  ██    ██
+//    ▄██▀     ██████   ██ ██ ██
+//   ▄██      ██▀  ▀██  ██    ██
+//  ███▄▄▄▄▄  ▀██▄▄██▀   ██▄▄██
+//  ▀▀▀▀▀▀▀▀    ▀▀▀▀      ▀▀▀▀   HotSwap.h
+// Version: 1.0.0
+//
+// This file contains the HotSwapCPU class, which switches a machine between
+// a fast CPU instantiation and an instrumented (debugger) one at run time.
+//
+// Copyright (c) 2025-2026 Adam Szulc
+// MIT License
+
+#ifndef __Z80_HOTSWAP_H__
+#define __Z80_HOTSWAP_H__
+
+#include <Z80/CPU.h>
+
+namespace Z80 {
+
+// A fast CPU<TBus, TEvents, StandardDebugger> and an instrumented CPU<TBus, TEvents, TDebugger> over the same
+// bus and events. One of them is active; switching hands the register state (save_state()) and the bus
+// mirrors over to the other and reconnects the bus and events to it, so a machine pays for the debugger
+// only while it is needed. TBus and TEvents must accept connect() from both instantiations (a template
+// connect, as StandardBus and StandardEvents have).
+// Switches are made at instruction boundaries: at once when requested between run()/step() calls, and
+// when the run() in progress returns when requested from inside it (a debugger or bus callback).
+template <typename TBus = StandardBus, typename TEvents = StandardEvents, typename TDebugger = StandardDebugger,
+          bool EnableNext = false, typename TConfig = StandardConfig>
+class HotSwapCPU {
+public:
+    using FastCPU = CPU<TBus, TEvents, StandardDebugger, EnableNext, TConfig>;
+    using InstrumentedCPU = CPU<TBus, TEvents, TDebugger, EnableNext, TConfig>;
+
+    // Null arguments are created and owned by the fast CPU (bus, events) and the instrumented CPU
+    // (debugger). Both constructors reset the bus and events, so load memory afterwards.
+    HotSwapCPU(TBus* bus = nullptr, TEvents* events = nullptr, TDebugger* debugger = nullptr)
+        : m_fast(bus, events), m_instrumented(m_fast.get_bus(), m_fast.get_events(), debugger) {
+        connect(m_fast);
+    }
+    HotSwapCPU(const HotSwapCPU&) = delete;
+    HotSwapCPU& operator=(const HotSwapCPU&) = delete;
+
+    long long run(long long ticks_limit) {
+        long long initial_ticks = get_active().get_ticks();
+        m_running = true;
+        if (m_instrumented_active)
+            m_instrumented.run(ticks_limit);
+        else
+            m_fast.run(ticks_limit);
+        m_running = false;
+        apply_request();
+        return get_active().get_ticks() - initial_ticks;
+    }
+    int step() {
+        m_running = true;
+        int ticks = m_instrumented_active ? m_instrumented.step() : m_fast.step();
+        m_running = false;
+        apply_request();
+        return ticks;
+    }
+    void set_instrumented(bool instrumented) {
+        m_instrumented_requested = instrumented;
+        if (!m_running)
+            apply_request();
+    }
+    bool is_instrumented() const {
+        return m_instrumented_active;
+    }
+    ICPU& get_active() {
+        return m_instrumented_active ? static_cast<ICPU&>(m_instrumented) : static_cast<ICPU&>(m_fast);
+    }
+    FastCPU& get_fast() {
+        return m_fast;
+    }
+    InstrumentedCPU& get_instrumented() {
+        return m_instrumented;
+    }
+    TBus* get_bus() {
+        return m_fast.get_bus();
+    }
+    TEvents* get_events() {
+        return m_fast.get_events();
+    }
+    TDebugger* get_debugger() {
+        return m_instrumented.get_debugger();
+    }
+
+private:
+    void apply_request() {
+        if (m_instrumented_requested == m_instrumented_active)
+            return;
+        if (m_instrumented_requested)
+            hand_over(m_fast, m_instrumented);
+        else
+            hand_over(m_instrumented, m_fast);
+        m_instrumented_active = m_instrumented_requested;
+    }
+    template <typename TFrom, typename TTo> void hand_over(TFrom& from, TTo& to) {
+        to.restore_state(from.save_state());
+        to.set_address_bus(from.get_address_bus());
+        to.set_data_bus(from.get_data_bus());
+        connect(to);
+    }
+    template <typename TTarget> void connect(TTarget& target) {
+        m_fast.get_bus()->connect(&target);
+        m_fast.get_events()->connect(&target);
+    }
+    FastCPU m_fast;
+    InstrumentedCPU m_instrumented;
+    bool m_instrumented_active = false;
+    bool m_instrumented_requested = false;
+    bool m_running = false;
+};
+
+} // namespace Z80
+
+#endif //__Z80_HOTSWAP_H__
@@ -0,0 +1,102 @@
+//  ▄▄▄▄▄▄▄▄    ▄▄▄▄      ▄▄▄▄
+//  ▀▀▀▀▀███  ▄██▀▀██▄   ██▀▀██
+//      ██▀   ██▄  ▄██  ██    ██
+//    ▄██▀     ██████   ██ ██ ██
+//   ▄██      ██▀  ▀██  ██    ██
+//  ███▄▄▄▄▄  ▀██▄▄██▀   ██▄▄██
+//  ▀▀▀▀▀▀▀▀    ▀▀▀▀      ▀▀▀▀   Lockstep.h
+// Version: 1.0.0
+//
+// This file contains the Lockstep class, which runs two CPU engines
+// side by side and reports the first point where their states differ.
+//
+// Copyright (c) 2025-2026 Adam Szulc
+// MIT License
+
+#ifndef __Z80_LOCKSTEP_H__
+#define __Z80_LOCKSTEP_H__
+
+#include <Z80/CPU.h>
+
+#include <cstdint>
+#include <string>
+
+namespace Z80 {
+
+// Differential runner. The candidate CPU runs blocks through run(), so every path that only acts inside
+// run() is exercised (threaded dispatch, opcode fusion, decode cache, block and idle loop fast-forward);
+// the reference then single-steps to the same tick, and the full save_state() of both is compared at
+// every block boundary. Both CPUs must start from the same state with their own copies of the same
+// memory and devices. They may be different instantiations (bus, events, TConfig), provided those are
+// meant to produce the same state.
+class Lockstep {
+public:
+    struct Mismatch {
+        long long ticks = 0; // Candidate tick count at the boundary that differed
+        std::string field;   // State field, e.g. "AF" or "ticks"
+        long long candidate = 0;
+        long long reference = 0;
+    };
+    Lockstep(ICPU& candidate, ICPU& reference) : m_candidate(candidate), m_reference(reference) {
+    }
+    // Runs blocks of `block_ticks` T-states until the candidate reaches `ticks_limit`. Returns false at the
+    // first block boundary where the states differ; get_mismatch() tells where.
+    bool run(long long ticks_limit, long long block_ticks) {
+        while (m_candidate.get_ticks() < ticks_limit) {
+            long long target = m_candidate.get_ticks() + block_ticks;
+            m_candidate.run(target < ticks_limit ? target : ticks_limit);
+            while (m_reference.get_ticks() < m_candidate.get_ticks())
+                m_reference.step();
+            ++m_blocks;
+            if (!compare())
+                return false;
+        }
+        return true;
+    }
+    // Compares the two states as they are now
+    bool compare() {
+        ICPU::State a = m_candidate.save_state();
+        ICPU::State b = m_reference.save_state();
+        m_mismatch = Mismatch{};
+        m_mismatch.ticks = a.m_ticks;
+        return same("AF", a.m_AF.w, b.m_AF.w) && same("BC", a.m_BC.w, b.m_BC.w) && same("DE", a.m_DE.w, b.m_DE.w) &&
+               same("HL", a.m_HL.w, b.m_HL.w) && same("IX", a.m_IX.w, b.m_IX.w) && same("IY", a.m_IY.w, b.m_IY.w) &&
+               same("SP", a.m_SP.w, b.m_SP.w) && same("PC", a.m_PC.w, b.m_PC.w) &&
+               same("AF'", a.m_AFp.w, b.m_AFp.w) && same("BC'", a.m_BCp.w, b.m_BCp.w) &&
+               same("DE'", a.m_DEp.w, b.m_DEp.w) && same("HL'", a.m_HLp.w, b.m_HLp.w) &&
+               same("WZ", a.m_WZ.w, b.m_WZ.w) && same("I", a.m_I, b.m_I) && same("R", a.m_R, b.m_R) &&
+               same("Q", a.m_Q, b.m_Q) && same("IFF1", a.m_IFF1, b.m_IFF1) && same("IFF2", a.m_IFF2, b.m_IFF2) &&
+               same("halted", a.m_halted, b.m_halted) && same("NMI_pending", a.m_NMI_pending, b.m_NMI_pending) &&
+               same("IRQ_request", a.m_IRQ_request, b.m_IRQ_request) &&
+               same("EI_executed", a.m_EI_executed, b.m_EI_executed) &&
+               same("RETI_signaled", a.m_RETI_signaled, b.m_RETI_signaled) &&
+               same("IRQ_data", a.m_IRQ_data, b.m_IRQ_data) &&
+               same("flags_modified", a.m_flags_modified, b.m_flags_modified) &&
+               same("IRQ_mode", a.m_IRQ_mode, b.m_IRQ_mode) &&
+               same("index_mode", (int)a.m_index_mode, (int)b.m_index_mode) && same("ticks", a.m_ticks, b.m_ticks);
+    }
+    const Mismatch& get_mismatch() const {
+        return m_mismatch;
+    }
+    long long get_blocks() const {
+        return m_blocks;
+    }
+
+private:
+    bool same(const char* field, long long candidate, long long reference) {
+        if (candidate == reference)
+            return true;
+        m_mismatch.field = field;
+        m_mismatch.candidate = candidate;
+        m_mismatch.reference = reference;
+        return false;
+    }
+    ICPU& m_candidate;
+    ICPU& m_reference;
+    Mismatch m_mismatch;
+    long long m_blocks = 0;
+};
+
+} // namespace Z80
+
+#endif //__Z80_LOCKSTEP_H__
@@ -0,0 +1,178 @@
+//  ▄▄▄▄▄▄▄▄    ▄▄▄▄      ▄▄▄▄
+//  ▀▀▀▀▀███  ▄██▀▀██▄   ██▀▀██
+//      ██▀   ██▄  ▄██  ██    ██
+//    ▄██▀     ██████   ██ ██ ██
+//   ▄██      ██▀  ▀██  ██    ██
+//  ███▄▄▄▄▄  ▀██▄▄██▀   ██▄▄██
+//  ▀▀▀▀▀▀▀▀    ▀▀▀▀      ▀▀▀▀   Multi.h
+// Version: 1.0.0
+//
+// This file contains the MultiCPU class, which interleaves several CPUs
+// on one global timebase, and the SharedAccessBus adapter that feeds it.
+//
+// Copyright (c) 2025-2026 Adam Szulc
+// MIT License
+
+#ifndef __Z80_MULTI_H__
+#define __Z80_MULTI_H__
+
+#include <Z80/CPU.h>
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Z80 {
+
+// Runs N CPUs (any instantiations, through ICPU) in slices of global time. Global time counts ticks of a
+// timebase clock; every CPU has its own clock rate, and its tick counter is kept at
+//   ticks at add() + (time - time at add()) * clock / timebase
+// by running it to that absolute target at the end of every slice, so the overshoot of one run() (up to one
+// instruction) is absorbed by the next instead of accumulating. Within a slice the CPUs run one after
+// another, so one CPU can see another's writes at most one slice early or late: the quantum bounds the skew.
+// Accesses to registered shared memory or ports (reported by the buses, e.g. through SharedAccessBus) switch
+// to the fine quantum for the following `hold` time, so handshakes through mailboxes run with a small skew
+// while the CPUs otherwise run in long slices. The switch takes effect from the next slice.
+class MultiCPU {
+public:
+    explicit MultiCPU(long long timebase_hz) : m_timebase_hz(timebase_hz) {
+    }
+    MultiCPU(const MultiCPU&) = delete;
+    MultiCPU& operator=(const MultiCPU&) = delete;
+
+    // Adds a CPU running at `clock_hz`; its current tick count corresponds to the current global time
+    size_t add(ICPU& cpu, long long clock_hz) {
+        m_cpus.push_back({&cpu, clock_hz, cpu.get_ticks(), m_time});
+        return m_cpus.size() - 1;
+    }
+    ICPU& get_cpu(size_t index) {
+        return *m_cpus[index].cpu;
+    }
+    size_t get_cpu_count() const {
+        return m_cpus.size();
+    }
+    // Slice length in global ticks while no shared access is being made
+    void set_quantum(long long quantum) {
+        m_quantum = quantum;
+    }
+    // Slice length for `hold` global ticks after a shared access
+    void set_fine_quantum(long long quantum, long long hold) {
+        m_fine_quantum = quantum;
+        m_fine_hold = hold;
+    }
+    // Shared memory [begin, end] and ports (matched on the low address byte, as most Z80 boards decode them)
+    void add_shared_memory(uint16_t begin, uint16_t end) {
+        for (uint32_t address = begin; address <= end; ++address)
+            m_shared_memory.set(address);
+    }
+    void add_shared_port(uint8_t port) {
+        m_shared_ports.set(port);
+    }
+    // Called by the buses on every memory or I/O access; true when the access was to a shared region
+    bool on_memory_access(uint16_t address) {
+        if (!m_shared_memory.test(address))
+            return false;
+        m_shared_access = true;
+        return true;
+    }
+    bool on_port_access(uint16_t port) {
+        if (!m_shared_ports.test(port & 0xFF))
+            return false;
+        m_shared_access = true;
+        return true;
+    }
+
+    // Runs every CPU until the global time reaches `time_limit`
+    void run(long long time_limit) {
+        while (m_time < time_limit) {
+            bool fine = m_time < m_fine_until;
+            long long slice_end = m_time + (fine ? m_fine_quantum : m_quantum);
+            if (slice_end > time_limit)
+                slice_end = time_limit;
+            for (size_t index = 0; index < m_cpus.size(); ++index)
+                m_cpus[index].cpu->run(get_target_ticks(index, slice_end));
+            m_time = slice_end;
+            ++m_slices;
+            if (fine)
+                ++m_fine_slices;
+            if (m_shared_access) {
+                m_shared_access = false;
+                m_fine_until = m_time + m_fine_hold;
+            }
+        }
+    }
+    long long get_time() const {
+        return m_time;
+    }
+    // Tick count the CPU is run to for global time `time`
+    long long get_target_ticks(size_t index, long long time) const {
+        const Entry& entry = m_cpus[index];
+        long long elapsed = time - entry.base_time;
+        return entry.base_ticks + (elapsed / m_timebase_hz) * entry.clock_hz +
+               (elapsed % m_timebase_hz) * entry.clock_hz / m_timebase_hz;
+    }
+    long long get_slices() const {
+        return m_slices;
+    }
+    long long get_fine_slices() const {
+        return m_fine_slices;
+    }
+
+private:
+    struct Entry {
+        ICPU* cpu;
+        long long clock_hz;
+        long long base_ticks;
+        long long base_time;
+    };
+    long long m_timebase_hz;
+    std::vector<Entry> m_cpus;
+    long long m_time = 0;
+    long long m_quantum = 1000;
+    long long m_fine_quantum = 1000;
+    long long m_fine_hold = 0;
+    long long m_fine_until = 0;
+    bool m_shared_access = false;
+    std::bitset<0x10000> m_shared_memory;
+    std::bitset<0x100> m_shared_ports;
+    long long m_slices = 0;
+    long long m_fine_slices = 0;
+};
+
+// Bus adapter that reports every access to a MultiCPU. On a paged bus the CPU reads and writes mapped pages
+// directly, so leave the shared regions unmapped to have them reported.
+template <typename TBus> class SharedAccessBus : public TBus {
+public:
+    using TBus::TBus;
+    void set_multi(MultiCPU* multi) {
+        m_multi = multi;
+    }
+    uint8_t read(uint16_t address) {
+        if (m_multi)
+            m_multi->on_memory_access(address);
+        return TBus::read(address);
+    }
+    void write(uint16_t address, uint8_t value) {
+        if (m_multi)
+            m_multi->on_memory_access(address);
+        TBus::write(address, value);
+    }
+    uint8_t in(uint16_t port) {
+        if (m_multi)
+            m_multi->on_port_access(port);
+        return TBus::in(port);
+    }
+    void out(uint16_t port, uint8_t value) {
+        if (m_multi)
+            m_multi->on_port_access(port);
+        TBus::out(port, value);
+    }
+
+private:
+    MultiCPU* m_multi = nullptr;
+};
+
+} // namespace Z80
+
+#endif //__Z80_MULTI_H__
@@ -0,0 +1,155 @@
+//  ▄▄▄▄▄▄▄▄    ▄▄▄▄      ▄▄▄▄
+//  ▀▀▀▀▀███  ▄██▀▀██▄   ██▀▀██
+//      ██▀   ██▄  ▄██  ██    ██
+//    ▄██▀     ██████   ██ ██ ██
+//   ▄██      ██▀  ▀██  ██    ██
+//  ███▄▄▄▄▄  ▀██▄▄██▀   ██▄▄██
+//  ▀▀▀▀▀▀▀▀    ▀▀▀▀      ▀▀▀▀   Recorder.h
+// Version: 1.0.0
+//
+// This file contains the RecordingBus adapter, which streams timestamped
+// port and memory writes to consumer threads through a lock-free ring buffer.
+//
+// Copyright (c) 2025-2026 Adam Szulc
+// MIT License
+
+#ifndef __Z80_RECORDER_H__
+#define __Z80_RECORDER_H__
+
+#include <Z80/CPU.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace Z80 {
+
+// Single-producer, single-consumer ring buffer. push() is called by one thread and consume()/pop() by one
+// other thread, without locks; each side keeps its index on its own cache line. A full buffer drops the new
+// item and counts it, so the producer never waits for the consumer.
+template <typename T> class RingBuffer {
+public:
+    // The capacity is rounded up to a power of two
+    explicit RingBuffer(size_t capacity) {
+        size_t size = 1;
+        while (size < capacity)
+            size <<= 1;
+        m_items.resize(size);
+        m_mask = size - 1;
+    }
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    // Producer side; false when the buffer is full and the item was dropped
+    bool push(const T& item) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_cached_tail > m_mask) {
+            m_cached_tail = m_tail.load(std::memory_order_acquire);
+            if (head - m_cached_tail > m_mask) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        m_items[head & m_mask] = item;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+    // Consumer side: hands up to `max` items to `consumer`, oldest first, then frees their slots in one store.
+    // Returns the number of items consumed.
+    template <typename TConsumer> size_t consume(TConsumer&& consumer, size_t max = SIZE_MAX) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t count = std::min(m_head.load(std::memory_order_acquire) - tail, max);
+        for (size_t i = 0; i < count; ++i)
+            consumer(m_items[(tail + i) & m_mask]);
+        m_tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+    size_t pop(T* items, size_t max) {
+        return consume([&items](const T& item) { *items++ = item; }, max);
+    }
+    // Items waiting; only a snapshot while the other side is running
+    size_t get_size() const {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+    size_t get_capacity() const {
+        return m_mask + 1;
+    }
+    long long get_dropped() const {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::vector<T> m_items;
+    size_t m_mask;
+    alignas(64) std::atomic<size_t> m_head{0}; // Producer
+    size_t m_cached_tail = 0;
+    std::atomic<long long> m_dropped{0};
+    alignas(64) std::atomic<size_t> m_tail{0}; // Consumer
+};
+
+struct IORecord {
+    enum Kind : uint8_t { Out, Write };
+    long long tick;   // CPU tick count seen by the bus during the access
+    uint16_t address; // Port (full 16 bits) or memory address
+    uint8_t value;
+    Kind kind;
+};
+
+// Bus adapter that records every out() and the write() calls to registered memory ranges into a RingBuffer,
+// for audio or video threads that need each access with its exact tick. The device behind TBus still gets
+// every access. On a paged bus the CPU writes mapped pages directly, so leave recorded ranges unmapped.
+template <typename TBus> class RecordingBus : public TBus {
+public:
+    using TBus::TBus;
+    template <typename TCPU> void connect(TCPU* cpu) {
+        m_cpu = cpu;
+        TBus::connect(cpu);
+    }
+    void set_recorder(RingBuffer<IORecord>* recorder) {
+        m_recorder = recorder;
+    }
+    // Records writes to [begin, end]
+    void add_recorded_memory(uint16_t begin, uint16_t end) {
+        for (uint32_t address = begin; address <= end; ++address)
+            m_recorded_memory.set(address);
+    }
+
+    void write(uint16_t address, uint8_t value) {
+        if (m_recorded_memory.test(address))
+            record(IORecord::Write, address, value, m_cpu->get_ticks());
+        TBus::write(address, value);
+    }
+    void out(uint16_t port, uint8_t value) {
+        record(IORecord::Out, port, value, m_cpu->get_ticks());
+        TBus::out(port, value);
+    }
+    // OTIR/OTDR runs, when TBus takes them: iteration i starts 21 * i T-states after the call and writes the
+    // port 12 T-states in (ED and opcode fetches, wait state, memory read), as out() would have seen it
+    template <typename T = TBus, typename = std::enable_if_t<has_out_block_v<T>>>
+    size_t out_block(uint16_t port, const uint8_t* src, size_t n) {
+        size_t moved = TBus::out_block(port, src, n);
+        long long tick = m_cpu->get_ticks() + BLOCK_OUT_OFFSET;
+        for (size_t i = 0; i < moved; ++i, tick += BLOCK_OUT_TICKS)
+            record(IORecord::Out, (uint16_t)(port - (i << 8)), src[i], tick);
+        return moved;
+    }
+
+private:
+    static constexpr long long BLOCK_OUT_TICKS = 21;
+    static constexpr long long BLOCK_OUT_OFFSET = 12;
+    void record(IORecord::Kind kind, uint16_t address, uint8_t value, long long tick) {
+        if (m_recorder)
+            m_recorder->push({tick, address, value, kind});
+    }
+    const ICPU* m_cpu = nullptr;
+    RingBuffer<IORecord>* m_recorder = nullptr;
+    std::bitset<0x10000> m_recorded_memory;
+};
+
+} // namespace Z80
+
+#endif //__Z80_RECORDER_H__
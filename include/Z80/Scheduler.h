@@ -0,0 +1,278 @@
+//  ▄▄▄▄▄▄▄▄    ▄▄▄▄      ▄▄▄▄
+//  ▀▀▀▀▀███  ▄██▀▀██▄   ██▀▀██
+//      ██▀   ██▄  ▄██  ██    ██
+//    ▄██▀     ██████   ██ ██ ██
+//   ▄██      ██▀  ▀██  ██    ██
+//  ███▄▄▄▄▄  ▀██▄▄██▀   ██▄▄██
+//  ▀▀▀▀▀▀▀▀    ▀▀▀▀      ▀▀▀▀   Scheduler.h
+// Version: 1.0.0
+//
+// This file contains the Scheduler class, a TEvents implementation that
+// multiplexes any number of periodic and one-shot timed events.
+//
+// Copyright (c) 2025-2026 Adam Szulc
+// MIT License
+
+#ifndef __Z80_SCHEDULER_H__
+#define __Z80_SCHEDULER_H__
+
+#include <Z80/CPU.h>
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace Z80 {
+
+// TEvents with registerable event sources, e.g. a video line timer, an audio sampler and a CTC on one CPU.
+// The deadlines are kept in a binary min-heap and the earliest one is cached, so get_event_limit(), which
+// the CPU queries on every tick it accounts, is a plain load. Events due at the same tick fire in the order
+// they were added. A callback receives the tick it was due at and may add, cancel or reschedule any event,
+// itself included.
+// Deadlines are absolute CPU ticks and always lie after the current tick: a deadline at or before it is
+// moved to the next tick. Periodic events fire at every tick t > 0 with t % period == phase, so they keep
+// their phase across CPU::reset() (which also resets the scheduler); one-shot events are dropped by reset(),
+// and the CPU constructor calls it, so add them once the CPU exists.
+class Scheduler {
+public:
+    using Callback = std::function<void(long long tick)>;
+    using EventId = uint64_t; // Generation << 32 | slot; never reused by a later event
+    static constexpr EventId NO_EVENT = 0;
+
+    Scheduler() = default;
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    template <typename TBus, typename TEvents, typename TDebugger, bool EnableNext, typename TConfig>
+    void connect(const CPU<TBus, TEvents, TDebugger, EnableNext, TConfig>* cpu) {
+        m_cpu = cpu;
+    }
+    void reset() {
+        for (uint32_t slot = 0; slot < m_events.size(); ++slot) {
+            Event& event = m_events[slot];
+            if (!event.active)
+                continue;
+            if (event.period == 0)
+                release(slot);
+            else
+                move(slot, next_phase(event.period, event.phase));
+        }
+    }
+    long long get_event_limit() const {
+        return m_limit;
+    }
+    void handle_event(long long tick) {
+        while (!m_heap.empty() && m_events[m_heap[0]].deadline <= tick) {
+            uint32_t slot = m_heap[0];
+            Event& event = m_events[slot];
+            long long deadline = event.deadline;
+            m_firing = slot;
+            if (event.period != 0) {
+                event.deadline += event.period;
+                sift_down(0);
+                update_limit();
+                event.callback(deadline);
+            } else {
+                remove(slot);
+                event.callback(deadline);
+                if (event.active && event.heap_index == NOT_QUEUED) // Not rescheduled by its own callback
+                    release(slot);
+            }
+            m_firing = NOT_QUEUED;
+            if (m_release_firing) {
+                m_release_firing = false;
+                free_slot(slot);
+            }
+        }
+    }
+
+    // Fires once at `tick`
+    EventId add_at(long long tick, Callback callback) {
+        return add(tick, 0, 0, std::move(callback));
+    }
+    // Fires once `delay` T-states from now
+    EventId add_in(long long delay, Callback callback) {
+        return add(get_ticks() + delay, 0, 0, std::move(callback));
+    }
+    // Fires every `period` (> 0) T-states, at the ticks where tick % period == phase
+    EventId add_periodic(long long period, Callback callback, long long phase = 0) {
+        phase %= period;
+        return add(next_phase(period, phase), period, phase, std::move(callback));
+    }
+    // Removes a scheduled event; false when it has already fired (one-shot) or was removed
+    bool cancel(EventId id) {
+        uint32_t slot;
+        if (!find(id, slot))
+            return false;
+        if (m_events[slot].heap_index != NOT_QUEUED)
+            remove(slot);
+        release(slot);
+        return true;
+    }
+    // Moves the next deadline of an event; a periodic event then continues every period from there
+    bool reschedule_at(EventId id, long long tick) {
+        uint32_t slot;
+        if (!find(id, slot))
+            return false;
+        Event& event = m_events[slot];
+        if (event.period != 0)
+            event.phase = tick % event.period;
+        move(slot, tick);
+        return true;
+    }
+    bool reschedule_in(EventId id, long long delay) {
+        return reschedule_at(id, get_ticks() + delay);
+    }
+    bool is_scheduled(EventId id) const {
+        uint32_t slot;
+        return find(id, slot) && m_events[slot].heap_index != NOT_QUEUED;
+    }
+    // Next deadline of a scheduled event, LLONG_MAX for any other id
+    long long get_deadline(EventId id) const {
+        uint32_t slot;
+        return find(id, slot) && m_events[slot].heap_index != NOT_QUEUED ? m_events[slot].deadline : LLONG_MAX;
+    }
+    size_t get_scheduled_count() const {
+        return m_heap.size();
+    }
+    // Current tick of the connected CPU (0 before one is connected)
+    long long get_ticks() const {
+        return m_cpu ? m_cpu->get_ticks() : 0;
+    }
+
+private:
+    static constexpr uint32_t NOT_QUEUED = UINT32_MAX;
+    struct Event {
+        long long deadline = LLONG_MAX;
+        long long period = 0; // 0 for a one-shot event
+        long long phase = 0;
+        uint64_t order = 0; // Tie-break between equal deadlines
+        uint32_t heap_index = NOT_QUEUED;
+        uint32_t generation = 1; // Keeps every id distinct from NO_EVENT
+        bool active = false;
+        Callback callback;
+    };
+
+    EventId add(long long deadline, long long period, long long phase, Callback callback) {
+        uint32_t slot;
+        if (!m_free.empty()) {
+            slot = m_free.back();
+            m_free.pop_back();
+        } else {
+            slot = (uint32_t)m_events.size();
+            m_events.emplace_back(); // A deque keeps the Event of a running callback in place
+        }
+        Event& event = m_events[slot];
+        event.period = period;
+        event.phase = phase;
+        event.order = m_next_order++;
+        event.active = true;
+        event.callback = std::move(callback);
+        move(slot, deadline);
+        return (EventId)event.generation << 32 | slot;
+    }
+    bool find(EventId id, uint32_t& slot) const {
+        slot = (uint32_t)id;
+        return slot < m_events.size() && m_events[slot].active && m_events[slot].generation == (uint32_t)(id >> 32);
+    }
+    long long next_phase(long long period, long long phase) const {
+        long long now = get_ticks();
+        long long deadline = now - now % period + phase;
+        return deadline > now ? deadline : deadline + period;
+    }
+    // (Re)queues an active event at `deadline`, clamped to after the current tick
+    void move(uint32_t slot, long long deadline) {
+        long long now = get_ticks();
+        Event& event = m_events[slot];
+        event.deadline = deadline > now ? deadline : now + 1;
+        if (event.heap_index == NOT_QUEUED) {
+            event.heap_index = (uint32_t)m_heap.size();
+            m_heap.push_back(slot);
+        }
+        sift_up(sift_down(event.heap_index));
+        update_limit();
+    }
+    void remove(uint32_t slot) {
+        uint32_t index = m_events[slot].heap_index;
+        uint32_t last = m_heap.back();
+        m_heap.pop_back();
+        m_events[slot].heap_index = NOT_QUEUED;
+        if (last != slot) {
+            m_heap[index] = last;
+            m_events[last].heap_index = index;
+            sift_up(sift_down(index));
+        }
+        update_limit();
+    }
+    // Drops an event that is no longer queued; the slot of the running callback is freed once it returns
+    void release(uint32_t slot) {
+        if (m_events[slot].heap_index != NOT_QUEUED)
+            remove(slot);
+        m_events[slot].active = false;
+        if (slot == m_firing)
+            m_release_firing = true;
+        else
+            free_slot(slot);
+    }
+    void free_slot(uint32_t slot) {
+        Event& event = m_events[slot];
+        event.callback = nullptr;
+        ++event.generation;
+        m_free.push_back(slot);
+    }
+    bool earlier(uint32_t a, uint32_t b) const {
+        const Event& x = m_events[a];
+        const Event& y = m_events[b];
+        return x.deadline < y.deadline || (x.deadline == y.deadline && x.order < y.order);
+    }
+    uint32_t sift_up(uint32_t index) {
+        while (index > 0) {
+            uint32_t parent = (index - 1) / 2;
+            if (!earlier(m_heap[index], m_heap[parent]))
+                break;
+            swap_entries(index, parent);
+            index = parent;
+        }
+        return index;
+    }
+    uint32_t sift_down(uint32_t index) {
+        uint32_t size = (uint32_t)m_heap.size();
+        while (true) {
+            uint32_t child = 2 * index + 1;
+            if (child >= size)
+                break;
+            if (child + 1 < size && earlier(m_heap[child + 1], m_heap[child]))
+                ++child;
+            if (!earlier(m_heap[child], m_heap[index]))
+                break;
+            swap_entries(index, child);
+            index = child;
+        }
+        return index;
+    }
+    void swap_entries(uint32_t a, uint32_t b) {
+        std::swap(m_heap[a], m_heap[b]);
+        m_events[m_heap[a]].heap_index = a;
+        m_events[m_heap[b]].heap_index = b;
+    }
+    void update_limit() {
+        m_limit = m_heap.empty() ? LLONG_MAX : m_events[m_heap[0]].deadline;
+    }
+
+    long long m_limit = LLONG_MAX;
+    const ICPU* m_cpu = nullptr;
+    std::deque<Event> m_events; // Indexed by slot
+    std::vector<uint32_t> m_heap; // Slots ordered by (deadline, order)
+    std::vector<uint32_t> m_free;
+    uint64_t m_next_order = 0;
+    uint32_t m_firing = NOT_QUEUED;
+    bool m_release_firing = false;
+};
+
+} // namespace Z80
+
+#endif //__Z80_SCHEDULER_H__
@@ -0,0 +1,47 @@
+// Micro-benchmark: host time per instruction for the ALU, rotate/shift, DAA, HL/IX-addressed and bit instruction classes.
+// Each class runs a block of identical instructions closed by JP back to its start.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <Z80/CPU.h>
+
+struct BenchCase {
+    const char* name;
+    std::vector<uint8_t> opcode;
+    int ticks;
+};
+
+int main(int argc, char* argv[]) {
+    const long long ticks_per_case = argc > 1 ? atoll(argv[1]) : 200000000LL;
+    const BenchCase cases[] = {
+        {"ADD A,B", {0x80}, 4},   {"ADC A,B", {0x88}, 4},   {"SUB B", {0x90}, 4},     {"SBC A,B", {0x98}, 4},
+        {"AND B", {0xA0}, 4},     {"XOR B", {0xA8}, 4},     {"OR B", {0xB0}, 4},      {"CP B", {0xB8}, 4},
+        {"INC B", {0x04}, 4},     {"DEC B", {0x05}, 4},     {"DAA", {0x27}, 4},       {"RLC B", {0xCB, 0x00}, 8},
+        {"RR B", {0xCB, 0x18}, 8}, {"SLA B", {0xCB, 0x20}, 8}, {"SRL B", {0xCB, 0x38}, 8},
+        {"LD A,(HL)", {0x7E}, 7}, {"ADD A,L", {0x85}, 4}, {"INC HL", {0x23}, 6}, {"LD A,(IX+d)", {0xDD, 0x7E, 0x01}, 19},
+        {"ADD A,IXL", {0xDD, 0x85}, 8}, {"INC IX", {0xDD, 0x23}, 10}, {"BIT 3,C", {0xCB, 0x59}, 8},
+        {"SET 5,(HL)", {0xCB, 0xEE}, 15}, {"RES 1,(IX+d)", {0xDD, 0xCB, 0x01, 0x8E}, 23},
+    };
+    const int BLOCK = 64;
+    printf("%-12s %12s %10s\n", "Class", "Instructions", "ns/instr");
+    for (const BenchCase& c : cases) {
+        Z80::CPU<> cpu;
+        uint16_t address = 0x0100;
+        for (int i = 0; i < BLOCK; ++i)
+            for (uint8_t byte : c.opcode)
+                cpu.get_bus()->write(address++, byte);
+        cpu.get_bus()->write(address++, 0xC3);
+        cpu.get_bus()->write(address++, 0x00);
+        cpu.get_bus()->write(address++, 0x01);
+        cpu.set_PC(0x0100);
+        cpu.set_BC(0x5A3C);
+        auto start = std::chrono::steady_clock::now();
+        long long ticks = cpu.run(ticks_per_case);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        long long iterations = ticks / (BLOCK * c.ticks + 10);
+        long long instructions = iterations * (BLOCK + 1);
+        printf("%-12s %12lld %10.2f\n", c.name, instructions, seconds * 1e9 / (double)instructions);
+    }
+    return 0;
+}
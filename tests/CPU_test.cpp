@@ -12,13 +12,24 @@
 // Copyright (c) 2025-2026 Adam Szulc
 // MIT License
 
+#include <Z80/Batch.h>
 #include <Z80/CPU.h>
+#include <Z80/Farm.h>
+#include <Z80/HotSwap.h>
+#include <Z80/Lockstep.h>
+#include <Z80/Multi.h>
+#include <Z80/Recorder.h>
+#include <Z80/Scheduler.h>
 #include <iostream>
 #include <vector>
 #include <cassert>
 #include <iomanip>
 #include <map>
 #include <sstream>
+#include <functional>
+#include <atomic>
+#include <chrono>
+#include <thread>
 
 // Simple Bus for testing
 class TestBus : public Z80::StandardBus {
@@ -1438,6 +1449,1090 @@ void test_interrupts() {
     check(cpu.get_PC() == 0x0010, "IM 0 executes opcode (RST 10H)");
 }
 
+// Periodic events used to check that handle_event() fires on the exact T-state
+class PeriodicEvents {
+public:
+    template <typename TCPU> void connect(const TCPU* cpu) {
+        m_get_ticks = [cpu]() { return cpu->get_ticks(); };
+    }
+    void reset() {
+        m_next = PERIOD;
+        fired.clear();
+        mismatches = 0;
+    }
+    long long get_event_limit() const { return m_next; }
+    void handle_event(long long tick) {
+        if (tick != m_get_ticks())
+            ++mismatches;
+        fired.push_back(tick);
+        m_next = tick + PERIOD;
+    }
+    static constexpr long long PERIOD = 7;
+    std::vector<long long> fired;
+    int mismatches = 0;
+
+private:
+    long long m_next = PERIOD;
+    std::function<long long()> m_get_ticks;
+};
+
+void test_event_timing() {
+    Z80::CPU<TestBus, PeriodicEvents> cpu;
+    cpu.reset();
+    // LD HL,0x8000 / LD DE,0x9000 / LD BC,0x0010 / LDIR / PUSH BC / POP BC / OUT (0xFE),A / JR $
+    const uint8_t program[] = {0x21, 0x00, 0x80, 0x11, 0x00, 0x90, 0x01, 0x10, 0x00, 0xED, 0xB0,
+                               0xC5, 0xC1, 0xD3, 0xFE, 0x18, 0xFE};
+    for (size_t i = 0; i < sizeof(program); ++i)
+        cpu.get_bus()->write(0x0100 + i, program[i]);
+    cpu.set_PC(0x0100);
+    long long executed = cpu.run(1000);
+    auto* events = cpu.get_events();
+    bool periodic = !events->fired.empty();
+    for (size_t i = 0; i < events->fired.size(); ++i)
+        periodic = periodic && events->fired[i] == (long long)(i + 1) * PeriodicEvents::PERIOD;
+    check(periodic, "Events fire on every period boundary");
+    check(events->fired.size() == (size_t)(executed / PeriodicEvents::PERIOD), "No event skipped or repeated");
+    check(events->mismatches == 0, "Event tick matches CPU tick counter");
+}
+
+void test_scheduler() {
+    Z80::Scheduler scheduler;
+    std::vector<std::pair<char, long long>> fired;
+    int mismatches = 0;
+    Z80::CPU<TestBus, Z80::Scheduler>* cpu_ptr = nullptr;
+    auto log = [&](char source) {
+        return [&, source](long long tick) {
+            if (tick != cpu_ptr->get_ticks())
+                ++mismatches;
+            fired.push_back({source, tick});
+        };
+    };
+    scheduler.add_periodic(224, log('L')); // Added before the CPU: periodic events survive its reset()
+    Z80::CPU<TestBus, Z80::Scheduler> cpu(nullptr, &scheduler);
+    cpu_ptr = &cpu;
+    // LD HL,0x8000 / LD DE,0x9000 / LD BC,0x0010 / LDIR / PUSH BC / POP BC / OUT (0xFE),A / JR $
+    const uint8_t program[] = {0x21, 0x00, 0x80, 0x11, 0x00, 0x90, 0x01, 0x10, 0x00, 0xED, 0xB0,
+                               0xC5, 0xC1, 0xD3, 0xFE, 0x18, 0xFE};
+    for (size_t i = 0; i < sizeof(program); ++i)
+        cpu.get_bus()->write(0x0100 + i, program[i]);
+    cpu.set_PC(0x0100);
+    int samples = 0;
+    Z80::Scheduler::EventId sample = scheduler.add_periodic(100, [&](long long tick) {
+        log('S')(tick);
+        if (++samples == 5)
+            scheduler.cancel(sample);
+    }, 7);
+    Z80::Scheduler::EventId once = scheduler.add_at(300, [&](long long tick) {
+        log('O')(tick);
+        if (tick == 300)
+            scheduler.reschedule_in(once, 50);
+    });
+    Z80::Scheduler::EventId dropped = scheduler.add_in(150, log('D'));
+    scheduler.add_at(448, log('T'));
+    check(scheduler.get_event_limit() == 7 && scheduler.get_deadline(dropped) == 150, "Scheduler: earliest deadline cached");
+    check(scheduler.cancel(dropped) && !scheduler.cancel(dropped) && !scheduler.is_scheduled(dropped),
+          "Scheduler: cancel once");
+    cpu.run(1000);
+    const std::vector<std::pair<char, long long>> expected = {
+        {'S', 7},   {'S', 107}, {'S', 207}, {'L', 224}, {'O', 300}, {'S', 307}, {'O', 350}, {'S', 407},
+        {'L', 448}, {'T', 448}, {'L', 672}, {'L', 896}};
+    check(fired == expected, "Scheduler: periodic, phased, rescheduled and cancelled events fire in deadline order");
+    check(mismatches == 0, "Scheduler: events fire on the exact T-state");
+    check(!scheduler.is_scheduled(sample) && !scheduler.is_scheduled(once) && scheduler.get_scheduled_count() == 1,
+          "Scheduler: self-cancelled and fired one-shot events are gone");
+    scheduler.add_in(500, log('D'));
+    cpu.reset();
+    check(scheduler.get_scheduled_count() == 1 && scheduler.get_event_limit() == 224,
+          "Scheduler: reset() drops one-shot events and re-phases periodic ones");
+}
+
+// Paged bus with a memory-mapped device on 0x4000-0x43FF and a bank switch port
+class TestPagedBus : public Z80::PagedBus {
+public:
+    TestPagedBus() {
+        for (int i = 0; i < 2; ++i)
+            std::fill(std::begin(banks[i]), std::end(banks[i]), (uint8_t)(0xB0 + i));
+        map(0x0000, sizeof(rom), rom, false);
+        unmap(0x4000, PAGE_SIZE);
+        map(0xC000, sizeof(banks[0]), banks[0]);
+    }
+    uint8_t read(uint16_t address) {
+        if ((address & 0xFC00) == 0x4000)
+            return device_value;
+        return Z80::PagedBus::read(address);
+    }
+    void write(uint16_t address, uint8_t value) {
+        if ((address & 0xFC00) == 0x4000)
+            device_writes.push_back(value);
+        else
+            Z80::PagedBus::write(address, value);
+    }
+    void out(uint16_t port, uint8_t value) {
+        map(0xC000, sizeof(banks[0]), banks[value & 1]);
+    }
+    uint8_t rom[0x4000] = {};
+    uint8_t banks[2][0x4000];
+    uint8_t device_value = 0x5A;
+    std::vector<uint8_t> device_writes;
+};
+
+void test_paged_bus() {
+    static_assert(Z80::is_paged_bus_v<Z80::PagedBus>, "PagedBus exposes page tables");
+    static_assert(!Z80::is_paged_bus_v<Z80::StandardBus>, "StandardBus has no page tables");
+    Z80::CPU<TestPagedBus> cpu;
+    auto* bus = cpu.get_bus();
+    // LD A,(0x4000) / LD (0x4001),A / LD (0x0010),A / LD A,(0xC000) / LD B,A / LD A,1 / OUT (0),A
+    // LD A,(0xC000) / LD (0x8000),A / HALT
+    const uint8_t program[] = {0x3A, 0x00, 0x40, 0x32, 0x01, 0x40, 0x32, 0x10, 0x00, 0x3A, 0x00, 0xC0, 0x47,
+                               0x3E, 0x01, 0xD3, 0x00, 0x3A, 0x00, 0xC0, 0x32, 0x00, 0x80, 0x76};
+    for (size_t i = 0; i < sizeof(program); ++i)
+        bus->poke(0x0100 + i, program[i]);
+    check(bus->rom[0x0100] == 0x3A, "PagedBus poke patches read-only pages");
+    cpu.set_PC(0x0100);
+    while (!cpu.is_halted())
+        cpu.step();
+    check(bus->device_writes.size() == 1 && bus->device_writes[0] == 0x5A, "Unmapped page goes through bus callbacks");
+    check(bus->rom[0x0010] == 0x00, "Writes to read-only pages are dropped");
+    check(cpu.get_B() == 0xB0, "Mapped bank is read directly");
+    check(bus->peek(0x8000) == 0xB1 && bus->get_ram()[0x8000] == 0xB1, "Bank switch by remapping pages");
+    check(cpu.get_ticks() == 13 + 13 + 13 + 13 + 4 + 7 + 11 + 13 + 13 + 4, "Paged accesses keep instruction timing");
+
+    TestPagedBus copy(*bus);
+    copy.get_ram()[0x8000] = 0x00;
+    check(bus->peek(0x8000) == 0xB1 && copy.peek(0x8000) == 0x00, "Copied PagedBus maps its own RAM");
+}
+
+// Repeating block instructions on a PagedBus take the fast-forward path; StandardBus runs them
+// iteration by iteration
+void test_block_fast_forward() {
+    struct Case {
+        const char* name;
+        uint8_t opcode;
+        uint16_t hl, de, bc;
+        long long slice;
+        uint8_t a = 0x5A;
+        int fill = -1;
+    };
+    const Case cases[] = {
+        {"LDIR disjoint", 0xB0, 0x8000, 0x9000, 0x1800, 1000000},
+        {"LDIR pattern fill", 0xB0, 0x4000, 0x4001, 0x0800, 1000000},
+        {"LDIR across wrap", 0xB0, 0xFF00, 0x7F80, 0x0300, 1000000},
+        {"LDIR overwrites itself", 0xB0, 0x3000, 0x00F0, 0x0100, 1000000},
+        {"LDIR sliced run", 0xB0, 0x8000, 0x8003, 0x1000, 777},
+        {"LDDR disjoint", 0xB8, 0x9FFF, 0xBFFF, 0x1000, 1000000},
+        {"LDDR pattern fill", 0xB8, 0x5001, 0x5000, 0x0900, 1000000},
+        {"LDDR overlapping", 0xB8, 0x6000, 0x6010, 0x0400, 555},
+        {"LDIRX", 0xB4, 0x8000, 0x8001, 0x0500, 1000000},
+        {"LDDRX", 0xBC, 0x8500, 0x8400, 0x0500, 1000},
+        {"LDPIRX", 0xB7, 0x8000, 0x9000, 0x0400, 1000000},
+        {"LDIRSCALE", 0xB6, 0x8000, 0x9000, 0x0300, 1000000},
+        {"CPIR match", 0xB1, 0x8000, 0x0000, 0x2000, 1000000, 0x5A},
+        {"CPIR exhausts BC", 0xB1, 0xF000, 0x0000, 0x2000, 1000000, 0x5A, 0x33},
+        {"CPIR sliced run", 0xB1, 0x2000, 0x0000, 0x3000, 999, 0x00, 0x80},
+        {"CPDR match", 0xB9, 0x8000, 0x0000, 0x2000, 1000000, 0x5A},
+        {"CPDR exhausts BC", 0xB9, 0x0100, 0x0000, 0x1000, 1000000, 0x5A, 0xA5},
+    };
+    for (const Case& c : cases) {
+        Z80::CPU<Z80::PagedBus, Z80::StandardEvents, Z80::StandardDebugger, true> paged;
+        Z80::CPU<Z80::StandardBus, Z80::StandardEvents, Z80::StandardDebugger, true> plain;
+        for (uint32_t address = 0; address < 0x10000; ++address) {
+            uint8_t value = c.fill >= 0 ? (uint8_t)c.fill : (uint8_t)(address * 7 + (address >> 8));
+            paged.get_bus()->write(address, value);
+            plain.get_bus()->write(address, value);
+        }
+        const uint8_t program[] = {0xED, c.opcode, 0x76};
+        for (size_t i = 0; i < sizeof(program); ++i) {
+            paged.get_bus()->write(0x0100 + i, program[i]);
+            plain.get_bus()->write(0x0100 + i, program[i]);
+        }
+        for (auto* cpu : {static_cast<Z80::ICPU*>(&paged), static_cast<Z80::ICPU*>(&plain)}) {
+            cpu->set_PC(0x0100);
+            cpu->set_HL(c.hl);
+            cpu->set_DE(c.de);
+            cpu->set_BC(c.bc);
+            cpu->set_BCp(0x0003);
+            cpu->set_A(c.a);
+            cpu->set_R(0x7E);
+        }
+        bool same = true;
+        for (int slice = 0; slice < 1000 && !plain.is_halted(); ++slice) {
+            long long limit = plain.get_ticks() + c.slice;
+            same = same && paged.run(limit) == plain.run(limit);
+            auto a = paged.save_state();
+            auto b = plain.save_state();
+            same = same && a.m_AF.w == b.m_AF.w && a.m_BC.w == b.m_BC.w && a.m_DE.w == b.m_DE.w &&
+                   a.m_HL.w == b.m_HL.w && a.m_WZ.w == b.m_WZ.w && a.m_PC.w == b.m_PC.w && a.m_R == b.m_R &&
+                   a.m_Q == b.m_Q && a.m_ticks == b.m_ticks && paged.get_data_bus() == plain.get_data_bus() &&
+                   paged.get_address_bus() == plain.get_address_bus();
+        }
+        for (uint32_t address = 0; address < 0x10000 && same; ++address)
+            same = paged.get_bus()->peek(address) == plain.get_bus()->peek(address);
+        check(same && plain.is_halted(), std::string("Block fast-forward matches: ") + c.name);
+    }
+}
+
+// Device ports on a PagedBus; the block variant also takes whole runs through in_block/out_block
+class PortLogBus : public Z80::PagedBus {
+public:
+    uint8_t in(uint16_t port) {
+        transfers.push_back({port, (uint8_t)(port * 3 + transfers.size())});
+        return transfers.back().value;
+    }
+    void out(uint16_t port, uint8_t value) {
+        transfers.push_back({port, value});
+    }
+    std::vector<TestBus::IOWrite> transfers;
+};
+class BlockPortLogBus : public PortLogBus {
+public:
+    size_t in_block(uint16_t port, uint8_t* dst, size_t n) {
+        ++block_calls;
+        for (size_t i = 0; i < n; ++i)
+            dst[i] = in(port - (uint16_t)(i << 8));
+        return n;
+    }
+    size_t out_block(uint16_t port, const uint8_t* src, size_t n) {
+        ++block_calls;
+        for (size_t i = 0; i < n; ++i)
+            out(port - (uint16_t)(i << 8), src[i]);
+        return n;
+    }
+    int block_calls = 0;
+};
+
+void test_block_io() {
+    static_assert(Z80::has_in_block_v<BlockPortLogBus> && Z80::has_out_block_v<BlockPortLogBus>, "Block I/O detected");
+    static_assert(!Z80::has_in_block_v<PortLogBus> && !Z80::has_out_block_v<PortLogBus>, "No block I/O on plain bus");
+    const struct {
+        const char* name;
+        uint8_t opcode;
+        uint16_t hl;
+    } cases[] = {{"INIR", 0xB2, 0x8000}, {"INDR", 0xBA, 0x80FF}, {"OTIR", 0xB3, 0x8000}, {"OTDR", 0xBB, 0x80FF},
+                 {"INIR overwrites itself", 0xB2, 0x00C0}};
+    for (const auto& c : cases) {
+        Z80::CPU<BlockPortLogBus> block;
+        Z80::CPU<PortLogBus> plain;
+        for (uint32_t address = 0x8000; address < 0x8100; ++address) {
+            block.get_bus()->write(address, (uint8_t)(address ^ 0x5A));
+            plain.get_bus()->write(address, (uint8_t)(address ^ 0x5A));
+        }
+        const uint8_t program[] = {0xED, c.opcode, 0x76};
+        for (size_t i = 0; i < sizeof(program); ++i) {
+            block.get_bus()->write(0x0100 + i, program[i]);
+            plain.get_bus()->write(0x0100 + i, program[i]);
+        }
+        for (auto* cpu : {static_cast<Z80::ICPU*>(&block), static_cast<Z80::ICPU*>(&plain)}) {
+            cpu->set_PC(0x0100);
+            cpu->set_HL(c.hl);
+            cpu->set_BC(0xF0FE);
+        }
+        block.run(100000);
+        plain.run(100000);
+        auto a = block.save_state();
+        auto b = plain.save_state();
+        bool same = a.m_AF.w == b.m_AF.w && a.m_BC.w == b.m_BC.w && a.m_HL.w == b.m_HL.w && a.m_WZ.w == b.m_WZ.w &&
+                    a.m_PC.w == b.m_PC.w && a.m_R == b.m_R && a.m_ticks == b.m_ticks &&
+                    block.get_data_bus() == plain.get_data_bus() && block.get_address_bus() == plain.get_address_bus();
+        const auto& x = block.get_bus()->transfers;
+        const auto& y = plain.get_bus()->transfers;
+        same = same && x.size() == y.size();
+        for (size_t i = 0; same && i < x.size(); ++i)
+            same = x[i].port == y[i].port && x[i].value == y[i].value;
+        for (uint32_t address = 0; same && address < 0x10000; ++address)
+            same = block.get_bus()->peek(address) == plain.get_bus()->peek(address);
+        check(same && block.get_bus()->block_calls > 0, std::string("Block I/O matches per-byte transfers: ") + c.name);
+    }
+}
+
+// Vertical blank style events: every period sets a flag in memory and raises a maskable interrupt
+class FrameEvents {
+public:
+    template <typename TCPU> void connect(TCPU* cpu) {
+        m_raise = [cpu]() {
+            cpu->get_bus()->write(0x8000, 0x01);
+            cpu->request_interrupt(0xFF);
+        };
+    }
+    void reset() {
+        m_next = PERIOD;
+        frames = 0;
+    }
+    long long get_event_limit() const { return m_next; }
+    void handle_event(long long tick) {
+        ++frames;
+        m_raise();
+        m_next = tick + PERIOD;
+    }
+    static constexpr long long PERIOD = 5000;
+    int frames = 0;
+
+private:
+    long long m_next = PERIOD;
+    std::function<void()> m_raise;
+};
+// Not StandardBus itself, so the CPU has to execute every idle loop iteration
+class SideEffectBus : public Z80::StandardBus {};
+
+void test_idle_loops() {
+    struct Case {
+        const char* name;
+        std::vector<uint8_t> main;
+        long long slice;
+    };
+    // Each program starts at 0x0100 after LD SP,0xF000 / IM 1 / EI; the handler at 0x0038 is INC D / EI / RET
+    const Case cases[] = {
+        {"JR $", {0x18, 0xFE}, 100000},
+        {"JP $", {0xC3, 0x06, 0x01}, 100000},
+        {"HALT", {0x76, 0x18, 0xFD}, 100000},
+        // LD A,(0x8000) / OR A / JR Z,-6 / XOR A / LD (0x8000),A / HALT / JP 0x0106
+        {"Polling loop", {0x3A, 0x00, 0x80, 0xB7, 0x28, 0xFA, 0xAF, 0x32, 0x00, 0x80, 0x76, 0xC3, 0x06, 0x01}, 100000},
+        // LD BC,0x8000 / LD A,(BC) / CP 0x01 / JR NZ,-5 / XOR A / LD (BC),A / JR -9
+        {"Register polling loop", {0x01, 0x00, 0x80, 0x0A, 0xFE, 0x01, 0x20, 0xFB, 0xAF, 0x02, 0x18, 0xF7}, 1234},
+        // BIT 0,(HL) / JR Z,-4 with HL=0x8000, never cleared
+        {"BIT wait", {0x21, 0x00, 0x80, 0xCB, 0x46, 0x28, 0xFC, 0x18, 0xFE}, 777},
+    };
+    for (const Case& c : cases) {
+        Z80::CPU<Z80::StandardBus, FrameEvents> fast;
+        Z80::CPU<SideEffectBus, FrameEvents> plain;
+        std::vector<uint8_t> program = {0x31, 0x00, 0xF0, 0xED, 0x56, 0xFB};
+        program.insert(program.end(), c.main.begin(), c.main.end());
+        const uint8_t handler[] = {0x14, 0xFB, 0xC9};
+        for (size_t i = 0; i < program.size(); ++i) {
+            fast.get_bus()->write(0x0100 + i, program[i]);
+            plain.get_bus()->write(0x0100 + i, program[i]);
+        }
+        for (size_t i = 0; i < sizeof(handler); ++i) {
+            fast.get_bus()->write(0x0038 + i, handler[i]);
+            plain.get_bus()->write(0x0038 + i, handler[i]);
+        }
+        fast.set_PC(0x0100);
+        plain.set_PC(0x0100);
+        bool same = true;
+        while (plain.get_ticks() < 50 * FrameEvents::PERIOD) {
+            long long limit = plain.get_ticks() + c.slice;
+            same = same && fast.run(limit) == plain.run(limit);
+            auto a = fast.save_state();
+            auto b = plain.save_state();
+            same = same && a.m_AF.w == b.m_AF.w && a.m_BC.w == b.m_BC.w && a.m_DE.w == b.m_DE.w &&
+                   a.m_HL.w == b.m_HL.w && a.m_WZ.w == b.m_WZ.w && a.m_PC.w == b.m_PC.w && a.m_SP.w == b.m_SP.w &&
+                   a.m_R == b.m_R && a.m_Q == b.m_Q && a.m_halted == b.m_halted && a.m_ticks == b.m_ticks &&
+                   fast.get_data_bus() == plain.get_data_bus() && fast.get_address_bus() == plain.get_address_bus();
+        }
+        same = same && fast.get_bus()->peek(0x8000) == plain.get_bus()->peek(0x8000);
+        check(same, std::string("Idle loop fast-forward matches: ") + c.name);
+        // Every frame interrupt is taken, also while halted inside a long run()
+        check(plain.get_D() + plain.is_IRQ_requested() == plain.get_events()->frames,
+              std::string("Idle loop takes every interrupt: ") + c.name);
+    }
+}
+
+void test_lazy_flags() {
+    // Random mix of flag producers and consumers; the lazy CPU must match the eager one after every step
+    const uint8_t pool[][2] = {
+        {0x80, 0}, {0x88, 0}, {0x90, 0}, {0x98, 0}, {0xA0, 0}, {0xA8, 0}, {0xB0, 0}, {0xB8, 0}, // ALU A,B
+        {0xC6, 1}, {0xCE, 1}, {0xD6, 1}, {0xDE, 1}, {0xFE, 1},                               // ALU A,n
+        {0x04, 0}, {0x0D, 0}, {0x3C, 0}, {0x27, 0}, {0x2F, 0}, {0x37, 0}, {0x3F, 0},         // INC/DEC/DAA/CPL/SCF/CCF
+        {0x17, 0}, {0x1F, 0}, {0x09, 0}, {0xF5, 0}, {0xC1, 0}, {0xC5, 0}, {0xF1, 0},         // RLA/RRA/ADD HL/stack
+        {0x3E, 1}, {0x06, 1}, {0x0E, 1}, {0x78, 0}, {0x41, 0},                               // loads
+    };
+    const uint8_t jumps[] = {0x20, 0x28, 0x30, 0x38, 0xE2, 0xEA, 0xF2, 0xFA}; // JR cc / JP cc
+    Z80::CPU<TestBus, Z80::StandardEvents, Z80::StandardDebugger, true> eager;
+    Z80::CPU<TestBus, Z80::StandardEvents, Z80::StandardDebugger, true, Z80::LazyFlagsConfig> lazy;
+    uint32_t seed = 0x1234567;
+    auto next = [&seed]() { seed = seed * 1103515245u + 12345u; return (uint8_t)(seed >> 16); };
+    uint16_t address = 0x0100;
+    auto emit = [&](uint8_t byte) {
+        eager.get_bus()->write(address, byte);
+        lazy.get_bus()->write(address, byte);
+        ++address;
+    };
+    while (address < 0x7000) {
+        uint8_t pick = next();
+        if (pick < 32) {
+            uint8_t op = jumps[pick & 7];
+            emit(op);
+            if (op < 0x40)
+                emit(0x00);
+            else {
+                emit((uint8_t)(address + 2));
+                emit((uint8_t)((address + 1) >> 8));
+            }
+        } else {
+            const uint8_t* entry = pool[pick % (sizeof(pool) / sizeof(pool[0]))];
+            emit(entry[0]);
+            if (entry[1])
+                emit(next());
+        }
+    }
+    emit(0x76);
+    eager.set_PC(0x0100);
+    lazy.set_PC(0x0100);
+    eager.set_SP(0xF000);
+    lazy.set_SP(0xF000);
+    bool same = true;
+    for (int i = 0; i < 20000 && same && !eager.is_halted(); ++i) {
+        eager.step();
+        lazy.step();
+        auto a = eager.save_state();
+        auto b = lazy.save_state();
+        same = a.m_AF.w == b.m_AF.w && a.m_BC.w == b.m_BC.w && a.m_HL.w == b.m_HL.w && a.m_PC.w == b.m_PC.w &&
+               a.m_SP.w == b.m_SP.w && a.m_Q == b.m_Q && a.m_ticks == b.m_ticks;
+    }
+    check(same, "Lazy flags match eager flags");
+    // Flags written through the accessors replace any pending record
+    lazy.set_A(0x7F);
+    lazy.get_bus()->write(lazy.get_PC(), 0x3C); // INC A
+    lazy.set_halted(false);
+    lazy.step();
+    lazy.set_F(0x01);
+    check(lazy.get_AF() == 0x8001, "Lazy flags set_F overrides pending flags");
+}
+
+void test_functional_profile() {
+    // FunctionalConfig skips WZ, Q, R, X/Y and the bus mirrors; documented results must not change
+    Z80::CPU<TestBus, Z80::StandardEvents, Z80::StandardDebugger, false> standard;
+    Z80::CPU<TestBus, Z80::StandardEvents, Z80::StandardDebugger, false, Z80::FunctionalConfig> functional;
+    const uint8_t program[] = {0x21, 0x00, 0x80, // LD HL,0x8000
+                               0x3E, 0x7F,       // LD A,0x7F
+                               0xC6, 0x29,       // ADD A,0x29
+                               0x77,             // LD (HL),A
+                               0xCB, 0x46,       // BIT 0,(HL)
+                               0x37, 0x3F,       // SCF / CCF
+                               0x06, 0x03,       // LD B,3
+                               0x86,             // loop: ADD A,(HL)
+                               0x10, 0xFD,       // DJNZ loop
+                               0xF5, 0xC1,       // PUSH AF / POP BC
+                               0x76};            // HALT
+    for (size_t i = 0; i < sizeof(program); ++i) {
+        standard.get_bus()->write(0x0100 + i, program[i]);
+        functional.get_bus()->write(0x0100 + i, program[i]);
+    }
+    standard.set_PC(0x0100);
+    functional.set_PC(0x0100);
+    standard.set_SP(0xF000);
+    functional.set_SP(0xF000);
+    functional.set_WZ(0x1234);
+    functional.set_R(0x40);
+    bool same = true;
+    while (same && !standard.is_halted()) {
+        standard.step();
+        functional.step();
+        // X/Y (0x28) are unspecified in the functional profile; POP BC copies them into C
+        same = (standard.get_AF() & 0xFFD7) == (functional.get_AF() & 0xFFD7) &&
+               (standard.get_BC() & 0xFFD7) == (functional.get_BC() & 0xFFD7) && standard.get_HL() == functional.get_HL() &&
+               standard.get_PC() == functional.get_PC() && standard.get_SP() == functional.get_SP() &&
+               standard.get_ticks() == functional.get_ticks();
+    }
+    check(same, "Functional profile matches documented results");
+    check(functional.get_WZ() == 0x1234, "Functional profile leaves WZ untouched");
+    check(functional.get_R() == 0x40, "Functional profile leaves R untouched");
+}
+
+// Periodic events that also raise an IRQ every few periods, so interrupts arrive in the middle of run()
+class InterruptingEvents : public PeriodicEvents {
+public:
+    template <typename TCPU> void connect(const TCPU* cpu) {
+        PeriodicEvents::connect(cpu);
+        TCPU* target = const_cast<TCPU*>(cpu);
+        m_request_interrupt = [target]() { target->request_interrupt(0xFF); };
+    }
+    void handle_event(long long tick) {
+        PeriodicEvents::handle_event(tick);
+        if (fired.size() % 5 == 0)
+            m_request_interrupt();
+    }
+
+private:
+    std::function<void()> m_request_interrupt;
+};
+
+void test_opcode_fusion() {
+    // Loop made of fusion pairs, with frequent events and interrupts; run() (which fuses when built with
+    // Z80_OPCODE_FUSION) must match step() (which never does) at every slice boundary
+    const uint8_t program[] = {
+        0xED, 0x56, 0xFB,                         // IM 1 / EI
+        0x21, 0x00, 0x80, 0x11, 0x00, 0x90, 0x06, 0x40, // LD HL,0x8000 / LD DE,0x9000 / LD B,0x40
+        0x7E, 0x23, 0xB7, 0x28, 0x04,             // loop: LD A,(HL) / INC HL / OR A / JR Z,skip
+        0xC5, 0xD5, 0xD1, 0xC1,                   // PUSH BC / PUSH DE / POP DE / POP BC
+        0xEB, 0x77, 0x23, 0xEB,                   // skip: EX DE,HL / LD (HL),A / INC HL / EX DE,HL
+        0xFE, 0x80, 0x38, 0x00,                   // CP 0x80 / JR C,+0
+        0x05, 0x20, 0xEC,                         // DEC B / JR NZ,loop
+        0x06, 0x40, 0x21, 0x00, 0x80, 0xC3, 0x0B, 0x01}; // LD B,0x40 / LD HL,0x8000 / JP loop
+    Z80::CPU<TestBus, InterruptingEvents> fused, stepped;
+    for (auto* cpu : {&fused, &stepped}) {
+        cpu->reset();
+        for (size_t i = 0; i < sizeof(program); ++i)
+            cpu->get_bus()->write(0x0100 + i, program[i]);
+        for (int i = 0; i < 0x40; ++i)
+            cpu->get_bus()->write(0x8000 + i, (uint8_t)(i % 3 ? i * 37 : 0));
+        cpu->get_bus()->write(0x0038, 0xFB); // EI
+        cpu->get_bus()->write(0x0039, 0xC9); // RET
+        cpu->set_PC(0x0100);
+        cpu->set_SP(0xF000);
+    }
+    uint32_t seed = 0x2468ACE;
+    bool same = true;
+    for (int slice = 0; slice < 3000 && same; ++slice) {
+        seed = seed * 1103515245u + 12345u;
+        long long limit = stepped.get_ticks() + 1 + (seed >> 16) % 60;
+        fused.run(limit);
+        while (stepped.get_ticks() < limit)
+            stepped.step();
+        auto a = fused.save_state();
+        auto b = stepped.save_state();
+        same = a.m_AF.w == b.m_AF.w && a.m_BC.w == b.m_BC.w && a.m_DE.w == b.m_DE.w && a.m_HL.w == b.m_HL.w &&
+               a.m_SP.w == b.m_SP.w && a.m_PC.w == b.m_PC.w && a.m_WZ.w == b.m_WZ.w && a.m_R == b.m_R &&
+               a.m_Q == b.m_Q && a.m_IFF1 == b.m_IFF1 && a.m_ticks == b.m_ticks &&
+               fused.get_events()->fired == stepped.get_events()->fired;
+    }
+    check(same, "Fused sequences match single steps (state, R, WZ, Q, ticks, events)");
+    bool memory = true;
+    for (uint32_t address = 0x9000; address < 0x9040; ++address)
+        memory = memory && fused.get_bus()->peek(address) == stepped.get_bus()->peek(address);
+    check(memory, "Fused sequences write the same memory");
+}
+
+void test_decode_cache() {
+    // Loop that rewrites its own opcodes: INC A becomes INC C, and the DD prefix of INC IX becomes FD.
+    // A StandardBus CPU (prefixed opcodes cached with Z80_DECODE_CACHE) must match a TestBus one (never cached).
+    // LD B,3 / loop: INC A / INC IX / LD HL,0x0102 / LD (HL),0x0C / INC HL / LD (HL),0xFD / DJNZ loop / HALT
+    const uint8_t program[] = {0x06, 0x03, 0x3C, 0xDD, 0x23, 0x21, 0x02, 0x01, 0x36,
+                               0x0C, 0x23, 0x36, 0xFD, 0x10, 0xF3, 0x76};
+    Z80::CPU<> cached;
+    Z80::CPU<TestBus> uncached;
+    for (size_t i = 0; i < sizeof(program); ++i) {
+        cached.get_bus()->write(0x0100 + i, program[i]);
+        uncached.get_bus()->write(0x0100 + i, program[i]);
+    }
+    cached.set_PC(0x0100);
+    uncached.set_PC(0x0100);
+    cached.run(1000);
+    uncached.run(1000);
+    check(cached.get_A() == 1 && cached.get_C() == 2 && cached.get_IX() == 1 && cached.get_IY() == 2,
+          "Decode cache: self-modifying code runs the rewritten opcodes");
+    check(cached.get_ticks() == uncached.get_ticks() && cached.get_R() == uncached.get_R() &&
+              cached.get_PC() == uncached.get_PC(),
+          "Decode cache: ticks and R match uncached fetches");
+
+    // Bank switch and host write under code already run from the same address
+    Z80::CPU<Z80::PagedBus> paged;
+    std::vector<uint8_t> bank0(Z80::PagedBus::PAGE_SIZE, 0x76), bank1(Z80::PagedBus::PAGE_SIZE, 0x76);
+    bank0[0] = 0xDD; // INC IX
+    bank0[1] = 0x23;
+    bank1[0] = 0xFD; // INC IY
+    bank1[1] = 0x23;
+    auto run_bank = [&](std::vector<uint8_t>& bank) {
+        paged.get_bus()->map(0x8000, Z80::PagedBus::PAGE_SIZE, bank.data());
+        paged.set_halted(false);
+        paged.set_PC(0x8000);
+        paged.run(paged.get_ticks() + 100);
+    };
+    run_bank(bank0);
+    run_bank(bank0);
+    check(paged.get_IX() == 2, "Decode cache: code reruns from its page");
+    run_bank(bank1);
+    check(paged.get_IX() == 2 && paged.get_IY() == 1, "Decode cache: bank switch runs the new bank");
+    bank1[1] = 0x2B; // DEC IY, written by the host behind the CPU
+    run_bank(bank1);
+    check(paged.get_IX() == 2 && paged.get_IY() == 0, "Decode cache: host writes are picked up");
+}
+
+void test_lockstep() {
+    // LDIR (fast-forwarded inside run() on a paged bus) and a DEC A / JR NZ idle loop, checked block by block
+    // against single steps
+    // LD HL,0x8000 / LD DE,0x9000 / LD BC,0x0100 / LDIR / loop: DEC A / JR NZ,loop / JP 0x0100
+    const uint8_t program[] = {0x21, 0x00, 0x80, 0x11, 0x00, 0x90, 0x01, 0x00, 0x01,
+                               0xED, 0xB0, 0x3D, 0x20, 0xFD, 0xC3, 0x00, 0x01};
+    Z80::CPU<Z80::PagedBus> candidate, reference;
+    for (auto* cpu : {&candidate, &reference}) {
+        for (size_t i = 0; i < sizeof(program); ++i)
+            cpu->get_bus()->write(0x0100 + i, program[i]);
+        cpu->set_PC(0x0100);
+    }
+    Z80::Lockstep lockstep(candidate, reference);
+    check(lockstep.run(100000, 97), "Lockstep: run() blocks match single steps");
+    // A block ends at the first instruction boundary at or past its 97 T-states (LDIR iterations are 21)
+    check(lockstep.get_blocks() > 100000 / (97 + 21) && lockstep.get_blocks() <= 100000 / 97 + 1,
+          "Lockstep: one comparison per block");
+    check(candidate.get_bus()->peek(0x90FF) == reference.get_bus()->peek(0x90FF), "Lockstep: same memory");
+
+    reference.set_A(candidate.get_A() + 1);
+    Z80::Lockstep diverging(candidate, reference);
+    check(!diverging.run(candidate.get_ticks() + 1000, 50), "Lockstep: divergence is reported");
+    check(diverging.get_blocks() == 1 && diverging.get_mismatch().field == "AF" &&
+              diverging.get_mismatch().reference == diverging.get_mismatch().candidate + 0x100,
+          "Lockstep: first differing field");
+}
+
+// Debugger that counts steps and, once `limit` is reached, asks its machine to drop back to the fast CPU
+class CountingDebugger : public Z80::StandardDebugger {
+public:
+    using Z80::StandardDebugger::after_step;
+    void before_step() {
+        if (++steps == limit && on_limit)
+            on_limit();
+    }
+    void after_step() {
+    }
+    int steps = 0;
+    int limit = -1;
+    std::function<void()> on_limit;
+};
+
+void test_hot_swap() {
+    // INC A / LD (0x8000),A / JR back, on a hot-swapped machine and on a plain CPU run to the same limits
+    const uint8_t program[] = {0x3C, 0x32, 0x00, 0x80, 0x18, 0xFA};
+    Z80::HotSwapCPU<Z80::StandardBus, Z80::StandardEvents, CountingDebugger> machine;
+    Z80::CPU<> reference;
+    for (size_t i = 0; i < sizeof(program); ++i) {
+        machine.get_bus()->write(0x0100 + i, program[i]);
+        reference.get_bus()->write(0x0100 + i, program[i]);
+    }
+    machine.get_active().set_PC(0x0100);
+    reference.set_PC(0x0100);
+    CountingDebugger& debugger = *machine.get_debugger();
+    machine.run(1000);
+    reference.run(1000);
+    check(!machine.is_instrumented() && debugger.steps == 0, "Hot swap: fast CPU runs without the debugger");
+    machine.set_instrumented(true);
+    check(machine.is_instrumented() && machine.get_active().get_A() == reference.get_A(),
+          "Hot swap: state handed to the instrumented CPU");
+    debugger.limit = 20;
+    debugger.on_limit = [&machine]() { machine.set_instrumented(false); };
+    machine.run(2000);
+    reference.run(2000);
+    int steps = debugger.steps;
+    check(steps > 20 && !machine.is_instrumented(), "Hot swap: switch requested inside run() applies when it returns");
+    machine.run(3000);
+    reference.run(3000);
+    check(debugger.steps == steps, "Hot swap: back on the fast CPU");
+    Z80::Lockstep states(machine.get_active(), reference);
+    check(states.compare(), "Hot swap: state matches an unswapped CPU (registers, R, ticks)");
+    check(machine.get_bus()->peek(0x8000) == reference.get_bus()->peek(0x8000) &&
+              machine.get_active().get_data_bus() == reference.get_data_bus(),
+          "Hot swap: shared bus and bus mirrors carried over");
+}
+
+void test_copy_on_write_bus() {
+    static_assert(Z80::is_paged_bus_v<Z80::CopyOnWriteBus>, "CopyOnWriteBus exposes page tables");
+    // LD HL,0x8000 / LD (HL),A / INC A / LD (0x80FF),A / LD (0x9000),A / HALT, shared by two CPUs
+    std::vector<uint8_t> image(0x10000, 0xAA);
+    const uint8_t program[] = {0x21, 0x00, 0x80, 0x77, 0x3C, 0x32, 0xFF, 0x80, 0x32, 0x00, 0x90, 0x76};
+    std::copy(program, program + sizeof(program), image.begin() + 0x0100);
+    Z80::CopyOnWriteBus shared(image.data());
+    Z80::CPU<Z80::CopyOnWriteBus> first(&shared), second;
+    second.get_bus()->set_image(image.data());
+    first.set_PC(0x0100);
+    first.set_A(0x11);
+    second.set_PC(0x0100);
+    second.set_A(0x22);
+    first.run(100);
+    second.run(100);
+    Z80::CopyOnWriteBus& bus = *first.get_bus();
+    check(bus.peek(0x8000) == 0x11 && bus.peek(0x80FF) == 0x12 && bus.peek(0x9000) == 0x12 &&
+              second.get_bus()->peek(0x8000) == 0x22 && second.get_bus()->peek(0x9000) == 0x23,
+          "CopyOnWriteBus: each instance sees its own writes");
+    check(image[0x8000] == 0xAA && image[0x9000] == 0xAA && bus.peek(0x8001) == 0xAA,
+          "CopyOnWriteBus: shared image untouched, private page keeps the rest of the image");
+    check(bus.get_private_pages() == 2, "CopyOnWriteBus: one private page per written page");
+    Z80::CopyOnWriteBus copy(bus);
+    copy.write(0x8000, 0x55);
+    check(copy.peek(0x8000) == 0x55 && copy.peek(0x9000) == 0x12 && bus.peek(0x8000) == 0x11,
+          "CopyOnWriteBus: copies own their private pages");
+    first.reset();
+    check(bus.get_private_pages() == 0 && bus.peek(0x8000) == 0xAA && bus.peek(0x0100) == 0x21,
+          "CopyOnWriteBus: reset returns to the image");
+    first.set_PC(0x0100);
+    first.set_A(0x33);
+    first.run(100);
+    check(bus.peek(0x8000) == 0x33 && bus.get_private_pages() == 2, "CopyOnWriteBus: runs again after reset");
+    check(first.get_events() == second.get_events() && first.get_debugger() == second.get_debugger(),
+          "Stateless StandardEvents/StandardDebugger are shared");
+}
+
+void test_batch_cpu() {
+    // A loop of register-only LD r,r' and ALU A,r opcodes mixed with immediate loads, (HL) writes (self-modifying
+    // on some lanes) and EX AF,AF', run by every lane from its own registers and compared with one scalar CPU
+    // per lane after each step
+    std::vector<uint8_t> image(0x10000, 0x00);
+    uint32_t seed = 12345;
+    auto next_random = [&seed]() {
+        seed = seed * 1103515245 + 12345;
+        return (uint8_t)(seed >> 16);
+    };
+    size_t length = 0;
+    while (length < 400) {
+        uint8_t kind = next_random() % 16, opcode = 0x40 + next_random() % 0x80;
+        if (kind < 12 && opcode != 0x76) {
+            image[0x0100 + length++] = opcode;
+        } else if (kind < 14) {
+            image[0x0100 + length++] = 0x06 + (next_random() % 8) * 8; // LD r,n / LD (HL),n
+            image[0x0100 + length++] = next_random();
+        } else {
+            image[0x0100 + length++] = 0x08;
+        }
+    }
+    image[0x0100 + length] = 0xC3; // JP 0x0100
+    image[0x0101 + length] = 0x00;
+    image[0x0102 + length] = 0x01;
+    const size_t lanes = 64;
+    Z80::BatchCPU<> batch(lanes);
+    std::vector<Z80::CPU<Z80::CopyOnWriteBus>> reference(lanes);
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        auto& cpu = reference[lane];
+        cpu.get_bus()->set_image(image.data());
+        batch.get_bus(lane).set_image(image.data());
+        cpu.set_PC(0x0100);
+        cpu.set_AF(next_random() << 8 | next_random());
+        cpu.set_BC(next_random() << 8 | next_random());
+        cpu.set_DE(next_random() << 8 | next_random());
+        cpu.set_HL((lane % 4 == 0 ? 0x01 : 0x80 + next_random() % 0x70) << 8 | next_random());
+        if (lane == 5) { // Interrupt accepted on the first step
+            cpu.set_IFF1(true);
+            cpu.set_IRQ_mode(1);
+            cpu.get_bus()->write(0x0038, 0xC9); // RET
+            batch.get_bus(lane).write(0x0038, 0xC9);
+            cpu.set_SP(0xF000);
+            cpu.request_interrupt(0xFF);
+        }
+        batch.set_state(lane, cpu.save_state());
+    }
+    Z80::CPU<Z80::CopyOnWriteBus> lane_cpu;
+    bool same = true;
+    for (int step = 0; step < 3000 && same; ++step) {
+        batch.step();
+        for (size_t lane = 0; lane < lanes && same; ++lane) {
+            reference[lane].step();
+            lane_cpu.restore_state(batch.get_state(lane));
+            same = Z80::Lockstep(lane_cpu, reference[lane]).compare() &&
+                   batch.get_address_bus(lane) == reference[lane].get_address_bus() &&
+                   batch.get_data_bus(lane) == reference[lane].get_data_bus();
+        }
+    }
+    check(same, "BatchCPU: every lane matches the scalar CPU after every step");
+    check(batch.get_vector_steps() > 3000 * (long long)lanes / 2 && batch.get_scalar_steps() > 0,
+          "BatchCPU: shared opcodes run in the lane loops, the rest on the scalar CPU");
+    bool same_memory = true;
+    for (size_t lane = 0; lane < lanes; ++lane)
+        for (uint32_t address = 0; address < 0x10000; ++address)
+            same_memory &= batch.get_bus(lane).peek(address) == reference[lane].get_bus()->peek(address);
+    check(same_memory, "BatchCPU: lane memory matches");
+    long long limit = batch.get_ticks(0) + 1000;
+    batch.run(limit);
+    bool reached = true;
+    for (size_t lane = 0; lane < lanes; ++lane)
+        reached &= batch.get_ticks(lane) >= limit && batch.get_ticks(lane) < limit + 23;
+    check(reached, "BatchCPU: run() takes every lane to the limit");
+}
+
+// StandardBus whose 0x8000-0x80FF window is a mailbox shared with other buses
+class MailboxBus : public Z80::StandardBus {
+public:
+    uint8_t read(uint16_t address) {
+        return (address & 0xFF00) == 0x8000 ? mailbox[address & 0xFF] : Z80::StandardBus::read(address);
+    }
+    void write(uint16_t address, uint8_t value) {
+        if ((address & 0xFF00) == 0x8000) {
+            mailbox[address & 0xFF] = value;
+            ++mailbox_writes;
+        } else
+            Z80::StandardBus::write(address, value);
+    }
+    uint8_t* mailbox = nullptr;
+    long long mailbox_writes = 0;
+};
+
+void test_multi_cpu() {
+    // The main CPU posts C to 0x8000 and counts polls in HL until the sound CPU (twice the clock) echoes it at
+    // 0x8001: loop: INC C / LD A,C / LD (0x8000),A / wait: INC HL / LD A,(0x8001) / CP C / JR NZ,wait / JR loop
+    const uint8_t main_program[] = {0x21, 0x00, 0x00, 0x0C, 0x79, 0x32, 0x00, 0x80, 0x23,
+                                    0x3A, 0x01, 0x80, 0xB9, 0x20, 0xF9, 0x18, 0xF2};
+    // wait: LD A,(0x8000) / CP E / JR Z,wait / LD E,A / LD (0x8001),A / JR wait
+    const uint8_t sound_program[] = {0x3A, 0x00, 0x80, 0xBB, 0x28, 0xFA, 0x5F, 0x32, 0x01, 0x80, 0x18, 0xF4};
+    using MultiBusCPU = Z80::CPU<Z80::SharedAccessBus<MailboxBus>>;
+    auto run_pair = [&](long long quantum, long long fine_quantum, long long hold, long long& rounds, long long& polls,
+                        bool& on_time, long long& fine_slices) {
+        uint8_t mailbox[0x100] = {};
+        MultiBusCPU main_cpu, sound_cpu;
+        Z80::MultiCPU multi(3500000);
+        for (MultiBusCPU* cpu : {&main_cpu, &sound_cpu}) {
+            cpu->get_bus()->mailbox = mailbox;
+            cpu->get_bus()->set_multi(&multi);
+            cpu->set_PC(0x0100);
+        }
+        for (size_t i = 0; i < sizeof(main_program); ++i)
+            main_cpu.get_bus()->write(0x0100 + i, main_program[i]);
+        for (size_t i = 0; i < sizeof(sound_program); ++i)
+            sound_cpu.get_bus()->write(0x0100 + i, sound_program[i]);
+        sound_cpu.set_ticks(1000); // Any starting count: ticks are kept relative to it
+        multi.add(main_cpu, 3500000);
+        multi.add(sound_cpu, 7000000);
+        multi.add_shared_memory(0x8000, 0x80FF);
+        multi.set_quantum(quantum);
+        multi.set_fine_quantum(fine_quantum, hold);
+        on_time = true;
+        for (long long time = 10000; time <= 200000; time += 10000) {
+            multi.run(time);
+            on_time &= main_cpu.get_ticks() >= time && main_cpu.get_ticks() < time + 20 &&
+                       sound_cpu.get_ticks() >= 1000 + 2 * time && sound_cpu.get_ticks() < 1000 + 2 * time + 20;
+        }
+        rounds = main_cpu.get_bus()->mailbox_writes;
+        polls = main_cpu.get_HL();
+        fine_slices = multi.get_fine_slices();
+    };
+    long long coarse_rounds, coarse_polls, fine_rounds, fine_polls, coarse_fine_slices, fine_slices;
+    bool coarse_on_time, fine_on_time;
+    run_pair(5000, 5000, 0, coarse_rounds, coarse_polls, coarse_on_time, coarse_fine_slices);
+    run_pair(5000, 20, 2000, fine_rounds, fine_polls, fine_on_time, fine_slices);
+    check(coarse_on_time && fine_on_time, "MultiCPU: CPU ticks follow the global time at their clock ratio");
+    check(coarse_rounds > 0 && fine_rounds > 10 * coarse_rounds && fine_slices > 0 && coarse_fine_slices == 0,
+          "MultiCPU: shared accesses switch to the fine quantum");
+    check(fine_polls / (fine_rounds ? fine_rounds : 1) < 10,
+          "MultiCPU: fine quantum bounds the mailbox handshake latency");
+}
+
+void test_farm() {
+    // Countdowns of different lengths ending in HALT: LD BC,n / loop: DEC BC / LD A,B / OR C / JR NZ,loop / HALT;
+    // the last job spins in JR $ and is stopped by its tick limit
+    const size_t jobs = 24;
+    auto load = [&](Z80::CPU<>& cpu, size_t job) {
+        uint16_t count = (uint16_t)(50 + job * 37);
+        const uint8_t countdown[] = {0x01, (uint8_t)count, (uint8_t)(count >> 8), 0x0B, 0x78, 0xB1, 0x20, 0xFB, 0x76};
+        const uint8_t spin[] = {0x18, 0xFE};
+        if (job + 1 < jobs)
+            for (size_t i = 0; i < sizeof(countdown); ++i)
+                cpu.get_bus()->write(0x0100 + i, countdown[i]);
+        else
+            for (size_t i = 0; i < sizeof(spin); ++i)
+                cpu.get_bus()->write(0x0100 + i, spin[i]);
+        cpu.set_PC(0x0100);
+    };
+    auto run_farm = [&](unsigned threads, std::vector<Z80::CPU<>>& cpus, std::vector<Z80::Farm::Result>& results) {
+        Z80::Farm farm(threads);
+        farm.set_slice(1000);
+        for (size_t job = 0; job < jobs; ++job) {
+            load(cpus[job], job);
+            Z80::CPU<>* cpu = &cpus[job];
+            farm.add(cpus[job], [cpu] { return cpu->is_halted(); }, job + 1 < jobs ? LLONG_MAX : 5000);
+        }
+        farm.run();
+        for (size_t job = 0; job < jobs; ++job)
+            results.push_back(farm.get_result(job));
+    };
+    std::vector<Z80::CPU<>> single(jobs), pool(jobs);
+    std::vector<Z80::Farm::Result> single_results, pool_results;
+    run_farm(1, single, single_results);
+    run_farm(4, pool, pool_results);
+    bool same = true, done = true;
+    for (size_t job = 0; job < jobs; ++job) {
+        Z80::CPU<> reference;
+        load(reference, job);
+        long long slices = 0;
+        long long max_ticks = job + 1 < jobs ? LLONG_MAX : 5000;
+        while (!reference.is_halted() && reference.get_ticks() < max_ticks)
+            reference.run(++slices * 1000);
+        same &= Z80::Lockstep(pool[job], single[job]).compare() && Z80::Lockstep(pool[job], reference).compare() &&
+                pool_results[job].ticks == reference.get_ticks() && pool_results[job].slices == slices &&
+                single_results[job].ticks == pool_results[job].ticks;
+        done &= pool_results[job].finished == (job + 1 < jobs);
+    }
+    check(same, "Farm: every job ends in the same state on 1 and 4 threads and when sliced by hand");
+    check(done && pool_results[jobs - 1].ticks >= 5000, "Farm: predicates finish jobs, tick limits stop the rest");
+}
+
+class AckBus : public Z80::StandardBus {
+public:
+    void out(uint16_t port, uint8_t value) {
+        acks.fetch_add(1, std::memory_order_release);
+        Z80::StandardBus::out(port, value);
+    }
+    std::atomic<int> acks{0};
+};
+
+void test_thread_mailbox() {
+    // IM 1 / EI / loop: LD (0x9000),A / JR loop; 0x38: OUT (0),A / EI / RETI. The loop writes memory, so it is
+    // not skipped as an idle loop and run(LLONG_MAX) keeps executing until stopped.
+    using MailboxCPU = Z80::CPU<AckBus, Z80::StandardEvents, Z80::StandardDebugger, false, Z80::MailboxConfig>;
+    const uint8_t program[] = {0xED, 0x56, 0xFB, 0x32, 0x00, 0x90, 0x18, 0xFB};
+    const uint8_t handler[] = {0xD3, 0x00, 0xFB, 0xED, 0x4D};
+    auto load = [&](MailboxCPU& cpu) {
+        for (size_t i = 0; i < sizeof(program); ++i)
+            cpu.get_bus()->write(0x0100 + i, program[i]);
+        for (size_t i = 0; i < sizeof(handler); ++i)
+            cpu.get_bus()->write(0x0038 + i, handler[i]);
+        cpu.set_PC(0x0100);
+        cpu.set_SP(0xF000);
+    };
+    MailboxCPU cpu;
+    load(cpu);
+    cpu.run(100);
+    cpu.request_stop();
+    cpu.step();
+    check(cpu.run(1000) == 0, "Mailbox: a stop posted before run() survives step() and ends the next run() at once");
+    // step() takes the interrupt and runs the first instruction of its handler
+    cpu.post_interrupt(0xFF);
+    cpu.step();
+    check(cpu.get_PC() == 0x003A && cpu.get_bus()->acks.load() == 1 && !cpu.is_IRQ_requested(),
+          "Mailbox: a posted IRQ is taken at the next boundary");
+    cpu.run(cpu.get_ticks() + 100);
+    cpu.post_NMI();
+    cpu.step();
+    check(cpu.get_PC() == 0x0067, "Mailbox: a posted NMI is taken at the next boundary");
+
+    // A device thread posts IRQs, each after the previous one was acknowledged, then stops the emulation thread
+    MailboxCPU threaded;
+    load(threaded);
+    const int interrupts = 10;
+    std::thread device([&] {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        for (int i = 0; i < interrupts; ++i) {
+            threaded.post_interrupt(0xFF);
+            while (threaded.get_bus()->acks.load(std::memory_order_acquire) <= i &&
+                   std::chrono::steady_clock::now() < deadline)
+                std::this_thread::yield();
+        }
+        threaded.request_stop();
+    });
+    threaded.run(LLONG_MAX);
+    device.join();
+    check(threaded.get_bus()->acks.load() == interrupts && threaded.get_ticks() < LLONG_MAX,
+          "Mailbox: IRQs and a stop from another thread reach run() in progress");
+}
+
+void test_io_recorder() {
+    // LD A,0x12 / OUT (0xFE),A / LD (0x4000),A / LD (0x8000),A / HALT; only 0x4000-0x5AFF is recorded
+    Z80::RingBuffer<Z80::IORecord> ring(3);
+    Z80::CPU<Z80::RecordingBus<Z80::StandardBus>> cpu;
+    cpu.get_bus()->set_recorder(&ring);
+    cpu.get_bus()->add_recorded_memory(0x4000, 0x5AFF);
+    const uint8_t program[] = {0x3E, 0x12, 0xD3, 0xFE, 0x32, 0x00, 0x40, 0x32, 0x00, 0x80, 0x76};
+    for (size_t i = 0; i < sizeof(program); ++i)
+        cpu.get_bus()->write(i, program[i]);
+    cpu.run(100);
+    Z80::IORecord records[4];
+    size_t count = ring.pop(records, 4);
+    check(ring.get_capacity() == 4 && count == 2 && ring.get_dropped() == 0, "Recorder: OUT and recorded writes only");
+    check(records[0].kind == Z80::IORecord::Out && records[0].address == 0x12FE && records[0].value == 0x12 &&
+              records[0].tick == 7 + 7 && records[1].kind == Z80::IORecord::Write && records[1].address == 0x4000 &&
+              records[1].tick > 18 && records[1].tick < 18 + 13,
+          "Recorder: records carry the address, value and tick of the access");
+    for (int i = 0; i < 6; ++i)
+        cpu.get_bus()->out(0x00FE, (uint8_t)i);
+    check(ring.get_size() == 4 && ring.get_dropped() == 2, "Recorder: a full ring drops new records and counts them");
+
+    // OTIR through out_block() records the same ticks as one out() per iteration
+    Z80::RingBuffer<Z80::IORecord> block_ring(1024), plain_ring(1024);
+    Z80::CPU<Z80::RecordingBus<BlockPortLogBus>> block;
+    Z80::CPU<Z80::RecordingBus<PortLogBus>> plain;
+    block.get_bus()->set_recorder(&block_ring);
+    plain.get_bus()->set_recorder(&plain_ring);
+    const uint8_t otir[] = {0xED, 0xB3, 0x76};
+    for (auto* bus : {static_cast<PortLogBus*>(block.get_bus()), static_cast<PortLogBus*>(plain.get_bus())}) {
+        for (uint32_t address = 0x8000; address < 0x8100; ++address)
+            bus->write(address, (uint8_t)(address ^ 0x5A));
+        for (size_t i = 0; i < sizeof(otir); ++i)
+            bus->write(0x0100 + i, otir[i]);
+    }
+    for (auto* other : {static_cast<Z80::ICPU*>(&block), static_cast<Z80::ICPU*>(&plain)}) {
+        other->set_PC(0x0100);
+        other->set_HL(0x8000);
+        other->set_BC(0xF0FE);
+    }
+    block.run(100000);
+    plain.run(100000);
+    std::vector<Z80::IORecord> x(1024), y(1024);
+    x.resize(block_ring.pop(x.data(), x.size()));
+    y.resize(plain_ring.pop(y.data(), y.size()));
+    bool same = x.size() == 0xF0 && x.size() == y.size() && block.get_bus()->block_calls > 0;
+    for (size_t i = 0; same && i < x.size(); ++i)
+        same = x[i].tick == y[i].tick && x[i].address == y[i].address && x[i].value == y[i].value;
+    check(same, "Recorder: OTIR runs through out_block() keep the tick of every transfer");
+
+    // A consumer thread drains the ring while the CPU runs: 16 x 256 OUTs of B
+    // LD E,16 / outer: LD B,0 / inner: LD A,B / OUT (0xFE),A / DJNZ inner / DEC E / JR NZ,outer / HALT
+    Z80::RingBuffer<Z80::IORecord> stream(4096);
+    Z80::CPU<Z80::RecordingBus<Z80::StandardBus>> producer;
+    producer.get_bus()->set_recorder(&stream);
+    const uint8_t loop[] = {0x1E, 0x10, 0x06, 0x00, 0x78, 0xD3, 0xFE, 0x10, 0xFB, 0x1D, 0x20, 0xF6, 0x76};
+    for (size_t i = 0; i < sizeof(loop); ++i)
+        producer.get_bus()->write(i, loop[i]);
+    std::atomic<bool> done{false};
+    size_t received = 0;
+    bool ordered = true;
+    std::thread consumer([&] {
+        long long last_tick = -1;
+        auto take = [&](const Z80::IORecord& record) {
+            ordered &= record.tick > last_tick && record.value == (uint8_t)(0x100 - received % 0x100);
+            last_tick = record.tick;
+            ++received;
+        };
+        while (!done.load(std::memory_order_acquire))
+            stream.consume(take, 64);
+        stream.consume(take);
+    });
+    while (!producer.is_halted())
+        producer.run(producer.get_ticks() + 1000);
+    done.store(true, std::memory_order_release);
+    consumer.join();
+    check(received == 4096 && ordered && stream.get_dropped() == 0,
+          "Recorder: a consumer thread sees every record in order");
+}
+
+void test_index_prefixes() {
+    TestCPU cpu;
+    // DD DD FD LD IY,0x1234: only the last prefix counts
+    const uint8_t program[] = {0xDD, 0xDD, 0xFD, 0x21, 0x34, 0x12,
+                               // DD INC B: prefix without effect
+                               0xDD, 0x04,
+                               // DD ED SBC HL,BC: ED drops the prefix
+                               0xDD, 0xED, 0x42,
+                               // LD HL,0x8000 / LD (HL),0x5A / LD IX,0x7FFF / LD A,(IX+1) / ADD A,IXH
+                               0x21, 0x00, 0x80, 0x36, 0x5A, 0xDD, 0x21, 0xFF, 0x7F, 0xDD, 0x7E, 0x01, 0xDD, 0x84};
+    for (size_t i = 0; i < sizeof(program); ++i)
+        cpu.get_bus()->write(0x0100 + i, program[i]);
+    cpu.set_PC(0x0100);
+    cpu.set_HL(0x0010);
+    cpu.set_BC(0x0001);
+    cpu.step();
+    check(cpu.get_IY() == 0x1234 && cpu.get_HL() == 0x0010 && cpu.get_IX() != 0x1234, "Repeated prefixes: last one wins");
+    check(cpu.get_ticks() == 22, "Repeated prefixes: 4 T-states each");
+    cpu.step();
+    check(cpu.get_B() == 0x01 && cpu.get_ticks() == 30, "DD before an opcode without HL");
+    cpu.set_F(0);
+    cpu.step();
+    check(cpu.get_HL() == 0xFF0F && cpu.get_ticks() == 49, "DD before ED is ignored");
+    for (int i = 0; i < 5; ++i)
+        cpu.step();
+    check(cpu.get_A() == 0x5A + 0x7F && cpu.get_HL() == 0x8000, "IX-indexed handlers use IX");
+}
+
+void test_refresh_register() {
+    TestCPU cpu;
+    // LD A,0xFE / LD R,A / NOP x3 / LD A,R / DD LD B,A / LDIR of 4 bytes / HALT
+    const uint8_t program[] = {0x3E, 0xFE, 0xED, 0x4F, 0x00, 0x00, 0x00, 0xED, 0x5F, 0xDD, 0x47,
+                               0x21, 0x00, 0x80, 0x11, 0x00, 0x90, 0x01, 0x04, 0x00, 0xED, 0xB0, 0x76};
+    for (size_t i = 0; i < sizeof(program); ++i)
+        cpu.get_bus()->write(0x0100 + i, program[i]);
+    cpu.set_PC(0x0100);
+    cpu.run(7 + 9 + 4 + 4 + 4 + 9);
+    // R wraps within its low 7 bits and keeps bit 7: 0xFE + 3 NOPs + 2 (ED 5F) = 0x83
+    check(cpu.get_A() == 0x83, "LD A,R sees lazily counted fetches");
+    check(cpu.get_R() == 0x83, "get_R after LD A,R");
+    auto state = cpu.save_state();
+    check(state.m_R == 0x83, "save_state materializes R");
+    while (!cpu.is_halted())
+        cpu.step();
+    // DD LD B,A (2) + 3 loads (3) + LDIR 4 iterations (8) + HALT (1)
+    check(cpu.get_R() == 0x91, "R counts prefixes, block repeats and HALT fetch");
+    cpu.restore_state(state);
+    check(cpu.get_R() == 0x83, "restore_state replaces counted fetches");
+    cpu.set_R(0x7F);
+    cpu.set_halted(false);
+    cpu.set_PC(0x0104);
+    cpu.step();
+    check(cpu.get_R() == 0x00, "set_R restarts the count, bit 7 clear");
+}
+
 void test_state_save_restore() {
     TestCPU cpu;
     cpu.reset();
@@ -1453,6 +2548,25 @@ void test_state_save_restore() {
     check(cpu2.get_AF() == 0x1234, "Restore AF");
     check(cpu2.get_BC() == 0x5678, "Restore BC");
     check(cpu2.get_PC() == 0x9ABC, "Restore PC");
+
+    // A restored IRQ request with interrupts enabled is taken at the next instruction boundary
+    state.m_IFF1 = state.m_IFF2 = true;
+    state.m_IRQ_request = true;
+    state.m_IRQ_mode = 1;
+    state.m_SP.w = 0xF000;
+    cpu2.restore_state(state);
+    cpu2.step();
+    check(cpu2.get_SP() == 0xEFFE && cpu2.get_PC() == 0x0039 && !cpu2.get_IFF1(), "Restored IRQ request is taken");
+    // Lazy flags snapshot the materialized F and Q
+    Z80::CPU<TestBus, Z80::StandardEvents, Z80::StandardDebugger, true, Z80::LazyFlagsConfig> lazy;
+    lazy.get_bus()->write(0x0000, 0x3C); // INC A
+    lazy.set_A(0x7F);
+    lazy.step();
+    auto lazy_state = lazy.save_state();
+    check(lazy_state.m_AF.w == 0x8094 && lazy_state.m_Q == 0x94, "Lazy flags save_state");
+    lazy_state.m_AF.w = 0x1201;
+    lazy.restore_state(lazy_state);
+    check(lazy.get_AF() == 0x1201 && lazy.get_Q() == 0x94, "Lazy flags restore_state");
 }
 
 void test_accessors_and_copy() {
@@ -1535,6 +2649,26 @@ int main() {
     test_z80n_mul_flags();
     test_z80n_disabled();
     test_interrupts();
+    test_event_timing();
+    test_scheduler();
+    test_paged_bus();
+    test_block_fast_forward();
+    test_block_io();
+    test_idle_loops();
+    test_lazy_flags();
+    test_functional_profile();
+    test_opcode_fusion();
+    test_decode_cache();
+    test_lockstep();
+    test_hot_swap();
+    test_copy_on_write_bus();
+    test_batch_cpu();
+    test_multi_cpu();
+    test_farm();
+    test_thread_mailbox();
+    test_io_recorder();
+    test_index_prefixes();
+    test_refresh_register();
     test_state_save_restore();
     test_accessors_and_copy();
     test_auxiliary_classes();
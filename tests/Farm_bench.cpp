@@ -0,0 +1,66 @@
+// Aggregate emulated MHz of a batch of independent machines run by Z80::Farm on 1..N threads, against a plain
+// loop over the machines. Each machine (CPU<CopyOnWriteBus> over one shared image) counts down from its own
+// start value and halts.
+// Usage: Farm_bench [machines] [max threads]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <Z80/CPU.h>
+#include <Z80/Farm.h>
+
+using Machine = Z80::CPU<Z80::CopyOnWriteBus>;
+
+std::vector<std::unique_ptr<Machine>> make_machines(size_t count, const std::vector<uint8_t>& image) {
+    std::vector<std::unique_ptr<Machine>> machines;
+    for (size_t i = 0; i < count; ++i) {
+        machines.emplace_back(new Machine());
+        machines.back()->get_bus()->set_image(image.data());
+        machines.back()->set_PC(0x0100);
+        machines.back()->set_DE((uint16_t)(8 + i % 16)); // Outer loop count: 8-23 x 65536 inner iterations
+    }
+    return machines;
+}
+
+int main(int argc, char* argv[]) {
+    const size_t count = argc > 1 ? atoi(argv[1]) : 1000;
+    unsigned max_threads = argc > 2 ? atoi(argv[2]) : std::thread::hardware_concurrency();
+    if (max_threads == 0)
+        max_threads = 1;
+    // outer: LD BC,0 / inner: DEC BC / LD A,B / OR C / JR NZ,inner / DEC E / JR NZ,outer / HALT
+    std::vector<uint8_t> image(0x10000, 0);
+    const uint8_t program[] = {0x01, 0x00, 0x00, 0x0B, 0x78, 0xB1, 0x20, 0xFB, 0x1D, 0x20, 0xF5, 0x76};
+    for (size_t i = 0; i < sizeof(program); ++i)
+        image[0x0100 + i] = program[i];
+
+    auto machines = make_machines(count, image);
+    auto start = std::chrono::steady_clock::now();
+    long long ticks = 0;
+    for (auto& machine : machines) {
+        while (!machine->is_halted())
+            machine->run(machine->get_ticks() + 1000000);
+        ticks += machine->get_ticks();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%-10s %10s %14s\n", "Threads", "Seconds", "Aggregate MHz");
+    printf("%-10s %10.2f %14.1f\n", "loop", seconds, ticks / seconds / 1e6);
+    for (unsigned threads = 1; threads <= max_threads;
+         threads = threads < max_threads && threads * 2 > max_threads ? max_threads : threads * 2) {
+        machines = make_machines(count, image);
+        Z80::Farm farm(threads, true);
+        for (auto& machine : machines) {
+            Machine* cpu = machine.get();
+            farm.add(*cpu, [cpu] { return cpu->is_halted(); });
+        }
+        start = std::chrono::steady_clock::now();
+        farm.run();
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        ticks = 0;
+        for (size_t job = 0; job < farm.get_job_count(); ++job)
+            ticks += farm.get_result(job).ticks;
+        printf("%-10u %10.2f %14.1f\n", threads, seconds, ticks / seconds / 1e6);
+    }
+    return 0;
+}
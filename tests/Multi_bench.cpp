@@ -0,0 +1,37 @@
+// Host time per emulated second for two CPUs (3.5 MHz main, 4 MHz sound) interleaved by Z80::MultiCPU at
+// different quantum sizes, with the CPUs running independent loops (slicing overhead only).
+// Usage: Multi_bench [emulated seconds]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <Z80/CPU.h>
+#include <Z80/Multi.h>
+
+void load(Z80::CPU<>& cpu) {
+    // LD HL,0x8000 / loop: ADD A,(HL) / INC HL / DJNZ loop / JP loop
+    const uint8_t program[] = {0x21, 0x00, 0x80, 0x86, 0x23, 0x10, 0xFC, 0xC3, 0x03, 0x01};
+    for (size_t i = 0; i < sizeof(program); ++i)
+        cpu.get_bus()->write(0x0100 + i, program[i]);
+    cpu.set_PC(0x0100);
+}
+
+int main(int argc, char* argv[]) {
+    const double seconds = argc > 1 ? atof(argv[1]) : 5.0;
+    const long long main_hz = 3500000, sound_hz = 4000000;
+    printf("%-10s %14s %18s\n", "Quantum", "Slices/s", "Host ms/emu s");
+    for (long long quantum : {1LL, 4LL, 16LL, 64LL, 256LL, 1024LL, 4096LL, 69888LL}) {
+        Z80::CPU<> main_cpu, sound_cpu;
+        load(main_cpu);
+        load(sound_cpu);
+        Z80::MultiCPU multi(main_hz);
+        multi.add(main_cpu, main_hz);
+        multi.add(sound_cpu, sound_hz);
+        multi.set_quantum(quantum);
+        long long time = (long long)(seconds * main_hz);
+        auto start = std::chrono::steady_clock::now();
+        multi.run(time);
+        double host = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        printf("%-10lld %14.0f %18.1f\n", quantum, multi.get_slices() / seconds, host * 1000.0 / seconds);
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+// Throughput of each accuracy profile level on a real workload: a CP/M program (zexdoc.com by default)
+// runs for a fixed number of T-states per profile; BDOS output is discarded.
+// Usage: Profile_bench [program.com] [T-states per run] [rounds]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+#include <Z80/CPU.h>
+
+class ProfileBus : public Z80::StandardBus {
+public:
+    uint8_t read(uint16_t address) {
+        return address == 0x0005 ? 0xC9 : Z80::StandardBus::read(address); // BDOS: return at once
+    }
+};
+
+struct NoWZConfig : Z80::StandardConfig {
+    static constexpr bool TRACK_WZ = false;
+};
+struct NoQConfig : Z80::StandardConfig {
+    static constexpr bool TRACK_Q = false;
+};
+struct NoXYConfig : Z80::StandardConfig {
+    static constexpr bool TRACK_XY = false;
+};
+struct NoRConfig : Z80::StandardConfig {
+    static constexpr bool TRACK_R = false;
+};
+struct NoBusConfig : Z80::StandardConfig {
+    static constexpr bool TRACK_BUS = false;
+};
+
+template <typename TConfig> double measure(const std::vector<uint8_t>& program, long long ticks) {
+    Z80::CPU<ProfileBus, Z80::StandardEvents, Z80::StandardDebugger, false, TConfig> cpu;
+    for (size_t i = 0; i < program.size(); ++i)
+        cpu.get_bus()->write(0x0100 + i, program[i]);
+    cpu.set_PC(0x0100);
+    cpu.set_SP(0xF000);
+    cpu.run(ticks / 10); // Warm-up, not timed
+    auto start = std::chrono::steady_clock::now();
+    long long done = cpu.run(cpu.get_ticks() + ticks);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return done / seconds / 1e6;
+}
+
+int main(int argc, char* argv[]) {
+    const char* path = argc > 1 ? argv[1] : "zexdoc.com";
+    const long long ticks = argc > 2 ? atoll(argv[2]) : 2000000000LL;
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return 1;
+    }
+    std::vector<uint8_t> program((size_t)file.tellg());
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(program.data()), program.size());
+    struct Level {
+        const char* name;
+        double (*run)(const std::vector<uint8_t>&, long long);
+    };
+    const Level levels[] = {
+        {"Standard (full accuracy)", &measure<Z80::StandardConfig>},
+        {"No WZ", &measure<NoWZConfig>},
+        {"No Q", &measure<NoQConfig>},
+        {"No X/Y", &measure<NoXYConfig>},
+        {"No R", &measure<NoRConfig>},
+        {"No bus mirrors", &measure<NoBusConfig>},
+        {"Functional (all off)", &measure<Z80::FunctionalConfig>},
+    };
+    // Levels are interleaved over several rounds and the best round is kept, to even out host noise
+    const int rounds = argc > 3 ? atoi(argv[3]) : 3;
+    const int count = sizeof(levels) / sizeof(levels[0]);
+    std::vector<double> best(count, 0.0);
+    for (int round = 0; round < rounds; ++round)
+        for (int i = 0; i < count; ++i)
+            best[i] = std::max(best[i], levels[i].run(program, ticks));
+    printf("%-26s %14s %8s\n", "Profile", "Emulated MHz", "Gain");
+    for (int i = 0; i < count; ++i)
+        printf("%-26s %14.1f %7.1f%%\n", levels[i].name, best[i], (best[i] / best[0] - 1) * 100);
+    return 0;
+}
@@ -0,0 +1,79 @@
+// Emulated MHz with 1-64 concurrent periodic event sources: Z80::Scheduler against a TEvents that scans all
+// deadlines in get_event_limit(), the usual hand-written multiplexer.
+// Usage: Scheduler_bench [T-states per run]
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <Z80/CPU.h>
+#include <Z80/Scheduler.h>
+
+class ScanEvents {
+public:
+    template <typename TCPU> void connect(const TCPU* cpu) {
+    }
+    void reset() {
+    }
+    void add_periodic(long long period) {
+        m_periods.push_back(period);
+        m_deadlines.push_back(period);
+    }
+    long long get_event_limit() const {
+        long long limit = LLONG_MAX;
+        for (long long deadline : m_deadlines)
+            limit = deadline < limit ? deadline : limit;
+        return limit;
+    }
+    void handle_event(long long tick) {
+        for (size_t i = 0; i < m_deadlines.size(); ++i)
+            if (m_deadlines[i] <= tick) {
+                m_deadlines[i] += m_periods[i];
+                ++fired;
+            }
+    }
+    long long fired = 0;
+
+private:
+    std::vector<long long> m_periods, m_deadlines;
+};
+
+// Periods from a few tens to a few thousand T-states, as audio, line and timer sources have
+long long period_of(int source) {
+    return 79 + (source * 397) % 3000;
+}
+
+template <typename TEvents> void load(Z80::CPU<Z80::StandardBus, TEvents>& cpu) {
+    // LD HL,0x8000 / loop: ADD A,(HL) / INC HL / DJNZ loop / JP loop
+    const uint8_t program[] = {0x21, 0x00, 0x80, 0x86, 0x23, 0x10, 0xFC, 0xC3, 0x03, 0x01};
+    for (size_t i = 0; i < sizeof(program); ++i)
+        cpu.get_bus()->write(0x0100 + i, program[i]);
+    cpu.set_PC(0x0100);
+}
+
+template <typename TEvents> double measure(TEvents& events, long long ticks) {
+    Z80::CPU<Z80::StandardBus, TEvents> cpu(nullptr, &events);
+    load(cpu);
+    auto start = std::chrono::steady_clock::now();
+    cpu.run(ticks);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return cpu.get_ticks() / seconds / 1e6;
+}
+
+int main(int argc, char* argv[]) {
+    const long long ticks = argc > 1 ? atoll(argv[1]) : 200000000LL;
+    printf("%-8s %12s %14s %14s\n", "Sources", "Events", "Scheduler MHz", "Scan MHz");
+    for (int sources : {1, 2, 4, 8, 16, 32, 64}) {
+        long long fired = 0;
+        Z80::Scheduler scheduler;
+        ScanEvents scan;
+        for (int i = 0; i < sources; ++i) {
+            scheduler.add_periodic(period_of(i), [&fired](long long) { ++fired; });
+            scan.add_periodic(period_of(i));
+        }
+        double scheduler_mhz = measure(scheduler, ticks);
+        double scan_mhz = measure(scan, ticks);
+        printf("%-8d %12lld %14.1f %14.1f\n", sources, fired, scheduler_mhz, scan_mhz);
+    }
+    return 0;
+}
@@ -11,9 +11,13 @@ fi
 "$SCRIPT_DIR/build/tests/zex-tests" "$SCRIPT_DIR/zexdoc.com"
 "$SCRIPT_DIR/build/tests/zex-tests" "$SCRIPT_DIR/zexall.com"
 "$SCRIPT_DIR/build/tests/json-tests" "$SCRIPT_DIR/zexdoc.com"
+"$SCRIPT_DIR/build/tests/zex-tests-table" "$SCRIPT_DIR/zexall.com"
+"$SCRIPT_DIR/build/tests/json-tests-table"
 "$SCRIPT_DIR/build/tests/Assembler_test"
 "$SCRIPT_DIR/build/tests/Decoder_test"
 "$SCRIPT_DIR/build/tests/CPU_test"
+"$SCRIPT_DIR/build/tests/CPU_test_table"
+"$SCRIPT_DIR/build/tests/CPU_test_horizon"
 
 if [ "$1" = "--coverage" ]; then
     if command -v lcov >/dev/null 2>&1; then
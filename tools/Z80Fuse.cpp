@@ -0,0 +1,239 @@
+//  ▄▄▄▄▄▄▄▄    ▄▄▄▄      ▄▄▄▄
+//  ▀▀▀▀▀███  ▄██▀▀██▄   ██▀▀██
+//      ██▀   ██▄  ▄██  ██    ██
+//    ▄██▀     ██████   ██ ██ ██
+//   ▄██      ██▀  ▀██  ██    ██
+//  ███▄▄▄▄▄  ▀██▄▄██▀   ██▄▄██
+//  ▀▀▀▀▀▀▀▀    ▀▀▀▀      ▀▀▀▀   Fuse.cpp
+// Verson: 1.0.0
+//
+// This file contains a command-line utility that runs a Z80 program and
+// mines its execution trace for opcode fusion candidates: the pairs and
+// triples of adjacent instructions executed back to back most often.
+//
+// Copyright (c) 2025 Adam Szulc
+// MIT License
+
+#include <Z80/Decoder.h>
+#include <Z80/CPU.h>
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+inline void print_usage() {
+    std::cerr << "Usage: Z80Fuse <file_path> [options]\n"
+              << "File formats supported: .com (CP/M, BDOS calls return at once), .bin\n\n"
+              << "Options:\n"
+              << "  -ticks <count_dec>\n"
+              << "    Number of T-states to trace (default 200000000).\n"
+              << "  -top <count_dec>\n"
+              << "    Number of sequences listed per length (default 20).\n"
+              << "  -org <address>\n"
+              << "    Load and start address of a .bin file (hex/dec, default 0).\n"
+              << "    Example: Z80Fuse game.bin -org 0x8000 -ticks 50000000\n";
+}
+
+inline std::string get_file_extension(const std::string& filename) {
+    size_t dot_pos = filename.rfind('.');
+    if (dot_pos == std::string::npos)
+        return "";
+    std::string ext = filename.substr(dot_pos + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+    return ext;
+}
+
+inline std::vector<uint8_t> read_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return {};
+    std::streamsize size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    std::vector<uint8_t> buffer(size);
+    file.read(reinterpret_cast<char*>(buffer.data()), size);
+    return buffer;
+}
+
+inline uint16_t parse_address(const std::string& addr_str) {
+    std::string upper_str = addr_str;
+    std::transform(upper_str.begin(), upper_str.end(), upper_str.begin(), ::toupper);
+    if (upper_str.size() > 2 && upper_str.substr(0, 2) == "0X")
+        return std::stoul(upper_str.substr(2), nullptr, 16);
+    if (!upper_str.empty() && upper_str.back() == 'H')
+        return std::stoul(upper_str.substr(0, upper_str.length() - 1), nullptr, 16);
+    return std::stoul(addr_str, nullptr, 10);
+}
+
+using Decoder = Z80::Decoder<Z80::StandardBus>;
+
+// Instruction shape without its immediate values, so LD A,0x01 and LD A,0x02 count as one opcode
+inline std::string format_shape(const Decoder::CodeLine& line) {
+    std::stringstream ss;
+    ss << line.mnemonic;
+    for (size_t i = 0; i < line.operands.size(); ++i) {
+        const auto& op = line.operands[i];
+        ss << (i == 0 ? " " : ",");
+        switch (op.type) {
+            case Decoder::CodeLine::Operand::IMM8:
+                ss << "n";
+                break;
+            case Decoder::CodeLine::Operand::IMM16:
+                ss << (line.has_flag(Decoder::CodeLine::JUMP) || line.has_flag(Decoder::CodeLine::CALL) ? "addr" : "nn");
+                break;
+            case Decoder::CodeLine::Operand::MEM_IMM16:
+                ss << "(nn)";
+                break;
+            case Decoder::CodeLine::Operand::MEM_REG16:
+                ss << "(" << op.s_val << ")";
+                break;
+            case Decoder::CodeLine::Operand::MEM_INDEXED:
+                ss << "(" << op.base_reg << "+d)";
+                break;
+            case Decoder::CodeLine::Operand::PORT_IMM8:
+                ss << "(n)";
+                break;
+            default:
+                ss << op.s_val;
+                break;
+        }
+    }
+    return ss.str();
+}
+
+// Shapes are interned per address and re-decoded only when the bytes there change
+class ShapeCache {
+public:
+    explicit ShapeCache(Decoder& decoder) : m_decoder(decoder), m_entries(0x10000) {}
+    int get(uint16_t address, Z80::StandardBus& bus, int& length) {
+        Entry& entry = m_entries[address];
+        bool valid = entry.shape >= 0;
+        for (size_t i = 0; valid && i < entry.bytes.size(); ++i)
+            valid = bus.peek(address + i) == entry.bytes[i];
+        if (!valid) {
+            Decoder::CodeLine line = m_decoder.parse_instruction(address);
+            entry.bytes = line.bytes;
+            std::string shape = format_shape(line);
+            auto it = m_ids.find(shape);
+            if (it == m_ids.end()) {
+                it = m_ids.emplace(shape, (int)m_shapes.size()).first;
+                m_shapes.push_back(shape);
+            }
+            entry.shape = it->second;
+        }
+        length = std::max<int>(1, (int)entry.bytes.size());
+        return entry.shape;
+    }
+    const std::string& name(int shape) const { return m_shapes[shape]; }
+
+private:
+    struct Entry {
+        int shape = -1;
+        std::vector<uint8_t> bytes;
+    };
+    Decoder& m_decoder;
+    std::vector<Entry> m_entries;
+    std::map<std::string, int> m_ids;
+    std::vector<std::string> m_shapes;
+};
+
+inline void print_top(const std::map<std::vector<int>, long long>& counts, long long instructions, size_t top,
+                      const ShapeCache& shapes, const char* title) {
+    std::vector<std::pair<long long, std::vector<int>>> sorted;
+    for (const auto& entry : counts)
+        sorted.emplace_back(entry.second, entry.first);
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+    std::cout << "--- " << title << " ---\n";
+    std::cout << std::left << std::setw(6) << "Rank" << std::setw(14) << "Count" << std::setw(9) << "Share"
+              << "Sequence\n";
+    for (size_t i = 0; i < sorted.size() && i < top; ++i) {
+        std::string sequence;
+        for (int shape : sorted[i].second)
+            sequence += (sequence.empty() ? "" : " / ") + shapes.name(shape);
+        std::stringstream share;
+        share << std::fixed << std::setprecision(2) << 100.0 * sorted[i].first / instructions << "%";
+        std::cout << std::left << std::setw(6) << i + 1 << std::setw(14) << sorted[i].first << std::setw(9)
+                  << share.str() << sequence << "\n";
+    }
+}
+
+inline int run_z80fuse(int argc, char* argv[]) {
+    if (argc < 2) {
+        print_usage();
+        return 1;
+    }
+    std::string file_path = argv[1];
+    long long ticks_limit = 200000000LL;
+    size_t top = 20;
+    uint16_t org = 0;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-ticks" && i + 1 < argc)
+            ticks_limit = std::stoll(argv[++i]);
+        else if (arg == "-top" && i + 1 < argc)
+            top = std::stoul(argv[++i]);
+        else if (arg == "-org" && i + 1 < argc)
+            org = parse_address(argv[++i]);
+        else {
+            std::cerr << "Error: Unknown or incomplete argument '" << arg << "'." << std::endl;
+            print_usage();
+            return 1;
+        }
+    }
+    std::vector<uint8_t> data = read_file(file_path);
+    if (data.empty()) {
+        std::cerr << "Error: Could not read file or file is empty '" << file_path << "'." << std::endl;
+        return 1;
+    }
+    Z80::CPU<> cpu;
+    Z80::StandardBus& bus = *cpu.get_bus();
+    std::string ext = get_file_extension(file_path);
+    if (ext == "com") {
+        org = 0x0100;
+        bus.write(0x0000, 0x76); // Warm boot: HALT
+        bus.write(0x0005, 0xC9); // BDOS: RET
+        cpu.set_SP(0xF000);
+    } else if (ext != "bin" && !ext.empty()) {
+        std::cerr << "Error: Unsupported file extension '" << ext << "'." << std::endl;
+        return 1;
+    }
+    for (size_t i = 0; i < data.size() && org + i <= 0xFFFF; ++i)
+        bus.write(org + i, data[i]);
+    cpu.set_PC(org);
+    Decoder decoder(&bus);
+    ShapeCache shapes(decoder);
+    std::map<std::vector<int>, long long> pairs, triples;
+    long long instructions = 0;
+    // Shapes of the last two instructions; -1 once control flow broke the adjacency
+    int previous[2] = {-1, -1};
+    while (cpu.get_ticks() < ticks_limit && !cpu.is_halted()) {
+        uint16_t pc = cpu.get_PC();
+        int length;
+        int shape = shapes.get(pc, bus, length);
+        cpu.step();
+        ++instructions;
+        if (previous[1] >= 0) {
+            ++pairs[{previous[1], shape}];
+            if (previous[0] >= 0)
+                ++triples[{previous[0], previous[1], shape}];
+        }
+        bool adjacent = cpu.get_PC() == (uint16_t)(pc + length);
+        previous[0] = adjacent ? previous[1] : -1;
+        previous[1] = adjacent ? shape : -1;
+    }
+    std::cout << "Traced " << instructions << " instructions in " << cpu.get_ticks() << " T-states.\n";
+    std::cout << "A sequence counts only when each instruction falls through to the next (adjacent in memory).\n";
+    print_top(pairs, instructions, top, shapes, "Pairs");
+    print_top(triples, instructions, top, shapes, "Triples");
+    return 0;
+}
+
+#ifndef Z80FUSE_TEST_BUILD
+int main(int argc, char* argv[]) {
+    return run_z80fuse(argc, argv);
+}
+#endif // Z80FUSE_TEST_BUILD
@@ -1,7 +1,7 @@
 #!/bin/sh
 set -e
 
-# This script builds the command-line tools (Z80Dump, Z80Asm).
+# This script builds the command-line tools (Z80Dump, Z80Asm, Z80Fuse).
 
 SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
 PROJECT_ROOT="$SCRIPT_DIR/.."